@@ -0,0 +1,145 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_BENCHMARK_ASSEMBLY_H
+#define PAPILLON_BENCHMARK_ASSEMBLY_H
+
+#include <Papillon/geometry/csg/difference.hpp>
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/rect_lattice.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <Papillon/geometry/surfaces/zplane.hpp>
+#include <Papillon/materials/material.hpp>
+#include <Papillon/transport/transport.hpp>
+#include <Papillon/utils/rng.hpp>
+
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace pmc {
+namespace bench {
+
+// 17x17 assembly of pin cells, reflected on its sides and with vacuum on
+// its ends, shared by the transport benchmarks
+
+const double pin_pitch = 1.26;
+const double half_width = 8.5 * pin_pitch;
+const double half_height = 50.;
+
+// Nuclide with constant scattering, and 1/v capture and fission
+inline std::shared_ptr<Nuclide> make_nuclide(const std::string& name,
+                                             double awr, double elastic,
+                                             double capture, double fission) {
+  std::vector<double> energy, el, cap, fis;
+  for (int i = 0; i <= 1200; i++) {
+    double E = 1.E-11 * std::pow(10., 0.01 * i);
+    double v = std::sqrt(2.53E-8 / E);
+    energy.push_back(E);
+    el.push_back(elastic);
+    cap.push_back(capture * v);
+    fis.push_back(fission * v);
+  }
+  return std::make_shared<Nuclide>(name, awr, energy, el, cap, fis, 2.4);
+}
+
+inline std::unique_ptr<Geometry> make_assembly() {
+  const auto T = Surface::BoundaryType::Transparent;
+  const auto R = Surface::BoundaryType::Reflective;
+  const auto V = Surface::BoundaryType::Vacuum;
+  const auto N = Surface::Side::Negative;
+  const auto P = Surface::Side::Positive;
+  std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+  surfaces[1] = std::make_shared<ZCylinder>(0., 0., 0.4096, T, 1);
+  surfaces[2] = std::make_shared<ZCylinder>(0., 0., 0.475, T, 2);
+  surfaces[3] = std::make_shared<XPlane>(-half_width, R, 3);
+  surfaces[4] = std::make_shared<XPlane>(half_width, R, 4);
+  surfaces[5] = std::make_shared<YPlane>(-half_width, R, 5);
+  surfaces[6] = std::make_shared<YPlane>(half_width, R, 6);
+  surfaces[7] = std::make_shared<ZPlane>(-half_height, V, 7);
+  surfaces[8] = std::make_shared<ZPlane>(half_height, V, 8);
+
+  auto fuel = std::make_shared<HalfSpace>(surfaces[1], N, 1);
+  auto clad = std::make_shared<Difference>(
+      std::make_shared<HalfSpace>(surfaces[2], N, 2), fuel, 3);
+  auto box = std::make_shared<Intersection>(
+      std::make_shared<Intersection>(
+          std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[3], P, 4),
+                                         std::make_shared<HalfSpace>(surfaces[4], N, 5), 6),
+          std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[5], P, 7),
+                                         std::make_shared<HalfSpace>(surfaces[6], N, 8), 9), 10),
+      std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[7], P, 11),
+                                     std::make_shared<HalfSpace>(surfaces[8], N, 12), 13), 14);
+
+  auto o16 = make_nuclide("O16", 15.86, 3.8, 0., 0.);
+  auto uo2 = std::make_shared<Material>(1, "fuel");
+  uo2->add_nuclide(make_nuclide("U235", 233., 10., 1., 6.), 0.0007);
+  uo2->add_nuclide(make_nuclide("U238", 236., 9., 0.3, 0.), 0.022);
+  uo2->add_nuclide(o16, 0.045);
+  auto zr = std::make_shared<Material>(2, "clad");
+  zr->add_nuclide(make_nuclide("Zr90", 89.1, 6.5, 0.01, 0.), 0.043);
+  auto water = std::make_shared<Material>(3, "water");
+  water->add_nuclide(make_nuclide("H1", 0.999, 20., 0.33, 0.), 0.067);
+  water->add_nuclide(o16, 0.033);
+
+  auto pin = std::make_shared<GeoNode>(box, "moderator");
+  pin->set_material(water);
+  pin->add_node(fuel, Transformation(), "fuel")->set_material(uo2);
+  pin->add_node(clad, Transformation(), "clad")->set_material(zr);
+  auto root = std::make_unique<RectLattice>(
+      box, 17, 17, 1, pin_pitch, pin_pitch, INF,
+      Position(-half_width, -half_width, 0.), "assembly");
+  root->fill(pin);
+  return std::make_unique<Geometry>(surfaces, std::move(root));
+}
+
+// Isotropic 2 MeV neutrons, uniform in the assembly
+inline std::vector<SourceSite> make_assembly_sites(std::size_t n) {
+  RNG rng(12345);
+  std::vector<SourceSite> sites;
+  for (std::size_t i = 0; i < n; i++) {
+    Position r(half_width * (2. * rng() - 1.), half_width * (2. * rng() - 1.),
+               half_height * (2. * rng() - 1.));
+    sites.push_back({r, Direction(2. * rng() - 1., 2. * PI * rng()), 2., 1.});
+  }
+  return sites;
+}
+
+}  // namespace bench
+}  // namespace pmc
+
+#endif
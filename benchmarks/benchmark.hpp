@@ -0,0 +1,64 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_BENCHMARK_H
+#define PAPILLON_BENCHMARK_H
+
+#include <chrono>
+#include <cstdio>
+
+namespace pmc {
+namespace bench {
+
+// Returns the average wall time in nanoseconds of one call to f, measured
+// over nrep calls, after one untimed warm-up call.
+template <class F>
+double time_ns(F&& f, std::size_t nrep) {
+  f();
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < nrep; i++) f();
+  auto stop = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> elapsed = stop - start;
+  return elapsed.count() / static_cast<double>(nrep);
+}
+
+// Prevents the compiler from optimizing away a computed value.
+template <class T>
+void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace bench
+}  // namespace pmc
+
+#endif
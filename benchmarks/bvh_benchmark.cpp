@@ -0,0 +1,163 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Compares the linear search over the children of a GeoNode against the BVH
+// search, for point location and for the nearest child boundary, as the
+// number of children grows. The children are spheres on a cubic lattice.
+
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/geo_node.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/surface_table.hpp>
+
+#include "benchmark.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace pmc;
+
+namespace {
+
+std::unique_ptr<GeoNode> make_node(std::size_t nchildren, bool use_bvh,
+                                   const SurfaceTable& table,
+                                   std::shared_ptr<Volume> world,
+                                   std::shared_ptr<Volume> pin) {
+  auto node = std::make_unique<GeoNode>(world, "world");
+  node->set_use_bvh(use_bvh);
+
+  std::size_t side =
+      static_cast<std::size_t>(std::ceil(std::cbrt(static_cast<double>(nchildren))));
+  for (std::size_t n = 0; n < nchildren; n++) {
+    double x = static_cast<double>(n % side);
+    double y = static_cast<double>((n / side) % side);
+    double z = static_cast<double>(n / (side * side));
+    node->add_node(pin, Transformation::translation(x, y, z), "pin");
+  }
+
+  node->finalize(table);
+  return node;
+}
+
+}  // namespace
+
+int main() {
+  const std::size_t nquery = 256;
+  const auto T = Surface::BoundaryType::Transparent;
+
+  std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs;
+  surfs[1] = std::make_shared<Sphere>(0., 0., 0., 0.4, T, 1);
+  surfs[2] = std::make_shared<Sphere>(0., 0., 0., 1.E4, T, 2);
+  SurfaceTable table(surfs);
+  auto pin = std::make_shared<HalfSpace>(surfs[1], Surface::Side::Negative, 1);
+  auto world = std::make_shared<HalfSpace>(surfs[2], Surface::Side::Negative, 2);
+
+  std::printf(" %9s %13s %13s %9s %13s %13s %9s %10s\n", "children",
+              "find [ns]", "find bvh", "speedup", "dist [ns]", "dist bvh",
+              "speedup", "build [ms]");
+  for (std::size_t nchildren : {10, 100, 1000, 10000, 100000}) {
+    auto linear = make_node(nchildren, false, table, world, pin);
+    auto start = std::chrono::steady_clock::now();
+    auto bvh = make_node(nchildren, true, table, world, pin);
+    std::chrono::duration<double, std::milli> t_build =
+        std::chrono::steady_clock::now() - start;
+
+    // Queries are spread over the lattice of children
+    double side = std::ceil(std::cbrt(static_cast<double>(nchildren)));
+    std::mt19937_64 gen(12345);
+    std::uniform_real_distribution<double> pos(-0.5, side - 0.5);
+    std::uniform_real_distribution<double> mu_dist(-1., 1.);
+    std::uniform_real_distribution<double> phi_dist(0., 2. * PI);
+    std::vector<Position> r(nquery);
+    std::vector<Direction> u(nquery);
+    for (std::size_t i = 0; i < nquery; i++) {
+      r[i] = Position(pos(gen), pos(gen), pos(gen));
+      u[i] = Direction(mu_dist(gen), phi_dist(gen));
+    }
+
+    std::size_t nrep = std::max<std::size_t>(1, 100000 / nchildren);
+    auto time_find = [&](const GeoNode& node) {
+      return bench::time_ns(
+                 [&]() {
+                   for (std::size_t i = 0; i < nquery; i++) {
+                     bench::do_not_optimize(node.find_child_node(
+                         r[i], u[i], 0, Surface::Side::Positive));
+                   }
+                 },
+                 nrep) /
+             nquery;
+    };
+    auto time_dist = [&](const GeoNode& node) {
+      return bench::time_ns(
+                 [&]() {
+                   for (std::size_t i = 0; i < nquery; i++) {
+                     bench::do_not_optimize(
+                         node.distance_to_child_boundary(r[i], u[i]).distance);
+                   }
+                 },
+                 nrep) /
+             nquery;
+    };
+
+    // Make sure both searches agree before reporting anything
+    std::size_t nbad = 0;
+    for (std::size_t i = 0; i < nquery; i++) {
+      if (linear->distance_to_child_boundary(r[i], u[i]).distance !=
+          bvh->distance_to_child_boundary(r[i], u[i]).distance)
+        nbad++;
+      if ((linear->find_child_node(r[i], u[i], 0, Surface::Side::Positive) ==
+           nullptr) !=
+          (bvh->find_child_node(r[i], u[i], 0, Surface::Side::Positive) ==
+           nullptr))
+        nbad++;
+    }
+
+    double f_lin = time_find(*linear);
+    double f_bvh = time_find(*bvh);
+    double d_lin = time_dist(*linear);
+    double d_bvh = time_dist(*bvh);
+    std::printf(" %9zu %13.1f %13.1f %9.2f %13.1f %13.1f %9.2f %10.2f",
+                nchildren, f_lin, f_bvh, f_lin / f_bvh, d_lin, d_bvh,
+                d_lin / d_bvh, t_build.count());
+    if (nbad > 0) std::printf("   (%zu mismatches)", nbad);
+    std::printf("\n");
+  }
+
+  return 0;
+}
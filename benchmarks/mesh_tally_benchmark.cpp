@@ -0,0 +1,160 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Cost of walking flights through a regular mesh with the DDA of MeshTally,
+// against testing every cell of the mesh for its chord with the flight.
+// Both must give the same total chord length. The DDA should cost about
+// the same per cell crossed whatever the size of the mesh, where the test
+// of every cell grows with the number of cells.
+
+#include <Papillon/tallies/mesh_tally.hpp>
+#include <Papillon/utils/rng.hpp>
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace pmc;
+
+struct Segment {
+  Position r;
+  Direction u;
+  double distance;
+};
+
+// Chord of the segment with the box [lo, hi], from slabs
+static double chord(const Segment& s, const double lo[3], const double hi[3]) {
+  double t_in = 0.;
+  double t_out = s.distance;
+  for (int a = 0; a < 3; a++) {
+    if (s.u[a] == 0.) {
+      if (s.r[a] < lo[a] || s.r[a] >= hi[a]) return 0.;
+      continue;
+    }
+    double t0 = (lo[a] - s.r[a]) / s.u[a];
+    double t1 = (hi[a] - s.r[a]) / s.u[a];
+    if (t0 > t1) std::swap(t0, t1);
+    t_in = std::max(t_in, t0);
+    t_out = std::min(t_out, t1);
+  }
+  return t_out > t_in ? t_out - t_in : 0.;
+}
+
+static double brute_force(const Segment& s, uint32_t n) {
+  const double w = 10. / n;
+  double total = 0.;
+  for (uint32_t k = 0; k < n; k++) {
+    for (uint32_t j = 0; j < n; j++) {
+      for (uint32_t i = 0; i < n; i++) {
+        double lo[3] = {i * w, j * w, k * w};
+        double hi[3] = {lo[0] + w, lo[1] + w, lo[2] + w};
+        total += chord(s, lo, hi);
+      }
+    }
+  }
+  return total;
+}
+
+int main() {
+  // Flights of 5 cm on average, in a 10 cm box
+  RNG rng(3);
+  std::vector<Segment> segments;
+  for (int i = 0; i < 2000; i++) {
+    Position r(10. * rng(), 10. * rng(), 10. * rng());
+    segments.push_back({r, Direction(2. * rng() - 1., 2. * PI * rng()),
+                        10. * rng()});
+  }
+
+  std::printf(" %8s %12s %16s %16s %16s\n", "mesh", "cells/flight",
+              "dda [ns/flight]", "dda [ns/cell]", "all [ns/flight]");
+  for (uint32_t n : {10u, 25u, 50u, 100u, 200u}) {
+    MeshTally mesh("mesh", Position(0., 0., 0.), Position(10., 10., 10.), n, n,
+                   n, {TallyScore::Flux});
+
+    size_t ncells = 0;
+    double walked = 0.;
+    for (const auto& s : segments) {
+      mesh.walk(s.r, s.u, s.distance, [&](size_t, double length) {
+        ncells++;
+        walked += length;
+      });
+    }
+
+    double t_dda = bench::time_ns(
+        [&]() {
+          double sum = 0.;
+          for (const auto& s : segments)
+            mesh.walk(s.r, s.u, s.distance,
+                      [&](size_t cell, double length) { sum += cell * length; });
+          bench::do_not_optimize(sum);
+        },
+        20);
+    const double nflights = static_cast<double>(segments.size());
+
+    // Every cell is only tested on the smaller meshes, on fewer flights
+    char all[32] = "-";
+    if (n <= 50) {
+      const size_t nbrute = 20;
+      double expected = 0.;
+      double found = 0.;
+      for (size_t i = 0; i < nbrute; i++) {
+        const Segment& s = segments[i];
+        found += brute_force(s, n);
+        mesh.walk(s.r, s.u, s.distance,
+                  [&](size_t, double length) { expected += length; });
+      }
+      if (std::abs(found - expected) > 1.E-9 * expected) {
+        std::printf(" The DDA and the test of every cell differ on %u^3.\n", n);
+        return EXIT_FAILURE;
+      }
+      double t_all = bench::time_ns(
+          [&]() {
+            for (size_t i = 0; i < nbrute; i++)
+              bench::do_not_optimize(brute_force(segments[i], n));
+          },
+          1);
+      std::snprintf(all, sizeof(all), "%.0f", t_all / nbrute);
+    }
+
+    std::printf(" %6u^3 %12.1f %16.1f %16.2f %16s\n", n, ncells / nflights,
+                t_dda / nflights, t_dda / static_cast<double>(ncells), all);
+    bench::do_not_optimize(walked);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Resampling of a fission bank of 2M sites to 1M, as done between the
+// batches of power iteration. A serial loop over the running sum of the
+// weights is compared with resample_sites, whose prefix sum and copies run
+// in parallel, on 1, 2, 4, ... threads. Both must give the same sites.
+
+#include "benchmark.hpp"
+
+#include <Papillon/transport/eigenvalue.hpp>
+#include <Papillon/utils/rng.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace pmc;
+
+// Systematic resampling by one pass over the sites
+void serial_resample(const std::vector<SourceSite>& sites, std::size_t n,
+                     double xi, std::vector<SourceSite>& out) {
+  double total = 0.;
+  for (const auto& site : sites) total += site.weight;
+  out.resize(n);
+  double w = 0.;
+  std::size_t j = 0;
+  for (std::size_t i = 0; i < sites.size(); i++) {
+    w += sites[i].weight;
+    std::size_t end = i + 1 == sites.size()
+                          ? n
+                          : std::min(n, static_cast<std::size_t>(
+                                            std::floor(w * n / total + xi)));
+    for (; j < end; j++) {
+      out[j] = sites[i];
+      out[j].weight = 1.;
+    }
+  }
+}
+
+int main() {
+  const std::size_t m = 2000000, n = 1000000;
+  RNG rng(3);
+  std::vector<SourceSite> sites(m);
+  for (std::size_t i = 0; i < m; i++)
+    sites[i] = {Position(rng(), rng(), rng()), Direction(1., 0., 0.),
+                static_cast<double>(i), 0.5 + rng()};
+
+  std::vector<SourceSite> serial, parallel;
+  serial_resample(sites, n, 0.4, serial);
+  resample_sites(sites, n, 0.4, parallel, 1);
+  // Sums taken in another order may move a site by one place
+  std::size_t moved = 0;
+  for (std::size_t j = 0; j < n; j++)
+    if (serial[j].energy != parallel[j].energy) moved++;
+  if (moved > n / 1000) {
+    std::printf(" The serial and parallel resampling differ at %zu sites.\n",
+                moved);
+    return EXIT_FAILURE;
+  }
+
+  const double t_serial = bench::time_ns(
+      [&]() {
+        serial_resample(sites, n, 0.4, serial);
+        bench::do_not_optimize(serial.data());
+      },
+      5);
+  std::printf(" %zu sites resampled to %zu\n\n", m, n);
+  std::printf(" %8s %14s %10s\n", "threads", "time [ms]", "speedup");
+  std::printf(" %8s %14.2f %10.2f\n", "serial", t_serial / 1.E6, 1.);
+
+  const int ncores = static_cast<int>(
+      std::max(1u, std::min(64u, std::thread::hardware_concurrency())));
+  std::vector<int> thread_counts;
+  for (int t = 1; t < ncores; t *= 2) thread_counts.push_back(t);
+  thread_counts.push_back(ncores);
+
+  std::vector<SourceSite> reference = parallel;
+  for (int t : thread_counts) {
+    resample_sites(sites, n, 0.4, parallel, t);
+    for (std::size_t j = 0; j < n; j++) {
+      if (parallel[j].energy != reference[j].energy) {
+        std::printf(" Resampling on %d threads differs from one thread.\n", t);
+        return EXIT_FAILURE;
+      }
+    }
+
+    double time = bench::time_ns(
+        [&]() {
+          resample_sites(sites, n, 0.4, parallel, t);
+          bench::do_not_optimize(parallel.data());
+        },
+        5);
+    std::printf(" %8d %14.2f %10.2f\n", t, time / 1.E6, t_serial / time);
+  }
+
+  return EXIT_SUCCESS;
+}
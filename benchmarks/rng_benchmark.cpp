@@ -0,0 +1,107 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Cost of the counter-based generator, drawing one number at a time and
+// filling blocks of numbers at once, and of starting the events of a bank of
+// histories one at a time and all together. The batched paths must give the
+// same numbers as the scalar ones.
+
+#include <Papillon/utils/rng.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace pmc;
+
+int main() {
+  // One stream
+  const std::size_t n = 1 << 16;
+  std::vector<double> scalar(n), filled(n);
+  RNG a(42, 0, 7), b(42, 0, 7);
+  for (auto& x : scalar) x = a();
+  b.fill(filled.data(), n);
+  if (scalar != filled) {
+    std::printf(" Filled numbers differ from drawn ones.\n");
+    return EXIT_FAILURE;
+  }
+
+  std::printf(" %-22s %14s\n", "one stream", "[ns / number]");
+  double t_draw = bench::time_ns([&]() {
+    for (auto& x : scalar) x = a();
+    bench::do_not_optimize(scalar.data());
+  }, 200) / n;
+  double t_fill = bench::time_ns([&]() {
+    b.fill(filled.data(), n);
+    bench::do_not_optimize(filled.data());
+  }, 200) / n;
+  std::printf(" %-22s %14.2f\n", "draw", t_draw);
+  std::printf(" %-22s %14.2f\n", "fill", t_fill);
+
+  // Bank of histories
+  const std::size_t nhistories = 10000;
+  std::vector<RNG> one, all;
+  std::vector<uint32_t> indices;
+  for (uint32_t h = 0; h < nhistories; h++) {
+    one.emplace_back(42, 0, h);
+    all.emplace_back(42, 0, h);
+    indices.push_back(h);
+  }
+  for (auto& rng : one) rng.next_event();
+  RNG::next_event(all.data(), indices.data(), nhistories);
+  for (std::size_t h = 0; h < nhistories; h++) {
+    if (one[h]() != all[h]()) {
+      std::printf(" Batched events differ from single ones.\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::printf("\n %-22s %14s\n", "bank of histories", "[ns / event]");
+  double t_one = bench::time_ns([&]() {
+    for (auto& rng : one) {
+      rng.next_event();
+      bench::do_not_optimize(rng());
+    }
+  }, 200) / nhistories;
+  double t_all = bench::time_ns([&]() {
+    RNG::next_event(all.data(), indices.data(), nhistories);
+    for (auto& rng : all) bench::do_not_optimize(rng());
+  }, 200) / nhistories;
+  std::printf(" %-22s %14.2f\n", "one at a time", t_one);
+  std::printf(" %-22s %14.2f\n", "batched", t_all);
+
+  return EXIT_SUCCESS;
+}
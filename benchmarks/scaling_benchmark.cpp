@@ -0,0 +1,102 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Strong scaling of history-based transport through the 17x17 assembly of
+// the transport benchmark: a fixed batch of histories, with fission sites
+// banked, is run on 1, 2, 4, ... threads, up to the number of cores or 64.
+// A different largest thread count may be given as the only argument. Every
+// thread count must give the same results and the same fission bank as one
+// thread. The speedup and parallel efficiency are relative to one thread.
+
+#include "assembly.hpp"
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace pmc;
+using namespace pmc::bench;
+
+int main(int argc, char** argv) {
+  auto geom = make_assembly();
+  const std::size_t nhistories = 20000;
+  std::vector<SourceSite> sites = make_assembly_sites(nhistories);
+
+  TransportSettings settings;
+  settings.seed = 7;
+  settings.fission_neutrons = FissionNeutrons::Bank;
+  settings.threads = 1;
+  std::vector<SourceSite> reference_bank;
+  TransportResult reference = transport(*geom, sites, settings, reference_bank);
+
+  const unsigned ncores = std::max(1u, std::thread::hardware_concurrency());
+  int max_threads = static_cast<int>(std::min(64u, ncores));
+  if (argc > 1) max_threads = std::max(1, std::atoi(argv[1]));
+  std::vector<int> thread_counts;
+  for (int t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+  thread_counts.push_back(max_threads);
+
+  std::printf(" %zu histories, %zu fission sites, %u cores\n\n", nhistories,
+              reference_bank.size(), ncores);
+  std::printf(" %8s %14s %10s %12s\n", "threads", "batch [ms]", "speedup",
+              "efficiency");
+
+  double t_one = 0.;
+  std::vector<SourceSite> bank;
+  for (int nthreads : thread_counts) {
+    settings.threads = nthreads;
+    TransportResult result = transport(*geom, sites, settings, bank);
+    bool same_bank = bank.size() == reference_bank.size();
+    for (std::size_t i = 0; same_bank && i < bank.size(); i++)
+      same_bank = bank[i].energy == reference_bank[i].energy;
+    if (result.collisions != reference.collisions ||
+        result.track_length != reference.track_length || !same_bank) {
+      std::printf(" Results on %d threads differ from one thread.\n",
+                  nthreads);
+      return EXIT_FAILURE;
+    }
+
+    double t = bench::time_ns(
+        [&]() { bench::do_not_optimize(transport(*geom, sites, settings, bank)); },
+        3);
+    if (nthreads == 1) t_one = t;
+    std::printf(" %8d %14.1f %10.2f %12.2f\n", nthreads, t / 1.E6, t_one / t,
+                t_one / t / nthreads);
+  }
+
+  return EXIT_SUCCESS;
+}
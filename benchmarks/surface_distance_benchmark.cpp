@@ -0,0 +1,139 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Compares the scalar Surface::distance path, with one virtual call per
+// particle, against Surface::distance_batch, with one virtual call per batch.
+
+#include <Papillon/geometry/surfaces/plane.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/xcylinder.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/ycylinder.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <Papillon/geometry/surfaces/zplane.hpp>
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace pmc;
+
+namespace {
+
+struct ParticleArrays {
+  std::vector<double> x, y, z, u, v, w;
+
+  ParticleArrays(std::size_t n, std::mt19937_64& gen)
+      : x(n), y(n), z(n), u(n), v(n), w(n) {
+    std::uniform_real_distribution<double> pos(-5., 5.);
+    std::uniform_real_distribution<double> mu_dist(-1., 1.);
+    std::uniform_real_distribution<double> phi_dist(0., 2. * PI);
+    for (std::size_t i = 0; i < n; i++) {
+      x[i] = pos(gen);
+      y[i] = pos(gen);
+      z[i] = pos(gen);
+      Direction dir(mu_dist(gen), phi_dist(gen));
+      u[i] = dir.x();
+      v[i] = dir.y();
+      w[i] = dir.z();
+    }
+  }
+};
+
+}  // namespace
+
+int main() {
+  const std::size_t n = 4096;
+  const std::size_t nrep = 2000;
+  std::mt19937_64 gen(12345);
+  ParticleArrays p(n, gen);
+  std::vector<double> d_scalar(n), d_batch(n);
+
+  const auto T = Surface::BoundaryType::Transparent;
+  std::vector<std::pair<std::string, std::shared_ptr<Surface>>> surfaces{
+      {"XPlane", std::make_shared<XPlane>(1., T, 1)},
+      {"YPlane", std::make_shared<YPlane>(1., T, 2)},
+      {"ZPlane", std::make_shared<ZPlane>(1., T, 3)},
+      {"Plane", std::make_shared<Plane>(1., 1., 1., 1., T, 4)},
+      {"XCylinder", std::make_shared<XCylinder>(0.5, 0.5, 2., T, 5)},
+      {"YCylinder", std::make_shared<YCylinder>(0.5, 0.5, 2., T, 6)},
+      {"ZCylinder", std::make_shared<ZCylinder>(0.5, 0.5, 2., T, 7)},
+      {"Sphere", std::make_shared<Sphere>(0.5, 0.5, 0.5, 3., T, 8)}};
+
+  std::printf(" %-10s %14s %14s %9s\n", "Surface", "scalar [ns/p]",
+              "batch [ns/p]", "speedup");
+  for (const auto& entry : surfaces) {
+    const Surface* surf = entry.second.get();
+
+    double t_scalar = bench::time_ns(
+        [&]() {
+          for (std::size_t i = 0; i < n; i++) {
+            d_scalar[i] = surf->distance({p.x[i], p.y[i], p.z[i]},
+                                         {p.u[i], p.v[i], p.w[i]});
+          }
+          bench::do_not_optimize(d_scalar.data());
+        },
+        nrep);
+
+    double t_batch = bench::time_ns(
+        [&]() {
+          surf->distance_batch(p.x.data(), p.y.data(), p.z.data(), p.u.data(),
+                               p.v.data(), p.w.data(), d_batch.data(), n);
+          bench::do_not_optimize(d_batch.data());
+        },
+        nrep);
+
+    // Make sure both paths agree before reporting anything
+    std::size_t nbad = 0;
+    for (std::size_t i = 0; i < n; i++) {
+      double tol = 1.E-12 * std::max(1., std::fabs(d_scalar[i]));
+      if (std::fabs(d_scalar[i] - d_batch[i]) > tol) nbad++;
+    }
+
+    std::printf(" %-10s %14.3f %14.3f %9.2f", entry.first.c_str(),
+                t_scalar / n, t_batch / n, t_scalar / t_batch);
+    if (nbad > 0) std::printf("   (%zu mismatches)", nbad);
+    std::printf("\n");
+  }
+
+  return 0;
+}
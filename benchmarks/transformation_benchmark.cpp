@@ -0,0 +1,223 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Cost of applying transformations, with and without their kind tags. Every
+// transformation is applied once as built, so that translations and rotations
+// take their fast paths, and once after being forced to the General kind,
+// which always does the full 3x4 multiplication. The same comparison is then
+// made on a reflected 17x17 RectLattice of pin-cell universes, by timing the
+// steps of random walks through it.
+
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/geo_navigator.hpp>
+#include <Papillon/geometry/rect_lattice.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+
+#include "benchmark.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace pmc;
+
+namespace {
+
+const double pin_pitch = 1.26;
+
+using SurfaceMap = std::unordered_map<uint32_t, std::shared_ptr<Surface>>;
+
+// Same matrix, without the fast paths of its kind
+Transformation general(Transformation t) {
+  t.set(0, 0, t[0][0]);
+  return t;
+}
+
+std::shared_ptr<Volume> box(SurfaceMap& surfs, double half_width, uint32_t id,
+                            Surface::BoundaryType bound) {
+  surfs[id] = std::make_shared<XPlane>(-half_width, bound, id);
+  surfs[id + 1] = std::make_shared<XPlane>(half_width, bound, id + 1);
+  surfs[id + 2] = std::make_shared<YPlane>(-half_width, bound, id + 2);
+  surfs[id + 3] = std::make_shared<YPlane>(half_width, bound, id + 3);
+  auto px = std::make_shared<HalfSpace>(surfs[id], Surface::Side::Positive, id);
+  auto nx = std::make_shared<HalfSpace>(surfs[id + 1], Surface::Side::Negative, id + 1);
+  auto py = std::make_shared<HalfSpace>(surfs[id + 2], Surface::Side::Positive, id + 2);
+  auto ny = std::make_shared<HalfSpace>(surfs[id + 3], Surface::Side::Negative, id + 3);
+  auto x = std::make_shared<Intersection>(px, nx, id + 4);
+  auto y = std::make_shared<Intersection>(py, ny, id + 5);
+  return std::make_shared<Intersection>(x, y, id + 6);
+}
+
+// 17x17 lattice of pin cells with reflected outer walls. When tagged is
+// false, every transformation in the tree is forced to the General kind.
+std::unique_ptr<GeoNode> make_assembly(SurfaceMap& surfs, bool tagged) {
+  const auto T = Surface::BoundaryType::Transparent;
+  auto kind = [tagged](Transformation t) { return tagged ? t : general(t); };
+
+  surfs[1] = std::make_shared<ZCylinder>(0., 0., 0.4096, T, 1);
+  surfs[2] = std::make_shared<ZCylinder>(0., 0., 0.475, T, 2);
+  auto fuel = std::make_shared<HalfSpace>(surfs[1], Surface::Side::Negative, 1);
+  auto clad = std::make_shared<Intersection>(
+      std::make_shared<HalfSpace>(surfs[1], Surface::Side::Positive, 2),
+      std::make_shared<HalfSpace>(surfs[2], Surface::Side::Negative, 3), 4);
+  auto pin_cell = box(surfs, 0.5 * pin_pitch, 10, T);
+  auto assembly_cell = box(surfs, 8.5 * pin_pitch, 20,
+                           Surface::BoundaryType::Reflective);
+
+  auto pin = std::make_shared<GeoNode>(pin_cell, kind(Transformation()),
+                                       "moderator");
+  pin->add_node(fuel, kind(Transformation()), "fuel");
+  pin->add_node(clad, kind(Transformation()), "clad");
+
+  double a = 8.5 * pin_pitch;
+  auto assembly = std::make_unique<RectLattice>(
+      assembly_cell, 17, 17, 1, pin_pitch, pin_pitch, INF,
+      Position(-a, -a, 0.), "assembly");
+  assembly->fill(pin);
+  return assembly;
+}
+
+// Follows a particle through nsteps boundary crossings, and returns the
+// total distance travelled.
+double walk(GeoNavigator& nav, std::size_t nsteps) {
+  double distance = 0.;
+  for (std::size_t s = 0; s < nsteps; s++) {
+    GeoNavigator::Boundary b = nav.find_next_boundary();
+    distance += b.distance;
+    if (b.surface && b.surface->boundary() == Surface::BoundaryType::Reflective) {
+      nav.reflect_with_next_boundary();
+    } else {
+      nav.cross_next_boundary();
+      nav.find_location_from_current();
+    }
+  }
+  return distance;
+}
+
+}  // namespace
+
+int main() {
+  // Applying single transformations
+  const std::size_t npoints = 4096;
+  std::mt19937_64 gen(12345);
+  std::uniform_real_distribution<double> coord(-10., 10.);
+  std::vector<Position> points(npoints);
+  for (auto& p : points) p = Position(coord(gen), coord(gen), coord(gen));
+
+  std::printf(" %-22s %14s %14s %10s\n", "transformation", "tagged [ns]",
+              "general [ns]", "speedup");
+  std::pair<const char*, Transformation> transforms[3] = {
+      {"identity", Transformation()},
+      {"translation", Transformation::translation(1., -2., 0.5)},
+      {"rotation+translation",
+       Transformation::rotation_z(0.3) * Transformation::translation(1., -2., 0.5)}};
+  for (const auto& t : transforms) {
+    const Transformation& tagged = t.second;
+    Transformation full = general(tagged);
+    for (const auto& p : points) {
+      Position a = tagged * p;
+      Position b = full * p;
+      if (std::abs(a.x() - b.x()) + std::abs(a.y() - b.y()) +
+              std::abs(a.z() - b.z()) > 1.E-12) {
+        std::printf(" Kinds disagree for %s.\n", t.first);
+        return EXIT_FAILURE;
+      }
+    }
+
+    auto apply_all = [&](const Transformation& T) {
+      for (const auto& p : points) bench::do_not_optimize(T * p);
+    };
+    double t_tagged = bench::time_ns([&]() { apply_all(tagged); }, 2000) / npoints;
+    double t_full = bench::time_ns([&]() { apply_all(full); }, 2000) / npoints;
+    std::printf(" %-22s %14.2f %14.2f %10.2f\n", t.first, t_tagged, t_full,
+                t_full / t_tagged);
+  }
+
+  // Random walks through the assembly
+  const std::size_t ntracks = 2000;
+  const std::size_t nsteps = 100;
+  std::uniform_real_distribution<double> pos(-8.5 * pin_pitch, 8.5 * pin_pitch);
+  std::uniform_real_distribution<double> angle(0., 2. * PI);
+  std::vector<Position> r(ntracks);
+  std::vector<Direction> u(ntracks);
+  for (std::size_t i = 0; i < ntracks; i++) {
+    r[i] = Position(pos(gen), pos(gen), 0.);
+    double phi = angle(gen);
+    u[i] = Direction(std::cos(phi), std::sin(phi), 0.);
+  }
+
+  SurfaceMap tagged_surfs, general_surfs;
+  Geometry tagged_geom(tagged_surfs, make_assembly(tagged_surfs, true));
+  Geometry general_geom(general_surfs, make_assembly(general_surfs, false));
+  GeoNavigator tagged_nav(&tagged_geom, r[0], u[0]);
+  GeoNavigator general_nav(&general_geom, r[0], u[0]);
+
+  for (std::size_t i = 0; i < ntracks; i += 100) {
+    tagged_nav.find_location_from_root(r[i], u[i]);
+    general_nav.find_location_from_root(r[i], u[i]);
+    double d_tagged = walk(tagged_nav, nsteps);
+    double d_general = walk(general_nav, nsteps);
+    if (std::abs(d_tagged - d_general) > 1.E-9 * d_tagged) {
+      std::printf(" Walks disagree for track %zu.\n", i);
+      return EXIT_FAILURE;
+    }
+  }
+
+  auto time_walks = [&](GeoNavigator& nav) {
+    std::size_t i = 0;
+    return bench::time_ns(
+               [&]() {
+                 nav.find_location_from_root(r[i], u[i]);
+                 bench::do_not_optimize(walk(nav, nsteps));
+                 i = (i + 1) % ntracks;
+               },
+               ntracks) /
+           nsteps;
+  };
+  double t_tagged = time_walks(tagged_nav);
+  double t_general = time_walks(general_nav);
+  std::printf("\n %-22s %14s %14s %10s\n", "geometry", "tagged [ns]",
+              "general [ns]", "speedup");
+  std::printf(" %-22s %14.1f %14.1f %10.2f\n", "pin-cell lattice step",
+              t_tagged, t_general, t_general / t_tagged);
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Cost of history-based and event-based transport of the same fixed source
+// through a 17x17 assembly of pin cells, reflected on its sides and with
+// vacuum on its ends. Both modes must give identical results for the same
+// seed; event-based transport is run with several bank sizes. History-based
+// transport is also timed with delta tracking, whose results only agree with
+// surface tracking statistically.
+
+#include "assembly.hpp"
+#include "benchmark.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace pmc;
+using namespace pmc::bench;
+
+static bool same(const TransportResult& a, const TransportResult& b) {
+  return a.histories == b.histories && a.collisions == b.collisions &&
+         a.crossings == b.crossings && a.reflections == b.reflections &&
+         a.leaks == b.leaks && a.captures == b.captures &&
+         a.fissions == b.fissions && a.cutoffs == b.cutoffs &&
+         a.lost == b.lost && a.track_length == b.track_length;
+}
+
+int main() {
+  auto geom = make_assembly();
+
+  const std::size_t nhistories = 5000;
+  std::vector<SourceSite> sites = make_assembly_sites(nhistories);
+
+  // On one thread, so that the modes are compared history for history
+  TransportSettings settings;
+  settings.seed = 42;
+  settings.threads = 1;
+  TransportResult reference = transport(*geom, sites, settings);
+  std::printf(" %llu collisions, %llu crossings, %llu leaks\n\n",
+              static_cast<unsigned long long>(reference.collisions),
+              static_cast<unsigned long long>(reference.crossings),
+              static_cast<unsigned long long>(reference.leaks));
+
+  std::printf(" %-22s %18s\n", "mode", "history [us]");
+  double t_history = bench::time_ns(
+      [&]() { bench::do_not_optimize(transport(*geom, sites, settings)); }, 3);
+  std::printf(" %-22s %18.2f\n", "history", t_history / nhistories / 1000.);
+
+  settings.tracking = Tracking::Delta;
+  settings.majorant = std::make_shared<Majorant>(geom->materials());
+  TransportResult delta = transport(*geom, sites, settings);
+  if (std::abs(static_cast<double>(delta.collisions) /
+                   static_cast<double>(reference.collisions) - 1.) > 0.05) {
+    std::printf(" Delta tracking gives %llu collisions.\n",
+                static_cast<unsigned long long>(delta.collisions));
+    return EXIT_FAILURE;
+  }
+  double t_delta = bench::time_ns(
+      [&]() { bench::do_not_optimize(transport(*geom, sites, settings)); }, 3);
+  std::printf(" %-22s %18.2f\n", "history, delta", t_delta / nhistories / 1000.);
+  settings.tracking = Tracking::Surface;
+
+  settings.mode = TransportMode::Event;
+  for (std::size_t bank_size : {500, 1000, 5000}) {
+    settings.event_bank_size = bank_size;
+    if (!same(transport(*geom, sites, settings), reference)) {
+      std::printf(" Event-based results differ for a bank of %zu.\n",
+                  bank_size);
+      return EXIT_FAILURE;
+    }
+
+    double t_event = bench::time_ns(
+        [&]() { bench::do_not_optimize(transport(*geom, sites, settings)); },
+        3);
+    char label[64];
+    std::snprintf(label, sizeof(label), "event, bank %zu", bank_size);
+    std::printf(" %-22s %18.2f\n", label, t_event / nhistories / 1000.);
+  }
+
+  return EXIT_SUCCESS;
+}
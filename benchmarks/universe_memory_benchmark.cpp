@@ -0,0 +1,239 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Memory used by a full PWR core of 193 assemblies of 17x17 pins (55,777
+// pins), built three ways: by cloning the pin and assembly subtrees for every
+// placement, by placing shared universes with add_instance, and with nested
+// RectLattices. Memory is measured by counting the bytes live on the heap
+// before and after building the Geometry. Point location is timed as well.
+
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/geo_navigator.hpp>
+#include <Papillon/geometry/rect_lattice.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+std::size_t live_bytes = 0;
+constexpr std::size_t HEADER = alignof(std::max_align_t);
+}  // namespace
+
+// Every allocation records its size in a header, so that frees can be
+// subtracted from the count of live bytes.
+void* operator new(std::size_t n) {
+  void* p = std::malloc(n + HEADER);
+  if (!p) throw std::bad_alloc();
+  *static_cast<std::size_t*>(p) = n;
+  live_bytes += n;
+  return static_cast<char*>(p) + HEADER;
+}
+
+void operator delete(void* p) noexcept {
+  if (!p) return;
+  char* block = static_cast<char*>(p) - HEADER;
+  live_bytes -= *reinterpret_cast<std::size_t*>(block);
+  std::free(block);
+}
+
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+
+using namespace pmc;
+
+namespace {
+
+const double pin_pitch = 1.26;
+const double assembly_pitch = 17. * pin_pitch;
+// Number of assemblies in each row of the core
+const int row_lengths[15] = {7, 11, 13, 13, 15, 15, 15, 15,
+                             15, 15, 15, 13, 13, 11, 7};
+
+using SurfaceMap = std::unordered_map<uint32_t, std::shared_ptr<Surface>>;
+
+struct Volumes {
+  std::shared_ptr<Volume> fuel, clad, pin_cell, assembly_cell, core;
+};
+
+std::shared_ptr<Volume> box(SurfaceMap& surfs, double half_width, uint32_t id,
+                            Surface::BoundaryType bound) {
+  surfs[id] = std::make_shared<XPlane>(-half_width, bound, id);
+  surfs[id + 1] = std::make_shared<XPlane>(half_width, bound, id + 1);
+  surfs[id + 2] = std::make_shared<YPlane>(-half_width, bound, id + 2);
+  surfs[id + 3] = std::make_shared<YPlane>(half_width, bound, id + 3);
+  auto px = std::make_shared<HalfSpace>(surfs[id], Surface::Side::Positive, id);
+  auto nx = std::make_shared<HalfSpace>(surfs[id + 1], Surface::Side::Negative, id + 1);
+  auto py = std::make_shared<HalfSpace>(surfs[id + 2], Surface::Side::Positive, id + 2);
+  auto ny = std::make_shared<HalfSpace>(surfs[id + 3], Surface::Side::Negative, id + 3);
+  auto x = std::make_shared<Intersection>(px, nx, id + 4);
+  auto y = std::make_shared<Intersection>(py, ny, id + 5);
+  return std::make_shared<Intersection>(x, y, id + 6);
+}
+
+Volumes make_volumes(SurfaceMap& surfs) {
+  const auto T = Surface::BoundaryType::Transparent;
+  Volumes v;
+  surfs[1] = std::make_shared<ZCylinder>(0., 0., 0.4096, T, 1);
+  surfs[2] = std::make_shared<ZCylinder>(0., 0., 0.475, T, 2);
+  v.fuel = std::make_shared<HalfSpace>(surfs[1], Surface::Side::Negative, 1);
+  v.clad = std::make_shared<Intersection>(
+      std::make_shared<HalfSpace>(surfs[1], Surface::Side::Positive, 2),
+      std::make_shared<HalfSpace>(surfs[2], Surface::Side::Negative, 3), 4);
+  v.pin_cell = box(surfs, 0.5 * pin_pitch, 10, T);
+  v.assembly_cell = box(surfs, 0.5 * assembly_pitch, 20, T);
+  v.core = box(surfs, 7.5 * assembly_pitch, 30, Surface::BoundaryType::Vacuum);
+  return v;
+}
+
+std::unique_ptr<GeoNode> make_pin(const Volumes& v) {
+  auto pin = std::make_unique<GeoNode>(v.pin_cell, "moderator");
+  pin->add_node(v.fuel, Transformation(), "fuel");
+  pin->add_node(v.clad, Transformation(), "clad");
+  return pin;
+}
+
+double pin_offset(int i) { return (i - 8) * pin_pitch; }
+double assembly_offset(int i) { return (i - 7) * assembly_pitch; }
+
+template <class F>
+void for_each_assembly(F&& f) {
+  for (int j = 0; j < 15; j++) {
+    int first = (15 - row_lengths[j]) / 2;
+    for (int i = first; i < first + row_lengths[j]; i++) f(i, j);
+  }
+}
+
+std::unique_ptr<GeoNode> cloned_core(const Volumes& v) {
+  auto pin = make_pin(v);
+  auto assembly = std::make_unique<GeoNode>(v.assembly_cell, "assembly");
+  for (int j = 0; j < 17; j++)
+    for (int i = 0; i < 17; i++)
+      assembly->add_node(
+          pin->clone(),
+          Transformation::translation(pin_offset(i), pin_offset(j), 0.));
+
+  auto core = std::make_unique<GeoNode>(v.core, "core");
+  for_each_assembly([&](int i, int j) {
+    core->add_node(assembly->clone(),
+                   Transformation::translation(assembly_offset(i),
+                                               assembly_offset(j), 0.));
+  });
+  return core;
+}
+
+std::unique_ptr<GeoNode> instanced_core(const Volumes& v) {
+  std::shared_ptr<GeoNode> pin = make_pin(v);
+  auto assembly = std::make_shared<GeoNode>(v.assembly_cell, "assembly");
+  for (int j = 0; j < 17; j++)
+    for (int i = 0; i < 17; i++)
+      assembly->add_instance(
+          pin, Transformation::translation(pin_offset(i), pin_offset(j), 0.));
+
+  auto core = std::make_unique<GeoNode>(v.core, "core");
+  for_each_assembly([&](int i, int j) {
+    core->add_instance(assembly,
+                       Transformation::translation(assembly_offset(i),
+                                                   assembly_offset(j), 0.));
+  });
+  return core;
+}
+
+std::unique_ptr<GeoNode> lattice_core(const Volumes& v) {
+  std::shared_ptr<GeoNode> pin = make_pin(v);
+  double a = 0.5 * assembly_pitch;
+  auto assembly = std::make_shared<RectLattice>(
+      v.assembly_cell, 17, 17, 1, pin_pitch, pin_pitch, INF,
+      Position(-a, -a, 0.), "assembly");
+  assembly->fill(pin);
+
+  double c = 7.5 * assembly_pitch;
+  auto core = std::make_unique<RectLattice>(
+      v.core, 15, 15, 1, assembly_pitch, assembly_pitch, INF,
+      Position(-c, -c, 0.), "core");
+  for_each_assembly([&](int i, int j) { core->set_element(i, j, 0, assembly); });
+  return core;
+}
+
+}  // namespace
+
+int main() {
+  const std::size_t nquery = 100000;
+  std::mt19937_64 gen(12345);
+  std::uniform_real_distribution<double> pos(-7.5 * assembly_pitch,
+                                             7.5 * assembly_pitch);
+  std::vector<Position> r(nquery);
+  for (auto& ri : r) ri = Position(pos(gen), pos(gen), 0.);
+
+  std::printf(" %-10s %14s %14s %14s\n", "model", "memory [MB]",
+              "bytes / pin", "locate [ns]");
+
+  using Builder = std::unique_ptr<GeoNode> (*)(const Volumes&);
+  std::pair<const char*, Builder> models[3] = {{"clone", cloned_core},
+                                               {"instance", instanced_core},
+                                               {"lattice", lattice_core}};
+  for (const auto& model : models) {
+    SurfaceMap surfs;
+    Volumes v = make_volumes(surfs);
+
+    std::size_t before = live_bytes;
+    Geometry geom(surfs, model.second(v));
+    std::size_t used = live_bytes - before;
+
+    GeoNavigator nav(&geom, {0., 0., 0.}, {1., 0., 0.});
+    std::size_t i = 0;
+    double t_locate = bench::time_ns(
+        [&]() {
+          nav.find_location_from_root(r[i], {1., 0., 0.});
+          bench::do_not_optimize(nav.current_node());
+          i = (i + 1) % nquery;
+        },
+        nquery);
+
+    std::printf(" %-10s %14.2f %14.1f %14.1f\n", model.first, used / 1.E6,
+                used / (193. * 289.), t_locate);
+  }
+
+  return 0;
+}
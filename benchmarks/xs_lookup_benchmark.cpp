@@ -0,0 +1,129 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+
+// Cost and memory of the lookup of the macroscopic cross sections of a
+// material of 40 nuclides, with grids of 2000 to 60000 points, at random
+// energies. Each nuclide's grid is searched with a plain binary search, then
+// through its own LogHash, and finally the material's unionized grid is
+// searched once for all of them. All three must give the same cross
+// sections.
+
+#include <Papillon/materials/material.hpp>
+#include <Papillon/utils/rng.hpp>
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace pmc;
+
+static double binary_search_total(const Material& mat, double E) {
+  double total = 0.;
+  for (size_t j = 0; j < mat.size(); j++) {
+    const Nuclide& nuc = mat.nuclide(j);
+    pmc::ArrayView<double> grid = nuc.energy();
+    size_t i = static_cast<size_t>(
+        std::upper_bound(grid.begin(), grid.end(), E) - grid.begin());
+    i = std::min(i > 0 ? i - 1 : 0, grid.size() - 2);
+    total += mat.atom_density(j) * nuc.xs(i, E).total;
+  }
+  return total;
+}
+
+int main() {
+  RNG rng(2024);
+  Material mat(1, "fuel");
+  for (int n = 0; n < 40; n++) {
+    size_t npoints = 2000 + static_cast<size_t>(58000. * rng());
+    std::vector<double> energy, el, cap, fis;
+    for (size_t i = 0; i < npoints; i++) {
+      energy.push_back(1.E-11 * std::pow(2.E12, (i + 0.5 * rng()) / npoints));
+      el.push_back(1. + 20. * rng());
+      cap.push_back(10. * rng());
+      fis.push_back(n < 3 ? 10. * rng() : 0.);
+    }
+    mat.add_nuclide(std::make_shared<Nuclide>("nuclide", 1. + 6. * n, energy,
+                                              el, cap, fis, 2.4),
+                    0.001);
+  }
+
+  const std::size_t nlookups = 1 << 14;
+  std::vector<double> energies(nlookups);
+  for (auto& E : energies) E = 1.E-11 * std::pow(2.E12, rng());
+
+  std::vector<double> expected(nlookups);
+  for (std::size_t i = 0; i < nlookups; i++)
+    expected[i] = binary_search_total(mat, energies[i]);
+
+  auto lookup_all = [&]() {
+    double sum = 0.;
+    for (double E : energies) sum += mat.xs(E).total;
+    bench::do_not_optimize(sum);
+  };
+
+  std::printf(" %-22s %14s %14s\n", "grid", "[ns / lookup]", "memory [MB]");
+  double t_binary = bench::time_ns([&]() {
+    double sum = 0.;
+    for (double E : energies) sum += binary_search_total(mat, E);
+    bench::do_not_optimize(sum);
+  }, 20) / nlookups;
+
+  for (EnergyGridMode mode : {EnergyGridMode::Nuclide, EnergyGridMode::Unionized}) {
+    mat.set_grid_mode(mode);
+    for (std::size_t i = 0; i < nlookups; i++) {
+      if (mat.xs(energies[i]).total != expected[i]) {
+        std::printf(" Lookups disagree at E = %g.\n", energies[i]);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  mat.set_grid_mode(EnergyGridMode::Nuclide);
+  double mb_nuclide = Material::memory({&mat}) / 1.E6;
+  std::printf(" %-22s %14.1f %14s\n", "binary search", t_binary, "");
+  double t_nuclide = bench::time_ns(lookup_all, 20) / nlookups;
+  std::printf(" %-22s %14.1f %14.2f\n", "nuclide hash", t_nuclide, mb_nuclide);
+
+  mat.set_grid_mode(EnergyGridMode::Unionized);
+  double mb_union = Material::memory({&mat}) / 1.E6;
+  double t_union = bench::time_ns(lookup_all, 20) / nlookups;
+  std::printf(" %-22s %14.1f %14.2f\n", "unionized", t_union, mb_union);
+
+  return EXIT_SUCCESS;
+}
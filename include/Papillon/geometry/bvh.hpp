@@ -0,0 +1,159 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_BVH_H
+#define PAPILLON_BVH_H
+
+#include <Papillon/utils/aabb.hpp>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// BVH
+// Bounding volume hierarchy over a set of boxes, used by GeoNode to locate
+// its children without testing each one in turn. The hierarchy only stores
+// indices into the list of boxes it was built from; the queries hand those
+// indices back to a callback, which performs the exact test. Boxes which are
+// unbounded along some axis are kept out of the tree, and are always passed
+// to the callbacks.
+class BVH {
+ public:
+  // Number of primitives at or below which a node becomes a leaf.
+  static constexpr uint32_t LEAF_SIZE = 4;
+
+  BVH() = default;
+  BVH(const std::vector<AABB>& boxes);
+
+  bool empty() const { return nodes_.empty() && unbounded_.empty(); }
+  size_t nnodes() const { return nodes_.size(); }
+
+  // Calls f(i) for each box i which contains r, until f returns true.
+  // Returns true if a call to f returned true.
+  template <class F>
+  bool find(const Position& r, F&& f) const {
+    for (uint32_t i : unbounded_) {
+      if (f(i)) return true;
+    }
+    if (nodes_.empty()) return false;
+
+    std::array<uint32_t, MAX_DEPTH> stack;
+    size_t n = 0;
+    stack[n++] = 0;
+    while (n > 0) {
+      uint32_t indx = stack[--n];
+      const Node& node = nodes_[indx];
+      if (!node.box.contains(r)) continue;
+
+      if (node.count > 0) {
+        for (uint32_t p = node.first; p < node.first + node.count; p++) {
+          if (f(prims_[p])) return true;
+        }
+      } else {
+        stack[n++] = node.first;
+        stack[n++] = indx + 1;
+      }
+    }
+    return false;
+  }
+
+  // Finds the nearest hit along the ray (r, u). f(i, d) is called with each
+  // box i which the ray may reach before the current nearest distance d,
+  // nearer subtrees first, and must return the (possibly reduced) nearest
+  // distance. Returns the final nearest distance.
+  template <class F>
+  double nearest(const Position& r, const Direction& u, double dmax,
+                 F&& f) const {
+    double d = dmax;
+    for (uint32_t i : unbounded_) d = f(i, d);
+    if (nodes_.empty()) return d;
+
+    struct Entry {
+      uint32_t node;
+      double dist;
+    };
+    std::array<Entry, MAX_DEPTH> stack;
+    size_t n = 0;
+    stack[n++] = {0, nodes_[0].box.distance(r, u)};
+    while (n > 0) {
+      Entry e = stack[--n];
+      if (e.dist >= d) continue;
+
+      const Node& node = nodes_[e.node];
+      if (node.count > 0) {
+        for (uint32_t p = node.first; p < node.first + node.count; p++) {
+          d = f(prims_[p], d);
+        }
+        continue;
+      }
+
+      // Push the farther child first, so that the nearer one is visited
+      // first and tightens d for the other.
+      Entry left{e.node + 1, nodes_[e.node + 1].box.distance(r, u)};
+      Entry right{node.first, nodes_[node.first].box.distance(r, u)};
+      if (left.dist > right.dist) std::swap(left, right);
+      if (right.dist < d) stack[n++] = right;
+      if (left.dist < d) stack[n++] = left;
+    }
+    return d;
+  }
+
+ private:
+  // The tree is split at the median, so its depth is about log2(n / LEAF_SIZE)
+  // and the explicit stacks never hold more than one entry per level.
+  static constexpr size_t MAX_DEPTH = 64;
+
+  // Nodes are stored depth first. The left child of an interior node
+  // directly follows it, and first holds the index of the right child. For
+  // a leaf, first and count give its range in prims_.
+  struct Node {
+    AABB box;
+    uint32_t first;
+    uint32_t count;
+  };
+
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> prims_;
+  std::vector<uint32_t> unbounded_;
+
+  void build(const std::vector<AABB>& boxes,
+             const std::vector<Position>& centroids, uint32_t begin,
+             uint32_t end);
+};
+
+}  // namespace pmc
+
+#endif
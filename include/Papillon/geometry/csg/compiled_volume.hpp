@@ -0,0 +1,151 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_COMPILED_VOLUME_H
+#define PAPILLON_COMPILED_VOLUME_H
+
+#include <Papillon/geometry/csg/volume.hpp>
+#include <Papillon/geometry/surfaces/surface_table.hpp>
+
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// CompiledVolume
+// A Volume tree flattened into a contiguous program over surface indices
+// of a SurfaceTable. Operands appear in postfix order, and each Union,
+// Intersection or Difference becomes a conditional jump placed between its
+// two operands:
+//
+//   Union(A, B)        : A  JumpIfTrue(end)   B        end:
+//   Intersection(A, B) : A  JumpIfFalse(end)  B        end:
+//   Difference(A, B)   : A  JumpIfFalse(end)  B  Not   end:
+//
+// If the first operand already decides the result, evaluation jumps over the
+// second one. Every sub-expression therefore leaves exactly one boolean
+// behind, and the evaluation stack never grows beyond a single accumulator.
+class CompiledVolume {
+ public:
+  enum class OpCode : uint8_t { HalfSpace, JumpIfTrue, JumpIfFalse, Not };
+
+  struct Op {
+    OpCode code;
+    Surface::Side side;  // Side of the surface, for HalfSpace
+    uint32_t arg;        // Surface index for HalfSpace, target for jumps
+  };
+
+  CompiledVolume() : ops_(), table_(nullptr) {}
+  CompiledVolume(const Volume& volume, const SurfaceTable& table);
+  ~CompiledVolume() = default;
+
+  bool empty() const { return ops_.empty(); }
+  const std::vector<Op>& program() const { return ops_; }
+
+  // Table which the volume was compiled against, or nullptr if it was not.
+  const SurfaceTable* table() const { return table_; }
+
+  // True if the volume is an intersection of half-spaces. From a point
+  // inside of such a volume, the nearest crossing of any of its surfaces
+  // leaves the volume, so distance_to_boundary is exact.
+  bool is_intersection() const {
+    for (const auto& op : ops_) {
+      if (op.code == OpCode::JumpIfTrue || op.code == OpCode::Not) return false;
+    }
+    return true;
+  }
+
+  bool is_inside(const Position& r, const Direction& u, uint32_t on_surf = 0,
+                 Surface::Side on_side = Surface::Side::Positive) const {
+    const SurfaceTable& table = *table_;
+    const size_t nops = ops_.size();
+    bool value = false;
+    size_t pc = 0;
+    while (pc < nops) {
+      const Op& op = ops_[pc];
+      switch (op.code) {
+        case OpCode::HalfSpace:
+          // When on the surface, the side is known. Otherwise, sign already
+          // uses the direction to resolve points which are coincident.
+          if (table[op.arg].id == on_surf)
+            value = (on_side == op.side);
+          else
+            value = (table.sign(op.arg, r, u) == op.side);
+          pc++;
+          break;
+        case OpCode::JumpIfTrue:
+          pc = value ? op.arg : pc + 1;
+          break;
+        case OpCode::JumpIfFalse:
+          pc = value ? pc + 1 : op.arg;
+          break;
+        case OpCode::Not:
+          value = !value;
+          pc++;
+          break;
+      }
+    }
+    return value;
+  }
+
+  // Returns the nearest crossing of any surface used by the volume. This is
+  // the same quantity as Volume::get_boundary, computed with a flat loop.
+  // Unless is_intersection() holds, the crossing may lie inside of the
+  // volume, and Volume::get_ray gives the true boundary instead.
+  SurfaceCrossing distance_to_boundary(const Position& r, const Direction& u,
+                                       uint32_t on_surf = 0) const {
+    const SurfaceTable& table = *table_;
+    SurfaceCrossing crossing{INF, 0, Surface::Side::Positive};
+    for (const auto& op : ops_) {
+      if (op.code != OpCode::HalfSpace) continue;
+      double d = table.distance(op.arg, r, u, on_surf);
+      if (d < crossing.distance) {
+        crossing.distance = d;
+        crossing.surface = op.arg;
+      }
+    }
+    if (crossing.surface != 0)
+      crossing.side = table.sign(crossing.surface, r, u);
+    return crossing;
+  }
+
+ private:
+  std::vector<Op> ops_;
+  const SurfaceTable* table_;
+
+  void compile(const Volume& volume);
+};
+
+}  // namespace pmc
+
+#endif
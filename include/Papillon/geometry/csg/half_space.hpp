@@ -47,8 +47,11 @@ namespace pmc {
 
       bool is_inside(const Position& r, const Direction& u, uint32_t on_surf=0, Surface::Side on_side=Surface::Side::Positive) const override final;
       Boundary get_boundary(const Position& r, const Direction& u, uint32_t on_surf=0) const override final;
+      Ray get_ray(const Position& r, const Direction& u, uint32_t on_surf=0, Surface::Side on_side=Surface::Side::Positive) const override final;
+      AABB bounding_box() const override final;
 
     private:
+      friend class CompiledVolume;
       std::shared_ptr<Surface> surface_;
       Surface::Side side_;
 
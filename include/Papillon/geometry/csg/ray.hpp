@@ -0,0 +1,127 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_RAY_H
+#define PAPILLON_RAY_H
+
+#include <Papillon/geometry/surfaces/surface.hpp>
+#include <Papillon/utils/constants.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pmc {
+
+// Crossing of a surface along a ray, as used by the geometry tree. The
+// surface is identified by its id in the crossings of Volume::get_ray, and
+// by its index in the SurfaceTable of the Geometry in those returned by
+// CompiledVolume and GeoNode. In both cases, 0 means that no surface is
+// crossed. side is the side of the surface which the ray is on just before
+// the crossing.
+struct SurfaceCrossing {
+  double distance;
+  uint32_t surface;
+  Surface::Side side;
+};
+
+inline bool operator<(const SurfaceCrossing& c1, const SurfaceCrossing& c2) {
+  return c1.distance < c2.distance;
+}
+
+// Part of a ray which lies inside of a volume, from the crossing where the
+// ray enters it to the crossing where it leaves. A ray which starts inside
+// enters at distance 0 without crossing a surface, and a ray which never
+// leaves exits at INF.
+struct RayInterval {
+  SurfaceCrossing enter;
+  SurfaceCrossing exit;
+};
+
+//============================================================================
+// Ray
+// Sorted, disjoint intervals of distance along a ray, starting at 0, which
+// lie inside of a volume. The intervals of a CSG volume are those of its
+// half-spaces, combined by the set operations below. They are kept in a
+// fixed-size buffer inside of the Ray, so that no query allocates memory.
+// Intervals past the capacity are dropped. The Ray then only describes the
+// volume up to the entry of the first dropped interval, its limit, and
+// intervals reaching past the limit are cut short there. As the limit is a
+// real surface crossing, a boundary found along a full Ray may come too
+// early, but never too late.
+class Ray {
+ public:
+  static constexpr size_t CAPACITY = 8;
+
+  Ray() : size_(0), limit_{INF, 0, Surface::Side::Positive}, intervals_() {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const RayInterval& operator[](size_t i) const { return intervals_[i]; }
+  const RayInterval* begin() const { return intervals_.data(); }
+  const RayInterval* end() const { return intervals_.data() + size_; }
+
+  // Distance up to which the intervals are known
+  const SurfaceCrossing& limit() const { return limit_; }
+
+  // Appends an interval, which must start after the last one ends
+  void push_back(const RayInterval& interval) {
+    if (size_ < CAPACITY) intervals_[size_++] = interval;
+    else if (interval.enter < limit_) limit_ = interval.enter;
+  }
+
+  // Nearest crossing of the boundary of the volume: the exit of the
+  // interval containing the start of the ray, or else the first entry.
+  SurfaceCrossing next_crossing() const {
+    if (size_ == 0) return limit_;
+    const RayInterval& first = intervals_[0];
+    return first.enter.distance > 0. ? first.enter : first.exit;
+  }
+
+  static Ray unite(const Ray& a, const Ray& b);
+  static Ray intersect(const Ray& a, const Ray& b);
+  static Ray subtract(const Ray& a, const Ray& b);
+  // Intervals of the ray outside of every interval of a
+  static Ray complement(const Ray& a);
+
+ private:
+  size_t size_;
+  SurfaceCrossing limit_;
+  std::array<RayInterval, CAPACITY> intervals_;
+
+  // Lowers the limit of the Ray to limit, cutting intervals short there
+  void clip(const SurfaceCrossing& limit);
+};
+
+}  // namespace pmc
+
+#endif
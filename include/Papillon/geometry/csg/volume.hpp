@@ -34,7 +34,9 @@
 #ifndef PAPILLON_VOLUME_H
 #define PAPILLON_VOLUME_H
 
+#include <Papillon/utils/aabb.hpp>
 #include <Papillon/utils/direction.hpp>
+#include <Papillon/geometry/csg/ray.hpp>
 #include <Papillon/geometry/surfaces/surface.hpp>
 
 namespace pmc {
@@ -54,6 +56,15 @@ namespace pmc {
       virtual bool is_inside(const Position& r, const Direction& u, uint32_t on_surf=0, Surface::Side on_side=Surface::Side::Positive) const = 0;
       virtual Boundary get_boundary(const Position& r, const Direction& u, uint32_t on_surf=0) const = 0;
 
+      // Intervals of the ray from r along u which lie inside of the volume.
+      // Unlike get_boundary, whose nearest surface may lie inside of a
+      // Union, the first exit of the Ray is the true boundary of the volume.
+      virtual Ray get_ray(const Position& r, const Direction& u, uint32_t on_surf=0, Surface::Side on_side=Surface::Side::Positive) const = 0;
+
+      // Conservative box around the volume. Points outside of the box are
+      // guaranteed to be outside of the volume, but the converse is not true.
+      virtual AABB bounding_box() const = 0;
+
       uint32_t id() const {return id_;}
 
     protected:
@@ -36,63 +36,89 @@
 
 #include <Papillon/geometry/geometry.hpp>
 
-namespace pmc {
+#include <array>
+#include <string>
 
-struct Boundary {
-  double distance;
-  std::shared_ptr<Surface> surface;
-  Side side;
-};
+namespace pmc {
 
 class GeoNavigator {
  public:
+  // Next boundary along the path of the particle. surface is nullptr if the
+  // boundary is not a surface (a lattice wall, or no boundary at all). It
+  // does not own the surface, which is kept alive by the Geometry.
+  struct Boundary {
+    double distance;
+    const Surface* surface;
+    Surface::Side side;
+    uint32_t surface_index;  // Index in the SurfaceTable, 0 if no surface
+  };
+
+  // Maximum number of nodes from the root to the deepest node, inclusive
+  static constexpr size_t MAX_DEPTH = 16;
+
   GeoNavigator(Geometry* geom, Position r_global, Direction u_global)
       : geometry(geom),
-        current_node_(geom->root().get()),
-        r_local_(r_global),
-        u_local_(u_global),
-        global_to_local(),
+        levels_(),
+        depth_(1),
+        valid_depth_(MAX_DEPTH),
         on_surface(0),
-        on_side(Side::Positive),
-        next_boundary_{INF, nullptr, Side::Positive},
+        on_side(Surface::Side::Positive),
+        next_boundary_{INF, nullptr, Surface::Side::Positive, 0},
+        next_boundary_depth_(MAX_DEPTH),
+        next_boundary_cached_(false),
+        crossed_surface_(0),
         lost(false) {
+    levels_[0] = {geom->root().get(), nullptr, nullptr, 0,
+                  r_global, u_global};
     find_location_from_current();
   }
   GeoNavigator(const GeoNavigator& other)
       : geometry(other.geometry),
-        current_node_(other.current_node_),
-        r_local_(other.r_local_),
-        u_local_(other.u_local_),
-        global_to_local(other.global_to_local),
+        levels_(),
+        depth_(other.depth_),
+        valid_depth_(other.valid_depth_),
         on_surface(other.on_surface),
         on_side(other.on_side),
         next_boundary_(other.next_boundary_),
-        lost(other.lost) {}
+        next_boundary_depth_(other.next_boundary_depth_),
+        next_boundary_cached_(other.next_boundary_cached_),
+        crossed_surface_(other.crossed_surface_),
+        lost(other.lost) {
+    for (size_t i = 0; i < depth_; i++) levels_[i] = other.levels_[i];
+  }
   GeoNavigator& operator=(const GeoNavigator& other) {
     geometry = other.geometry;
-    current_node_ = other.current_node_;
-    r_local_ = other.r_local_;
-    u_local_ = other.u_local_;
-    global_to_local = other.global_to_local;
+    depth_ = other.depth_;
+    for (size_t i = 0; i < depth_; i++) levels_[i] = other.levels_[i];
+    valid_depth_ = other.valid_depth_;
     on_surface = other.on_surface;
     on_side = other.on_side;
     next_boundary_ = other.next_boundary_;
+    next_boundary_depth_ = other.next_boundary_depth_;
+    next_boundary_cached_ = other.next_boundary_cached_;
+    crossed_surface_ = other.crossed_surface_;
     lost = other.lost;
     return *this;
   }
   ~GeoNavigator() = default;
 
-  GeoNode* current_node() const { return current_node_; }
-  Position r_local() const { return r_local_; }
-  Direction u_local() const { return u_local_; }
+  GeoNode* current_node() const { return levels_[depth_ - 1].node; }
+  // Number of nodes from the root to the current node, inclusive
+  size_t depth() const { return depth_; }
+  Position r_local() const { return levels_[depth_ - 1].r; }
+  Direction u_local() const { return levels_[depth_ - 1].u; }
+  // Coordinates in the frame of the root node
+  Position r_global() const { return levels_[0].r; }
+  Direction u_global() const { return levels_[0].u; }
   bool is_lost() const { return lost; }
 
   void find_location_from_root(Position r_global, Direction u_global) {
     // Set current node to root, and reset quantities
-    current_node_ = geometry->root().get();
-    r_local_ = r_global;
-    u_local_ = u_global;
-    global_to_local = Vector(0., 0., 0.);
+    depth_ = 1;
+    levels_[0].r = r_global;
+    levels_[0].u = u_global;
+    valid_depth_ = MAX_DEPTH;
+    crossed_surface_ = 0;
     lost = false;
     find_location_from_current();
   }
@@ -100,44 +126,53 @@ class GeoNavigator {
   // This function starts from the current node, and moves up/down the tree
   // untill it has found the deepest node which contains the current location.
   // If the current location is not found, the position must be outisde of the
-  // geometry, in which case thee current_node_ is set to the root of the
-  // geometry, to allow for use in the plotting functionality.
+  // geometry, in which case thee current node is set to the root of the
+  // geometry, to allow for use in the plotting functionality. After a
+  // boundary has been crossed, the search starts from the deepest level
+  // which the crossing could not have left, and first tries the nodes found
+  // after earlier crossings of the same surface.
   void find_location_from_current() {
+    next_boundary_cached_ = false;
+    uint32_t crossed = crossed_surface_;
+    crossed_surface_ = 0;
+    if (valid_depth_ < depth_) depth_ = valid_depth_ > 0 ? valid_depth_ : 1;
+    valid_depth_ = MAX_DEPTH;
+
+    // A universe placed in a lattice is usually unbounded, so being inside
+    // of it says nothing about still being inside of the same element.
+    leave_changed_lattice_elements();
+
     bool found_end_node = false;
     while (!found_end_node) {
       // First check to see if we are inside the current node
-      if (current_node_->is_inside_local_frame(r_local_, u_local_,
-                                                on_surface, on_side)) {
+      if (is_inside_current()) {
         // We are inside the current node. This means we can keep moving
         // down the tree into children, until the current node has no
         // more children, in which case we are as far in as possible.
-        while (current_node_->nchildren() > 0) {
-          GeoNode* child =
-              current_node_->find_child_node(r_local_, u_local_, on_surface, on_side);
-          if (child) {
-            current_node_ = child;
-            Transformation parent_to_child = child->transformation();
-            global_to_local = parent_to_child * global_to_local;
-            r_local_ = parent_to_child * r_local_;
-          } else
-            break;
+        while (true) {
+          const Level& level = levels_[depth_ - 1];
+          GeoNode::ChildLocation child =
+              crossed ? level.node->find_child_across(level.r, level.u,
+                                                      on_surface, on_side,
+                                                      crossed)
+                      : level.node->find_child(level.r, level.u, on_surface,
+                                               on_side);
+          crossed = 0;
+          if (!child.node) break;
+          push_level(child);
         }
         lost = false;
         found_end_node = true;
       } else {
-        while (!current_node_->is_inside_local_frame(r_local_, u_local_,
-                                                      on_surface, on_side)) {
-          // We must go up a node, and see if we are inside it
-          if (current_node_->parent()) {
-            current_node_ = current_node_->parent();
-            Transformation current_to_previous = current_node_->transformation().inverse();
-            global_to_local = current_to_previous * global_to_local;
-            r_local_ = current_to_previous * r_local_;
+        while (!is_inside_current()) {
+          // We must go up a node, and see if we are inside it. The
+          // coordinates of the parent are already known.
+          if (depth_ > 1) {
+            depth_--;
           } else {
             // There is no parent node, so the particle is forever lost
             lost = true;
             found_end_node = true;  // Just to get out of outer loop
-            current_node_ = geometry->root().get();
             break;
           }
         }  // While not in current node
@@ -148,55 +183,69 @@ class GeoNavigator {
   // This method checks to see if the current coordinates are located inside
   // of the current node.
   bool is_inside_current() const {
-    return current_node_->is_inside_local_frame(r_local_, u_local_,
-                                                 on_surface, on_side);
+    const Level& level = levels_[depth_ - 1];
+    return level.node->is_inside_local_frame(level.r, level.u, on_surface,
+                                             on_side);
   }
 
   void move_distance(double d) {
-    r_local_ += d * u_local_;
+    for (size_t i = 0; i < depth_; i++) levels_[i].r += d * levels_[i].u;
+
+    // Moving along the same direction brings the next boundary closer by d,
+    // so it need not be found again.
+    if (next_boundary_cached_ && next_boundary_.distance < INF) {
+      if (d <= next_boundary_.distance) next_boundary_.distance -= d;
+      else next_boundary_cached_ = false;
+    }
 
     // If we were on a surface, but moved, we no longer are, so we
     // can set it back to zero
     if (on_surface != 0) on_surface = 0;
   }
 
-  void set_direction(const Direction& u) { 
-    u_local_ = u; 
-  }
+  // Sets the direction in the frame of the current node
+  void set_direction(const Direction& u) { set_direction(depth_ - 1, u); }
 
   void set_new_global_coords(Position r_global, Direction u_global) {
-    r_local_ = r_global + global_to_local;
-    u_local_ = u_global;
+    next_boundary_cached_ = false;
+    levels_[0].r = r_global;
+    levels_[0].u = u_global;
+    for (size_t i = 1; i < depth_; i++) {
+      levels_[i].r = *levels_[i].to_node * levels_[i - 1].r;
+      levels_[i].u = *levels_[i].to_node * levels_[i - 1].u;
+    }
   }
 
-  void set_on_surface(uint32_t on_surf, Side on_sd) {
+  void set_on_surface(uint32_t on_surf, Surface::Side on_sd) {
+    next_boundary_cached_ = false;
     on_surface = on_surf;
     on_side = on_sd;
   }
 
+  // The boundary found is kept until the particle changes direction, crosses
+  // a boundary, or is located again, so calling this again after only moving
+  // along the same direction does not repeat the search.
   Boundary find_next_boundary() {
-    // Get intersection with current node volume first
-    SurfaceCrossing boundary = current_node_->distance_to_boundary(r_local_, u_local_);
-
-    // Now must check boundary to nearest child
-    SurfaceCrossing child_boundary = current_node_->distance_to_child_boundary(r_local_, u_local_);
-
-    if(child_boundary < boundary) boundary = child_boundary;
-    
+    if (next_boundary_cached_) return next_boundary_;
 
-    uint32_t surf_id = boundary.surface;
-    std::shared_ptr<Surface> surface = nullptr;
-    if (surf_id != 0 && geometry->surfaces.find(surf_id) == geometry->surfaces.end()) {
-      // Cann't find surface
-      std::string mssg = "Cannot find surface with id " + std::to_string(surf_id) + ".";
-      throw PMCException(mssg, __FILE__, __LINE__);
-    } else if (surf_id != 0) {
-      surface = geometry->surfaces[surf_id];
-    }
+    // Get intersection with current node volume first. Crossing it leaves
+    // the current node.
+    const Level& level = levels_[depth_ - 1];
+    return complete_next_boundary(
+        level.node->distance_to_boundary(level.r, level.u));
+  }
 
-    next_boundary_ = {boundary.distance, surface, boundary.side};
+  // Same as find_next_boundary, with the distance to the boundary of the
+  // current node's volume, and the index of its surface, already found by
+  // GeoNode::distance_to_boundary_batch for a batch of particles.
+  Boundary find_next_boundary(double distance, uint32_t surface) {
+    if (next_boundary_cached_) return next_boundary_;
 
-    return next_boundary_;
+    const Level& level = levels_[depth_ - 1];
+    SurfaceCrossing boundary{distance, surface, Surface::Side::Positive};
+    if (surface != 0)
+      boundary.side = geometry->surface_table().sign(surface, level.r, level.u);
+    return complete_next_boundary(boundary);
   }
 
   // TODO Boundary find_next_surface() const {}
@@ -210,7 +259,8 @@ class GeoNavigator {
     // and not just an "infinity" boundary.
     if(next_boundary_.surface) {
       // Travel distance to surface
-      r_local_ += next_boundary_.distance * u_local_;
+      move_distance(next_boundary_.distance);
+      next_boundary_cached_ = false;
 
       // Set on_surface
       on_surface = next_boundary_.surface->id();
@@ -218,40 +268,163 @@ class GeoNavigator {
       // Set on_side to same side as we were just on
       on_side = next_boundary_.side;
 
-      // Change direction
-      Direction n = next_boundary_.surface->normal(r_local_);
-      u_local_ = u_local_ - 2.*(u_local_*n)*n;
+      // Change direction, in the frame of the node which the surface bounds.
+      // That is the current node, or a lattice above it.
+      size_t level = next_boundary_depth_ < depth_ ? next_boundary_depth_ : depth_ - 1;
+      Direction u = levels_[level].u;
+      Direction n = geometry->surface_table().normal(next_boundary_.surface_index, levels_[level].r);
+      set_direction(level, u - 2.*(u*n)*n);
     }
   }
 
   void cross_next_boundary() {
-    // Only try to cross if there is a true boundary (i.e. a surface), and
-    // not just an "infinity" boundary.
-    if(next_boundary_.surface) {
+    // Only try to cross if there is a true boundary, and not just an
+    // "infinity" boundary.
+    if(next_boundary_.distance < INF) {
       // Travel distance to surface
-      r_local_ += next_boundary_.distance * u_local_;
+      move_distance(next_boundary_.distance);
+      next_boundary_cached_ = false;
 
-      // Set on_surface
-      on_surface = next_boundary_.surface->id();
-      
-      // Set on_side to opposite of the side we were just on
-      if(next_boundary_.side == Side::Positive) on_side = Side::Negative;
-      else on_side = Side::Positive;
+      if(next_boundary_.surface) {
+        // Set on_surface
+        on_surface = next_boundary_.surface->id();
+
+        // Set on_side to opposite of the side we were just on
+        if(next_boundary_.side == Surface::Side::Positive) on_side = Surface::Side::Negative;
+        else on_side = Surface::Side::Positive;
+      } else {
+        // The walls of lattice elements are not surfaces
+        on_surface = 0;
+      }
+
+      // Levels above the one the boundary belongs to are still valid
+      valid_depth_ = next_boundary_depth_;
+      crossed_surface_ = next_boundary_.surface_index;
     }
   }
 
  private:
+  // One level of the path from the root to the current node. to_node maps
+  // coordinates from the frame of the previous level to the frame of node,
+  // and to_parent is its inverse; both are nullptr for the root. element is
+  // the element of the previous level which holds node. r and u are the
+  // coordinates in the frame of node.
+  struct Level {
+    GeoNode* node;
+    const Transformation* to_node;
+    const Transformation* to_parent;
+    uint32_t element;
+    Position r;
+    Direction u;
+  };
+
+  // Completes the search of find_next_boundary, from the crossing of the
+  // volume of the current node
+  Boundary complete_next_boundary(SurfaceCrossing boundary) {
+    const Level& level = levels_[depth_ - 1];
+    next_boundary_depth_ = depth_ - 1;
+
+    // Now must check boundary to nearest child, which keeps the current node
+    SurfaceCrossing child_boundary = level.node->distance_to_child_boundary(level.r, level.u);
+
+    if(child_boundary < boundary) {
+      boundary = child_boundary;
+      next_boundary_depth_ = depth_;
+    }
+
+    // Lattice elements above the current node have walls of their own. The
+    // universe in an element is not bounded by the lattice's volume either,
+    // so that volume is checked as well, and wins ties with the walls.
+    for (size_t i = depth_ - 1; i > 0; i--) {
+      const Level& lattice = levels_[i - 1];
+      if (!lattice.node->is_lattice()) continue;
+      double d = lattice.node->distance_to_element_boundary(lattice.r, lattice.u,
+                                                            levels_[i].element);
+      if (d < boundary.distance) {
+        boundary = {d, 0, Surface::Side::Positive};
+        next_boundary_depth_ = i;
+      }
+      SurfaceCrossing outer = lattice.node->distance_to_boundary(lattice.r, lattice.u);
+      if (outer.distance <= boundary.distance) {
+        boundary = outer;
+        next_boundary_depth_ = i - 1;
+      }
+    }
+
+    // The surface is found by its index in the geometry's surface table,
+    // which was assigned when the Geometry was constructed. Every volume was
+    // checked against the table when it was compiled, so the index is valid.
+    uint32_t surf_indx = boundary.distance < INF ? boundary.surface : 0;
+    const Surface* surface = geometry->surface_table().surface(surf_indx).get();
+
+    next_boundary_ = {boundary.distance, surface, boundary.side, surf_indx};
+    next_boundary_cached_ = true;
+
+    return next_boundary_;
+  }
+
   Geometry* geometry;
-  GeoNode* current_node_;
-  Position r_local_;
-  Direction u_local_;
-  Vector global_to_local;
+  std::array<Level, MAX_DEPTH> levels_;
+  size_t depth_;
+  // Number of levels which are known to still contain the particle
+  size_t valid_depth_;
   uint32_t on_surface;
-  Side on_side;
+  Surface::Side on_side;
   Boundary next_boundary_;
+  // Number of levels which still contain the particle after crossing
+  // next_boundary_
+  size_t next_boundary_depth_;
+  // True while next_boundary_ is still the boundary ahead of the particle
+  bool next_boundary_cached_;
+  // Index in the SurfaceTable of the surface which was just crossed, until
+  // the particle has been located again; 0 otherwise
+  uint32_t crossed_surface_;
   bool lost;
+
+  // Sets the direction in the frame of the given level, and carries it to
+  // the frames of all other levels
+  void set_direction(size_t level, const Direction& u) {
+    next_boundary_cached_ = false;
+    levels_[level].u = u;
+    for (size_t i = level; i > 0; i--)
+      levels_[i - 1].u = *levels_[i].to_parent * levels_[i].u;
+    for (size_t i = level + 1; i < depth_; i++)
+      levels_[i].u = *levels_[i].to_node * levels_[i - 1].u;
+  }
+
+  void push_level(const GeoNode::ChildLocation& child) {
+    if (depth_ == MAX_DEPTH) {
+      std::string mssg = "Geometry is deeper than GeoNavigator::MAX_DEPTH (" +
+                         std::to_string(MAX_DEPTH) + ").";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    const Level& parent = levels_[depth_ - 1];
+    levels_[depth_] = {child.node,
+                       child.to_child,
+                       child.to_parent,
+                       child.element,
+                       *child.to_child * parent.r,
+                       *child.to_child * parent.u};
+    depth_++;
+  }
+
+  // Pops every level which sits in a lattice element that no longer
+  // contains the current position.
+  void leave_changed_lattice_elements() {
+    for (size_t i = 1; i < depth_; i++) {
+      const Level& parent = levels_[i - 1];
+      if (!parent.node->is_lattice()) continue;
+
+      GeoNode::ChildLocation child =
+          parent.node->find_child(parent.r, parent.u, on_surface, on_side);
+      if (!child.node || child.element != levels_[i].element) {
+        depth_ = i;
+        return;
+      }
+    }
+  }
 };
 
 }  // namespace pmc
 
-#endif
\ No newline at end of file
+#endif
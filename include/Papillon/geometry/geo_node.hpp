@@ -34,19 +34,39 @@
 #ifndef PAPILLON_GEO_NODE_H
 #define PAPILLON_GEO_NODE_H
 
+#include <Papillon/geometry/bvh.hpp>
+#include <Papillon/geometry/csg/compiled_volume.hpp>
 #include <Papillon/geometry/csg/volume.hpp>
+#include <Papillon/geometry/neighbor_list.hpp>
+#include <Papillon/utils/aabb.hpp>
 #include <Papillon/utils/transformation.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace pmc {
 
+class Material;
+
 //============================================================================
 // GeoNode
 // Base class for all nodes which make up the geometry-tree.
 class GeoNode {
  public:
+  // Child found by find_child. to_child maps coordinates from the frame of
+  // this node to the frame of the child, and to_parent is its inverse.
+  // element identifies the child (its index for ordinary nodes, or its
+  // lattice element for lattices).
+  struct ChildLocation {
+    GeoNode* node;
+    const Transformation* to_child;
+    const Transformation* to_parent;
+    uint32_t element;
+  };
+
   GeoNode(std::shared_ptr<Volume> v, const std::string& name);
   GeoNode(std::shared_ptr<Volume> v, Transformation t, const std::string& name);
   GeoNode(GeoNode* p, std::shared_ptr<Volume> v, Transformation t,
@@ -56,86 +76,281 @@ class GeoNode {
   GeoNode(GeoNode&&) = delete;
   GeoNode& operator=(const GeoNode&) = delete;
 
-  ~GeoNode() = default;
+  virtual ~GeoNode() = default;
 
   // add_node
   GeoNode* add_node(std::shared_ptr<Volume> v, Transformation t, std::string name);
   GeoNode* add_node(std::unique_ptr<GeoNode> node, Transformation t);
   GeoNode* add_node(std::unique_ptr<GeoNode> node);
 
-  // Cloning
-  std::unique_ptr<GeoNode> clone() const;
+  // Places a universe inside of this node. A universe is a GeoNode which is
+  // shared by any number of placements, in any number of nodes, and is only
+  // stored once. t maps the frame of the placement to the frame of this
+  // node, and is applied before the universe's own transformation. The
+  // universe's parent is left untouched, as it has no single parent.
+  GeoNode* add_instance(std::shared_ptr<GeoNode> universe, Transformation t);
+
+  // Cloning. Owned children are cloned, but instances of universes are not,
+  // and are shared with the clone. Lattices clone their elements as well.
+  virtual std::unique_ptr<GeoNode> clone() const;
   // TODO std::unique_ptr<GeoNode> clone_with_material() const; // For depletion
 
+  // Compiles the volume of this node, and of all nodes below it, against
+  // the surface table of the geometry. Until a node is finalized, queries
+  // fall back to evaluating its Volume tree recursively. Nodes with at least
+  // BVH_MIN_CHILDREN children also build a BVH over them, unless disabled
+  // with set_use_bvh(false). A universe placed in several nodes is only
+  // finalized once per call.
+  void finalize(const SurfaceTable& table);
+
+  // Adds the materials of this node, and of all nodes below it, to
+  // materials, unless they are already in it.
+  void collect_materials(std::vector<const Material*>& materials) const;
+
+  static constexpr size_t BVH_MIN_CHILDREN = 8;
+
   // Setters (shouldn't need to be inlined)
   void set_parent(GeoNode* p);
   void set_transformation(Transformation t);
   void set_name(const std::string& name);
+  void set_use_bvh(bool use_bvh) { use_bvh_ = use_bvh; }
+  // Material filling the part of the node which is not in any child. Nodes
+  // without a material are void.
+  void set_material(std::shared_ptr<Material> material) {
+    material_ = material;
+  }
 
   // Getters (should be inlined for speed)
   GeoNode* parent() const { return parent_; }
-  Transformation transformation() const { return transform_; }
+  // Transformation from the frame of the parent to the frame of the node,
+  // and its inverse, which is the transformation given by the user.
+  const Transformation& transformation() const { return transform_; }
+  const Transformation& inverse_transformation() const {
+    return inverse_transform_;
+  }
   std::shared_ptr<Volume> volume() const { return volume_; }
   const std::string& name() const { return name_; }
-  size_t nchildren() const { return children_.size(); }
+  const Material* material() const { return material_.get(); }
+  // Box around the node's volume, in the frame of the parent node
+  const AABB& bounding_box() const { return bbox_; }
+  // Number of children, counting each placement of a universe
+  size_t nchildren() const { return placements_.size(); }
+  // Number of distinct universes placed in this node
+  size_t nuniverses() const { return universes_.size(); }
+  bool has_bvh() const { return !bvh_.empty(); }
+  // Lattices have element boundaries which are not surfaces of any volume
+  bool is_lattice() const { return is_lattice_; }
 
   // This method takes coordinates from the nodes local frame, and then finds
   // the child node (should one exist), which contains the given coordinates.
-  // This will likely become a virtual method in the future, for lattices.
-  GeoNode* find_child_node(const Position& r_local, const Direction& u_local,
-                           uint32_t on_surface, Side on_side) const {
-    for (const auto& child : children_) {
-      if (child->is_inside_parent_frame(r_local, u_local, on_surface, on_side)) {
-        return child.get();
+  virtual ChildLocation find_child(const Position& r_local,
+                                   const Direction& u_local,
+                                   uint32_t on_surface,
+                                   Surface::Side on_side) const {
+    ChildLocation found{nullptr, nullptr, nullptr, 0};
+    auto test_child = [&](size_t i) {
+      return test_placement(i, r_local, u_local, on_surface, on_side, found);
+    };
+
+    if (!bvh_.empty()) {
+      bvh_.find(r_local, test_child);
+    } else {
+      for (size_t i = 0; i < placements_.size(); i++) {
+        if (test_child(i)) break;
       }
     }
-    return nullptr;
+    return found;
+  }
+
+  // Same as find_child, for a point which has just crossed the surface with
+  // index surface_index in the SurfaceTable, onto side on_side. The children
+  // found after earlier crossings of that side of the surface are tested
+  // first, and the full search is only made if none of them holds the point.
+  // Safe to call from many threads at once.
+  ChildLocation find_child_across(const Position& r_local,
+                                  const Direction& u_local,
+                                  uint32_t on_surface, Surface::Side on_side,
+                                  uint32_t surface_index) const {
+    NeighborList* list = neighbor_list(surface_index, on_side);
+    if (!list) return find_child(r_local, u_local, on_surface, on_side);
+
+    ChildLocation found{nullptr, nullptr, nullptr, 0};
+    if (list->find([&](uint32_t i) {
+          return test_placement(i, r_local, u_local, on_surface, on_side,
+                                found);
+        }))
+      return found;
+
+    found = find_child(r_local, u_local, on_surface, on_side);
+    if (found.node) list->insert(found.element);
+    return found;
+  }
+
+  // Children found so far after crossing the given side of a surface, or
+  // nullptr if the node keeps no list for that surface.
+  const NeighborList* neighbors(uint32_t surface_index,
+                                Surface::Side side) const {
+    return neighbor_list(surface_index, side);
+  }
+
+  GeoNode* find_child_node(const Position& r_local, const Direction& u_local,
+                           uint32_t on_surface, Surface::Side on_side) const {
+    return find_child(r_local, u_local, on_surface, on_side).node;
   }
 
   bool is_inside_parent_frame(const Position& r_parent, const Direction& u_parent,
-                               uint32_t on_surf, Side on_side) const {
+                               uint32_t on_surf, Surface::Side on_side) const {
     Position r_local = transform_ * r_parent;
     Direction u_local = transform_ * u_parent;
-    return volume_->is_inside(r_local, u_local, on_surf, on_side);
+    return is_inside_local_frame(r_local, u_local, on_surf, on_side);
   }
 
   bool is_inside_local_frame(const Position& r_local, const Direction& u_local,
-                              uint32_t on_surf, Side on_side) const {
+                              uint32_t on_surf, Surface::Side on_side) const {
+    if (!compiled_volume_.empty())
+      return compiled_volume_.is_inside(r_local, u_local, on_surf, on_side);
     return volume_->is_inside(r_local, u_local, on_surf, on_side);
   }
 
+  // Returns the crossing where a ray from r_local, inside of the node's
+  // volume, leaves it. The surface is given by its index in the SurfaceTable
+  // which the node was finalized against, or by its id if it was not.
   SurfaceCrossing distance_to_boundary(const Position& r_local,
                                        const Direction& u) const {
-    Ray ray = volume_->get_ray(r_local, u);
-    if (ray.size() == 0)
-      return {INF, 0, Side::Positive};
-    else if (ray[0].first.distance > 0.)
-      return ray[0].first;
-    else
-      return ray[0].second;
+    if (intersection_volume_)
+      return compiled_volume_.distance_to_boundary(r_local, u);
+    // The Ray identifies the surface by its id, which is remapped here
+    SurfaceCrossing crossing = volume_->get_ray(r_local, u).next_crossing();
+    const SurfaceTable* table = compiled_volume_.table();
+    if (table && crossing.surface != 0)
+      crossing.surface = table->index(crossing.surface);
+    return crossing;
   }
 
-  SurfaceCrossing distance_to_child_boundary(const Position& r_local, const Direction& u_local) const {
-    SurfaceCrossing boundary{INF, 0, Side::Positive};
+  // Same as distance_to_boundary, for n rays whose positions (x,y,z) and
+  // directions (u,v,w) in the frame of the node are given as separate
+  // arrays, but without the side of the crossings. The distances to each
+  // surface are computed for all rays at once with Surface::distance_batch,
+  // and d is scratch space for n of them. Only a finalized node whose
+  // volume is an intersection of half-spaces can do this, and false is
+  // returned, without writing to distance and surface, for any other node.
+  bool distance_to_boundary_batch(const double* x, const double* y,
+                                  const double* z, const double* u,
+                                  const double* v, const double* w, double* d,
+                                  size_t n, double* distance,
+                                  uint32_t* surface) const;
+
+  virtual SurfaceCrossing distance_to_child_boundary(const Position& r_local, const Direction& u_local) const {
+    SurfaceCrossing boundary{INF, 0, Surface::Side::Positive};
 
-    for (const auto& child : children_) {
-      Transformation to_child = child->transformation();
-      Position r_child = to_child * r_local;
-      Direction u_child = to_child * u_local;
+    auto test_child = [&](size_t i, double nearest) {
+      const Placement& child = placements_[i];
+      // A child whose box is no closer than the current nearest crossing
+      // cannot provide a nearer one.
+      if (child.box.distance(r_local, u_local) >= nearest)
+        return nearest;
+      Position r_child = child.to_child * r_local;
+      Direction u_child = child.to_child * u_local;
       SurfaceCrossing child_boundary =
-          child->distance_to_boundary(r_child, u_child);
+          child.node->distance_to_boundary(r_child, u_child);
       if (child_boundary < boundary) boundary = child_boundary;
+      return boundary.distance;
+    };
+
+    if (!bvh_.empty()) {
+      bvh_.nearest(r_local, u_local, INF, test_child);
+    } else {
+      for (size_t i = 0; i < placements_.size(); i++)
+        test_child(i, boundary.distance);
     }
 
     return boundary;
   }
 
+  // Distance from r_local, in the frame of this node, to the boundary of
+  // the given element of the node. Only lattices have element boundaries
+  // which are not already surfaces of their children.
+  virtual double distance_to_element_boundary(const Position& /*r_local*/,
+                                              const Direction& /*u_local*/,
+                                              uint32_t /*element*/) const {
+    return INF;
+  }
+
+ protected:
+  bool is_lattice_;
+
+  // Keeps universe alive, and finalizes it along with this node. Lattices
+  // use this for the universes of their elements.
+  void add_universe(std::shared_ptr<GeoNode> universe);
+
+  // Gives copy, which has just been made by clone, the transformation,
+  // material and children of this node
+  void clone_into(GeoNode& copy) const;
+
  private:
+  // Child of the node, either owned or an instance of a universe. to_child
+  // maps the frame of this node to the frame of the child, to_parent is its
+  // inverse, and box bounds the child in the frame of this node.
+  struct Placement {
+    GeoNode* node;
+    Transformation to_child;
+    Transformation to_parent;
+    AABB box;
+  };
+
   std::string name_;
   GeoNode* parent_;
   std::shared_ptr<Volume> volume_;
+  std::shared_ptr<Material> material_;
+  CompiledVolume compiled_volume_;
+  // True when compiled_volume_ is an intersection of half-spaces, whose
+  // nearest surface crossing is always its boundary
+  bool intersection_volume_;
   Transformation transform_;
+  Transformation inverse_transform_;
+  AABB bbox_;
   std::deque<std::unique_ptr<GeoNode>> children_;
+  std::vector<std::shared_ptr<GeoNode>> universes_;
+  std::vector<Placement> placements_;
+  BVH bvh_;
+  bool use_bvh_;
+  // Sorted indices of the surfaces bounding the children, with a
+  // NeighborList for the negative and the positive side of each.
+  std::vector<uint32_t> neighbor_surfaces_;
+  std::unique_ptr<NeighborList[]> neighbors_;
+  // Last call of finalize which reached this node, 0 if none did
+  uint64_t finalize_pass_;
+
+  void finalize(const SurfaceTable& table, uint64_t pass);
+
+  bool test_placement(size_t i, const Position& r_local,
+                      const Direction& u_local, uint32_t on_surface,
+                      Surface::Side on_side, ChildLocation& found) const {
+    const Placement& child = placements_[i];
+    if (!child.box.contains(r_local)) return false;
+    if (child.node->is_inside_local_frame(child.to_child * r_local,
+                                          child.to_child * u_local,
+                                          on_surface, on_side)) {
+      found = {child.node, &child.to_child, &child.to_parent,
+               static_cast<uint32_t>(i)};
+      return true;
+    }
+    return false;
+  }
+
+  NeighborList* neighbor_list(uint32_t surface_index,
+                              Surface::Side side) const {
+    auto it = std::lower_bound(neighbor_surfaces_.begin(),
+                               neighbor_surfaces_.end(), surface_index);
+    if (it == neighbor_surfaces_.end() || *it != surface_index) return nullptr;
+    size_t n = static_cast<size_t>(it - neighbor_surfaces_.begin());
+    return &neighbors_[2 * n + (side == Surface::Side::Positive ? 1 : 0)];
+  }
+
+  void build_neighbor_lists();
+  void update_bounding_box();
+  void update_placement(const GeoNode* child);
+  void add_placement(GeoNode* node, const Transformation& to_child);
 };
 
 }  // namespace pmc
@@ -36,6 +36,7 @@
 
 #include <Papillon/geometry/geo_node.hpp>
 #include <Papillon/geometry/surfaces/surface.hpp>
+#include <Papillon/geometry/surfaces/surface_table.hpp>
 #include <unordered_map>
 
 namespace pmc {
@@ -49,15 +50,29 @@ class Geometry {
            std::unordered_map<uint32_t, std::shared_ptr<Volume>> vols,
            std::unique_ptr<GeoNode> r);
 
+  // The nodes of the tree are compiled against the surface table of the
+  // geometry, and refer to it by address.
+  Geometry(const Geometry&) = delete;
+  Geometry(Geometry&&) = delete;
+  Geometry& operator=(const Geometry&) = delete;
+
   ~Geometry() = default;
 
   const std::unique_ptr<GeoNode>& root() const { return root_; }
+  const SurfaceTable& surface_table() const { return surface_table_; }
+  // Every distinct material in the tree
+  std::vector<const Material*> materials() const {
+    std::vector<const Material*> mats;
+    root_->collect_materials(mats);
+    return mats;
+  }
 
  private:
   friend class GeoNavigator;
 
   std::vector<std::shared_ptr<Surface>> boundary_conditions;
   std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+  SurfaceTable surface_table_;
   std::unordered_map<uint32_t, std::shared_ptr<Volume>> volumes;
   std::unique_ptr<GeoNode> root_;
 };
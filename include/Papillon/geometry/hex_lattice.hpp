@@ -0,0 +1,265 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_HEX_LATTICE_H
+#define PAPILLON_HEX_LATTICE_H
+
+#include <Papillon/geometry/geo_node.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// HexLattice
+// Node made of hexagonal elements, arranged in nrings rings around a central
+// element, and stacked in nz axial layers. Elements are identified by their
+// axial coordinates (q, r) and their layer k, with (0,0) being the central
+// element. The central element is centered at (x0, y0), and the bottom layer
+// starts at z0. Element (q, r, k) is centered at
+//   (x0, y0) + q a1 + r a2,   z0 + (k + 1/2) pz,
+// where the basis depends on the orientation, and p is the flat-to-flat
+// pitch of the hexagons:
+//   Y : a1 = p (sqrt(3)/2, 1/2), a2 = p (0, 1),     flats normal to y
+//   X : a1 = p (1, 0),           a2 = p (1/2, sqrt(3)/2), flats normal to x
+// An element exists if |q|, |r| and |q + r| are all less than nrings. An
+// axial pitch of INF makes the lattice infinite along z, with a single layer
+// centered at z = 0. As for RectLattice, elements hold shared universes,
+// and the element walls are not surfaces.
+class HexLattice : public GeoNode {
+ public:
+  enum class Orientation { X, Y };
+
+  HexLattice(std::shared_ptr<Volume> v, Orientation orientation,
+             uint32_t nrings, uint32_t nz, double pitch, double pz,
+             Position origin, const std::string& name);
+
+  // Places universe in element (q, r, k). A nullptr universe leaves the
+  // element empty, in which case it belongs to the lattice node itself.
+  void set_element(int32_t q, int32_t r, uint32_t k,
+                   std::shared_ptr<GeoNode> universe);
+  // Places universe in every element of the lattice.
+  void fill(std::shared_ptr<GeoNode> universe);
+
+  // The clone shares the universes of the elements
+  std::unique_ptr<GeoNode> clone() const override;
+
+  GeoNode* element(int32_t q, int32_t r, uint32_t k) const {
+    return elements_[flat_index(q, r, k)].universe;
+  }
+  Orientation orientation() const { return orientation_; }
+  uint32_t nrings() const { return nrings_; }
+  uint32_t nz() const { return nz_; }
+  // Center of element (q, r, k), in the frame of the lattice
+  Position element_center(int32_t q, int32_t r, uint32_t k) const;
+
+  ChildLocation find_child(const Position& r_local, const Direction& u_local,
+                           uint32_t on_surface,
+                           Surface::Side on_side) const override final {
+    uint32_t element = 0;
+    if (!element_index(r_local, u_local, element))
+      return {nullptr, nullptr, nullptr, 0};
+
+    const Element& e = elements_[element];
+    if (!e.universe) return {nullptr, nullptr, nullptr, 0};
+    if (!e.universe->is_inside_local_frame(
+            e.to_universe * r_local,
+            e.to_universe * u_local, on_surface, on_side))
+      return {nullptr, nullptr, nullptr, 0};
+    return {e.universe, &e.to_universe, &e.to_lattice, element};
+  }
+
+  // When a particle is in the lattice node itself, it is either in an empty
+  // element, outside of the bounded universe of its element, or outside of
+  // the elements. Outside of them, the walls of the hexagons which would
+  // continue the lattice are used, once the particle is inside of the box
+  // around the elements.
+  SurfaceCrossing distance_to_child_boundary(
+      const Position& r_local, const Direction& u_local) const override final {
+    if (!grid_box_.contains(r_local))
+      return {grid_box_.distance(r_local, u_local), 0, Surface::Side::Positive};
+
+    std::array<int32_t, 3> qrk = locate(r_local, u_local);
+    SurfaceCrossing boundary{wall_distance(r_local, u_local, qrk), 0,
+                             Surface::Side::Positive};
+    if (in_lattice(qrk)) {
+      const Element& e =
+          elements_[flat_index(qrk[0], qrk[1], static_cast<uint32_t>(qrk[2]))];
+      if (e.universe) {
+        SurfaceCrossing entry = e.universe->distance_to_boundary(
+            e.to_universe * r_local, e.to_universe * u_local);
+        if (entry < boundary) boundary = entry;
+      }
+    }
+    return boundary;
+  }
+
+  double distance_to_element_boundary(const Position& r_local,
+                                      const Direction& u_local,
+                                      uint32_t element) const override final {
+    int32_t side = 2 * static_cast<int32_t>(nrings_) - 1;
+    int32_t n = static_cast<int32_t>(nrings_) - 1;
+    int32_t e = static_cast<int32_t>(element);
+    std::array<int32_t, 3> qrk{e % side - n, (e / side) % side - n,
+                               e / (side * side)};
+    return wall_distance(r_local, u_local, qrk);
+  }
+
+  // Finds the element containing r_local. Points on an element wall are
+  // placed in the element that u_local points into. Returns false if the
+  // point is outside of all elements.
+  bool element_index(const Position& r_local, const Direction& u_local,
+                     uint32_t& element) const {
+    std::array<int32_t, 3> qrk = locate(r_local, u_local);
+    if (!in_lattice(qrk)) return false;
+    element = flat_index(qrk[0], qrk[1], static_cast<uint32_t>(qrk[2]));
+    return true;
+  }
+
+ private:
+  // Points closer to an element wall than this fraction of the pitch are
+  // considered to be on the wall.
+  static constexpr double WALL_TOLERANCE = 1.E-9;
+
+  struct Element {
+    GeoNode* universe;
+    Transformation to_universe;
+    Transformation to_lattice;
+  };
+
+  Orientation orientation_;
+  uint32_t nrings_;
+  uint32_t nz_;
+  double pitch_;
+  double pz_;
+  Position origin_;
+  // Basis of the axial coordinates, and unit normals of the three pairs of
+  // walls of a hexagon, in the xy plane.
+  std::array<double, 2> a1_, a2_;
+  std::array<std::array<double, 2>, 3> normals_;
+  AABB grid_box_;
+  std::vector<Element> elements_;
+
+  uint32_t flat_index(int32_t q, int32_t r, uint32_t k) const {
+    uint32_t n = nrings_ - 1;
+    uint32_t side = 2 * nrings_ - 1;
+    return static_cast<uint32_t>(q + n) +
+           side * (static_cast<uint32_t>(r + n) + side * k);
+  }
+
+  bool in_lattice(const std::array<int32_t, 3>& qrk) const {
+    int32_t n = static_cast<int32_t>(nrings_);
+    return std::abs(qrk[0]) < n && std::abs(qrk[1]) < n &&
+           std::abs(qrk[0] + qrk[1]) < n && qrk[2] >= 0 &&
+           qrk[2] < static_cast<int32_t>(nz_);
+  }
+
+  // Returns the axial coordinates and layer of the hexagon which contains
+  // r_local, whether or not it is an element of the lattice. The point is
+  // first nudged along u_local, so that points on a wall are placed in the
+  // hexagon they are heading into.
+  std::array<int32_t, 3> locate(const Position& r_local,
+                                const Direction& u_local) const {
+    double nudge = WALL_TOLERANCE * pitch_;
+    double x = r_local.x() + nudge * u_local.x() - origin_.x();
+    double y = r_local.y() + nudge * u_local.y() - origin_.y();
+
+    // Fractional axial coordinates, from the inverse of the basis
+    double qf, rf;
+    if (orientation_ == Orientation::Y) {
+      qf = x / a1_[0];
+      rf = (y - qf * a1_[1]) / a2_[1];
+    } else {
+      rf = y / a2_[1];
+      qf = (x - rf * a2_[0]) / a1_[0];
+    }
+
+    // Round to the nearest hexagon center, in cube coordinates
+    double sf = -qf - rf;
+    double q = std::round(qf);
+    double r = std::round(rf);
+    double s = std::round(sf);
+    double dq = std::abs(q - qf);
+    double dr = std::abs(r - rf);
+    double ds = std::abs(s - sf);
+    if (dq > dr && dq > ds)
+      q = -r - s;
+    else if (dr > ds)
+      r = -q - s;
+
+    int32_t k = 0;
+    if (pz_ != INF) {
+      double zf = (r_local.z() + nudge * u_local.z() - origin_.z()) / pz_;
+      k = static_cast<int32_t>(std::floor(zf));
+    }
+
+    return {static_cast<int32_t>(q), static_cast<int32_t>(r), k};
+  }
+
+  // Distance to the walls of hexagon qrk, which need not be an element.
+  double wall_distance(const Position& r_local, const Direction& u_local,
+                       const std::array<int32_t, 3>& qrk) const {
+    double cx = origin_.x() + qrk[0] * a1_[0] + qrk[1] * a2_[0];
+    double cy = origin_.y() + qrk[0] * a1_[1] + qrk[1] * a2_[1];
+    double dx = r_local.x() - cx;
+    double dy = r_local.y() - cy;
+    double apothem = 0.5 * pitch_;
+
+    double dist = INF;
+    for (const auto& n : normals_) {
+      double un = n[0] * u_local.x() + n[1] * u_local.y();
+      if (un == 0.) continue;
+      double rn = n[0] * dx + n[1] * dy;
+      double d = ((un > 0. ? apothem : -apothem) - rn) / un;
+      if (d < 0.) d = 0.;
+      if (d < dist) dist = d;
+    }
+
+    if (pz_ != INF && u_local.z() != 0.) {
+      double wall = origin_.z() + pz_ * (u_local.z() > 0. ? qrk[2] + 1 : qrk[2]);
+      double d = (wall - r_local.z()) / u_local.z();
+      if (d < 0.) d = 0.;
+      if (d < dist) dist = d;
+    }
+    return dist;
+  }
+};
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_NEIGHBOR_LIST_H
+#define PAPILLON_NEIGHBOR_LIST_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace pmc {
+
+//============================================================================
+// NeighborList
+// Short append-only list of indices, which may be read and appended to by
+// many threads at once without locking. GeoNode keeps one for each side of
+// each surface its children are bounded by, holding the children which
+// particles were found in after crossing that surface. Entries are never
+// removed, and once the list is full further entries are dropped, so a
+// list only ever serves as a hint which the caller must verify.
+class NeighborList {
+ public:
+  static constexpr uint32_t CAPACITY = 8;
+
+  NeighborList() : size_(0), entries_() {
+    for (auto& entry : entries_) entry.store(EMPTY, std::memory_order_relaxed);
+  }
+
+  NeighborList(const NeighborList&) = delete;
+  NeighborList& operator=(const NeighborList&) = delete;
+
+  uint32_t size() const {
+    uint32_t n = size_.load(std::memory_order_acquire);
+    return n < CAPACITY ? n : CAPACITY;
+  }
+
+  // Calls f(i) on the entries, in the order they were added, until f returns
+  // true. Returns whether it did. An entry whose slot has been claimed by an
+  // append which has not finished yet is skipped.
+  template <class F>
+  bool find(F&& f) const {
+    const uint32_t n = size();
+    for (uint32_t s = 0; s < n; s++) {
+      uint32_t i = entries_[s].load(std::memory_order_acquire);
+      if (i != EMPTY && f(i)) return true;
+    }
+    return false;
+  }
+
+  bool contains(uint32_t i) const {
+    return find([i](uint32_t j) { return i == j; });
+  }
+
+  // Appends i unless it is already present or the list is full. When two
+  // threads append the same index at the same time, it may be stored twice,
+  // which only costs a repeated test.
+  void insert(uint32_t i) {
+    if (contains(i)) return;
+    uint32_t slot = size_.load(std::memory_order_relaxed);
+    do {
+      if (slot >= CAPACITY) return;
+    } while (!size_.compare_exchange_weak(slot, slot + 1,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_relaxed));
+    entries_[slot].store(i, std::memory_order_release);
+  }
+
+ private:
+  static constexpr uint32_t EMPTY = UINT32_MAX;
+
+  std::atomic<uint32_t> size_;
+  std::array<std::atomic<uint32_t>, CAPACITY> entries_;
+};
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_RECT_LATTICE_H
+#define PAPILLON_RECT_LATTICE_H
+
+#include <Papillon/geometry/geo_node.hpp>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// RectLattice
+// Node made of a rectilinear grid of nx * ny * nz elements, each of which
+// holds a universe. The lower corner of element (0,0,0) is at lower_left,
+// and element (i,j,k) is centered at
+//   lower_left + ((i + 1/2) px, (j + 1/2) py, (k + 1/2) pz).
+// A pitch of INF makes the lattice infinite along that axis, in which case
+// it must have a single element along it, centered at 0. A universe is a
+// GeoNode which may be placed in any number of elements (and lattices),
+// with coordinates local to the center of each element. The element which
+// contains a point is found directly from the position, and the element
+// walls are not surfaces, so their distances are computed analytically.
+class RectLattice : public GeoNode {
+ public:
+  RectLattice(std::shared_ptr<Volume> v, uint32_t nx, uint32_t ny,
+              uint32_t nz, double px, double py, double pz,
+              Position lower_left, const std::string& name);
+
+  // Places universe in element (i,j,k). A nullptr universe leaves the
+  // element empty, in which case it belongs to the lattice node itself.
+  void set_element(uint32_t i, uint32_t j, uint32_t k,
+                   std::shared_ptr<GeoNode> universe);
+  // Places universe in every element of the lattice.
+  void fill(std::shared_ptr<GeoNode> universe);
+
+  // The clone shares the universes of the elements
+  std::unique_ptr<GeoNode> clone() const override;
+
+  GeoNode* element(uint32_t i, uint32_t j, uint32_t k) const {
+    return elements_[flat_index(i, j, k)].universe;
+  }
+  const std::array<uint32_t, 3>& shape() const { return shape_; }
+  const std::array<double, 3>& pitch() const { return pitch_; }
+
+  ChildLocation find_child(const Position& r_local, const Direction& u_local,
+                           uint32_t on_surface,
+                           Surface::Side on_side) const override final {
+    uint32_t element = 0;
+    if (!element_index(r_local, u_local, element))
+      return {nullptr, nullptr, nullptr, 0};
+
+    const Element& e = elements_[element];
+    if (!e.universe) return {nullptr, nullptr, nullptr, 0};
+    if (!e.universe->is_inside_local_frame(
+            e.to_universe * r_local,
+            e.to_universe * u_local, on_surface, on_side))
+      return {nullptr, nullptr, nullptr, 0};
+    return {e.universe, &e.to_universe, &e.to_lattice, element};
+  }
+
+  // When a particle is in the lattice node itself, it is either in an empty
+  // element, outside of the bounded universe of its element, or outside of
+  // the grid of elements.
+  SurfaceCrossing distance_to_child_boundary(
+      const Position& r_local, const Direction& u_local) const override final {
+    uint32_t element = 0;
+    if (!element_index(r_local, u_local, element))
+      return {grid_box_.distance(r_local, u_local), 0, Surface::Side::Positive};
+
+    SurfaceCrossing boundary{
+        distance_to_element_boundary(r_local, u_local, element), 0,
+        Surface::Side::Positive};
+    const Element& e = elements_[element];
+    if (e.universe) {
+      SurfaceCrossing entry = e.universe->distance_to_boundary(
+          e.to_universe * r_local, e.to_universe * u_local);
+      if (entry < boundary) boundary = entry;
+    }
+    return boundary;
+  }
+
+  double distance_to_element_boundary(const Position& r_local,
+                                      const Direction& u_local,
+                                      uint32_t element) const override final {
+    std::array<uint32_t, 3> ijk{element % shape_[0],
+                                (element / shape_[0]) % shape_[1],
+                                element / (shape_[0] * shape_[1])};
+    double dist = INF;
+    for (size_t a = 0; a < 3; a++) {
+      if (pitch_[a] == INF || u_local[a] == 0.) continue;
+      double wall = lower_left_[a] + pitch_[a] * (u_local[a] > 0. ? ijk[a] + 1 : ijk[a]);
+      double d = (wall - r_local[a]) / u_local[a];
+      if (d < 0.) d = 0.;
+      if (d < dist) dist = d;
+    }
+    return dist;
+  }
+
+  // Finds the element containing r_local. Points on an element wall are
+  // placed in the element that u_local points into. Returns false if the
+  // point is outside of the grid of elements.
+  bool element_index(const Position& r_local, const Direction& u_local,
+                     uint32_t& element) const {
+    std::array<int64_t, 3> ijk{0, 0, 0};
+    for (size_t a = 0; a < 3; a++) {
+      if (pitch_[a] == INF) continue;
+      double x = (r_local[a] - lower_left_[a]) * inv_pitch_[a];
+      double fl = std::floor(x);
+      int64_t i = static_cast<int64_t>(fl);
+      double frac = x - fl;
+      if (frac < WALL_TOLERANCE && u_local[a] < 0.)
+        i--;
+      else if (frac > 1. - WALL_TOLERANCE && u_local[a] > 0.)
+        i++;
+      if (i < 0 || i >= static_cast<int64_t>(shape_[a])) return false;
+      ijk[a] = i;
+    }
+    element = flat_index(static_cast<uint32_t>(ijk[0]),
+                         static_cast<uint32_t>(ijk[1]),
+                         static_cast<uint32_t>(ijk[2]));
+    return true;
+  }
+
+ private:
+  // Points closer to an element wall than this fraction of the pitch are
+  // considered to be on the wall.
+  static constexpr double WALL_TOLERANCE = 1.E-9;
+
+  struct Element {
+    GeoNode* universe;
+    Transformation to_universe;
+    Transformation to_lattice;
+  };
+
+  std::array<uint32_t, 3> shape_;
+  std::array<double, 3> pitch_;
+  std::array<double, 3> inv_pitch_;
+  Position lower_left_;
+  AABB grid_box_;
+  std::vector<Element> elements_;
+
+  uint32_t flat_index(uint32_t i, uint32_t j, uint32_t k) const {
+    return i + shape_[0] * (j + shape_[1] * k);
+  }
+};
+
+}  // namespace pmc
+
+#endif
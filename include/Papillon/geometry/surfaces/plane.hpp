@@ -46,8 +46,13 @@ namespace pmc {
       Side sign(const Position& r, const Direction& u) const override final;
       double distance(const Position& r, const Direction& u, uint32_t on_surf=0) const override final;
       Direction normal(const Position& r) const override final;
+      AABB bounding_box(Side side) const override final;
+      void distance_batch(const double* x, const double* y, const double* z,
+                          const double* u, const double* v, const double* w,
+                          double* d, size_t n, const uint32_t* on_surf=nullptr) const override final;
 
     private:
+      friend class SurfaceTable;
       double A,B,C,D;
 
   }; // Plane
@@ -34,8 +34,11 @@
 #ifndef PAPILLON_SURFACE_H
 #define PAPILLON_SURFACE_H
 
+#include <Papillon/utils/aabb.hpp>
 #include <Papillon/utils/direction.hpp>
 
+#include <cstdint>
+
 namespace pmc {
 
 class Surface {
@@ -43,7 +46,8 @@ class Surface {
   enum class BoundaryType { Transparent, Vacuum, Reflective };
   enum class Side: bool { Positive=true, Negative=false };
   
-  Surface(BoundaryType boundary, uint32_t id) : id_(id), boundary_(boundary) {
+  Surface(BoundaryType boundary, uint32_t id)
+      : id_(id), boundary_(boundary) {
     if (id_ == 0) {
       std::string mssg = "surface id must be > 0.";
       throw PMCException(mssg, __FILE__, __LINE__);
@@ -55,12 +59,42 @@ class Surface {
   virtual double distance(const Position& r, const Direction& u, uint32_t on_surf=0) const = 0;
   virtual Direction normal(const Position& r) const = 0;
 
+  // Returns a box which contains the half-space on the given side of the
+  // surface. The box is infinite along every unbounded direction.
+  virtual AABB bounding_box(Side side) const = 0;
+
+  // Computes the distance to the surface for a batch of n particles, whose
+  // positions (x,y,z) and directions (u,v,w) are given as separate arrays,
+  // with (u,v,w) normalized. The result for particle i, written to d[i], is identical to that of
+  // distance(). If on_surf is not null, on_surf[i] gives the id of the
+  // surface which particle i is currently on. Surface types override this
+  // with OpenMP SIMD loops built only of selects, so that a single virtual
+  // call covers the whole batch and the loop is vectorized.
+  virtual void distance_batch(const double* x, const double* y,
+                              const double* z, const double* u,
+                              const double* v, const double* w, double* d,
+                              size_t n, const uint32_t* on_surf = nullptr) const {
+    for (size_t i = 0; i < n; i++) {
+      uint32_t on = on_surf ? on_surf[i] : 0;
+      d[i] = distance({x[i], y[i], z[i]}, {u[i], v[i], w[i]}, on);
+    }
+  }
+
   BoundaryType boundary() const { return boundary_; }
   uint32_t id() const { return id_; }
 
  protected:
   uint32_t id_;
   BoundaryType boundary_;
+
+  // Sets d[i] to INF for all particles which are on this surface. Used by
+  // the distance_batch kernels, so that the main loop remains branch-free.
+  void mask_on_surface(const uint32_t* on_surf, double* d, size_t n) const {
+    if (!on_surf) return;
+    for (size_t i = 0; i < n; i++) {
+      if (on_surf[i] == id_) d[i] = INF;
+    }
+  }
 };
 
 }  // namespace pmc
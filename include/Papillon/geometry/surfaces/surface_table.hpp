@@ -0,0 +1,299 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_SURFACE_TABLE_H
+#define PAPILLON_SURFACE_TABLE_H
+
+#include <Papillon/geometry/surfaces/surface.hpp>
+#include <Papillon/utils/constants.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// SurfaceTable
+// Flattened copy of all surfaces in a geometry. Each surface is stored as a
+// tagged entry, holding its coefficients inline, in a dense array indexed by
+// the internal surface index. Index 0 is reserved to mean "no surface", in
+// the same way that a surface id of 0 is never valid. The surfaces are not
+// modified, so that they may be shared by several tables, and the user ids
+// are only remapped to indices once, when the volumes of the Geometry are
+// compiled. Evaluations then go through a switch on the entry type, instead
+// of through the vtable.
+class SurfaceTable {
+ public:
+  enum class Type : uint8_t {
+    None,
+    XPlane,
+    YPlane,
+    ZPlane,
+    Plane,
+    XCylinder,
+    YCylinder,
+    ZCylinder,
+    Sphere
+  };
+
+  struct Entry {
+    Type type;
+    Surface::BoundaryType boundary;
+    uint32_t id;
+    // XPlane : x0              YPlane : y0              ZPlane : z0
+    // Plane  : A, B, C, D
+    // XCylinder : y0, z0, R    YCylinder : x0, z0, R    ZCylinder : x0, y0, R
+    // Sphere : x0, y0, z0, R
+    std::array<double, 4> c;
+  };
+
+  SurfaceTable();
+  SurfaceTable(
+      const std::unordered_map<uint32_t, std::shared_ptr<Surface>>& surfs);
+  ~SurfaceTable() = default;
+
+  // Number of surfaces in the table, not counting the reserved entry 0.
+  size_t size() const { return entries_.size() - 1; }
+
+  const Entry& operator[](uint32_t indx) const { return entries_[indx]; }
+  const std::shared_ptr<Surface>& surface(uint32_t indx) const {
+    return surfaces_[indx];
+  }
+
+  // Returns the index of the surface with the given id. This requires a hash
+  // lookup, and is only intended for use when building geometry.
+  uint32_t index(uint32_t id) const;
+
+  // Same as index, but returns 0 if no surface has the given id.
+  uint32_t find(uint32_t id) const {
+    auto it = id_to_index_.find(id);
+    return it == id_to_index_.end() ? 0 : it->second;
+  }
+
+  Surface::Side sign(uint32_t indx, const Position& r,
+                     const Direction& u) const {
+    const Entry& s = entries_[indx];
+    double eval = 0.;
+    switch (s.type) {
+      case Type::XPlane:
+        eval = r.x() - s.c[0];
+        break;
+      case Type::YPlane:
+        eval = r.y() - s.c[0];
+        break;
+      case Type::ZPlane:
+        eval = r.z() - s.c[0];
+        break;
+      case Type::Plane:
+        eval = s.c[0] * r.x() + s.c[1] * r.y() + s.c[2] * r.z() - s.c[3];
+        break;
+      case Type::XCylinder: {
+        double y = r.y() - s.c[0];
+        double z = r.z() - s.c[1];
+        eval = y * y + z * z - s.c[2] * s.c[2];
+      } break;
+      case Type::YCylinder: {
+        double x = r.x() - s.c[0];
+        double z = r.z() - s.c[1];
+        eval = x * x + z * z - s.c[2] * s.c[2];
+      } break;
+      case Type::ZCylinder: {
+        double x = r.x() - s.c[0];
+        double y = r.y() - s.c[1];
+        eval = y * y + x * x - s.c[2] * s.c[2];
+      } break;
+      case Type::Sphere: {
+        double x = r.x() - s.c[0];
+        double y = r.y() - s.c[1];
+        double z = r.z() - s.c[2];
+        eval = (x * x) + (y * y) + (z * z) - s.c[3] * s.c[3];
+      } break;
+      case Type::None:
+        break;
+    }
+
+    if (eval > SURFACE_COINCIDENT)
+      return Surface::Side::Positive;
+    else if (eval < -SURFACE_COINCIDENT)
+      return Surface::Side::Negative;
+    else if (u.dot(normal(indx, r)) > 0.)
+      return Surface::Side::Positive;
+    else
+      return Surface::Side::Negative;
+  }
+
+  double distance(uint32_t indx, const Position& r, const Direction& u,
+                  uint32_t on_surf = 0) const {
+    const Entry& s = entries_[indx];
+    if (on_surf == s.id) return INF;
+
+    switch (s.type) {
+      case Type::XPlane:
+        return plane_distance(s.c[0] - r.x(), u.x());
+      case Type::YPlane:
+        return plane_distance(s.c[0] - r.y(), u.y());
+      case Type::ZPlane:
+        return plane_distance(s.c[0] - r.z(), u.z());
+      case Type::Plane: {
+        double num = s.c[3] - s.c[0] * r.x() - s.c[1] * r.y() - s.c[2] * r.z();
+        double denom = s.c[0] * u.x() + s.c[1] * u.y() + s.c[2] * u.z();
+        if (denom == 0. || std::abs(num / denom) < SURFACE_COINCIDENT)
+          return INF;
+        else if (num / denom < 0.)
+          return INF;
+        else
+          return num / denom;
+      }
+      case Type::XCylinder:
+        return cylinder_distance(r.y() - s.c[0], r.z() - s.c[1], u.y(), u.z(),
+                                 s.c[2]);
+      case Type::YCylinder:
+        return cylinder_distance(r.x() - s.c[0], r.z() - s.c[1], u.x(), u.z(),
+                                 s.c[2]);
+      case Type::ZCylinder:
+        return cylinder_distance(r.y() - s.c[1], r.x() - s.c[0], u.y(), u.x(),
+                                 s.c[2]);
+      case Type::Sphere:
+        return sphere_distance(r.x() - s.c[0], r.y() - s.c[1], r.z() - s.c[2],
+                               u, s.c[3]);
+      case Type::None:
+        break;
+    }
+    return INF;
+  }
+
+  Direction normal(uint32_t indx, const Position& r) const {
+    const Entry& s = entries_[indx];
+    switch (s.type) {
+      case Type::XPlane:
+        return {1., 0., 0.};
+      case Type::YPlane:
+        return {0., 1., 0.};
+      case Type::ZPlane:
+        return {0., 0., 1.};
+      case Type::Plane:
+        return {s.c[0], s.c[1], s.c[2]};
+      case Type::XCylinder:
+        return {0., r.y() - s.c[0], r.z() - s.c[1]};
+      case Type::YCylinder:
+        return {r.x() - s.c[0], 0., r.z() - s.c[1]};
+      case Type::ZCylinder:
+        return {r.x() - s.c[0], r.y() - s.c[1], 0.};
+      case Type::Sphere:
+        return {r.x() - s.c[0], r.y() - s.c[1], r.z() - s.c[2]};
+      case Type::None:
+        break;
+    }
+    return Direction();
+  }
+
+ private:
+  std::vector<Entry> entries_;
+  std::vector<std::shared_ptr<Surface>> surfaces_;
+  std::unordered_map<uint32_t, uint32_t> id_to_index_;
+
+  static Entry make_entry(const Surface& surf);
+
+  // diff is the signed distance from the position to the plane, along the
+  // plane's axis, and u is the direction component along that axis.
+  static double plane_distance(double diff, double u) {
+    if (std::fabs(diff) < SURFACE_COINCIDENT || u == 0.)
+      return INF;
+    else if (diff / u < 0.)
+      return INF;
+    else
+      return diff / u;
+  }
+
+  // (a, b) is the position relative to the cylinder axis, in the plane
+  // normal to the axis, and (ua, ub) are the corresponding direction
+  // components.
+  static double cylinder_distance(double a, double b, double ua, double ub,
+                                  double R) {
+    double aa = ua * ua + ub * ub;
+    if (aa == 0.) return INF;
+
+    double k = a * ua + b * ub;
+    double c = a * a + b * b - R * R;
+    double quad = k * k - aa * c;
+
+    if (quad < 0.)
+      return INF;
+    else if (std::abs(c) < SURFACE_COINCIDENT) {
+      if (k >= 0.)
+        return INF;
+      else
+        return (-k + std::sqrt(quad)) / aa;
+    } else if (c < 0.) {
+      return (-k + std::sqrt(quad)) / aa;
+    } else {
+      double d = (-k - std::sqrt(quad)) / aa;
+      if (d < 0.)
+        return INF;
+      else
+        return d;
+    }
+  }
+
+  static double sphere_distance(double x, double y, double z,
+                                const Direction& u, double R) {
+    double k = x * u.x() + y * u.y() + z * u.z();
+    double c = x * x + y * y + z * z - R * R;
+    double quad = k * k - c;
+
+    if (quad < 0.) {
+      return INF;
+    } else if (std::abs(c) < SURFACE_COINCIDENT) {
+      if (k >= 0.)
+        return INF;
+      else
+        return -k + std::sqrt(quad);
+    } else if (c < 0.) {
+      return -k + std::sqrt(quad);
+    } else {
+      double d = -k - std::sqrt(quad);
+      if (d < 0.)
+        return INF;
+      else
+        return d;
+    }
+  }
+};
+
+}  // namespace pmc
+
+#endif
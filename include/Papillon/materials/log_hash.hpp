@@ -0,0 +1,113 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_LOG_HASH_H
+#define PAPILLON_LOG_HASH_H
+
+#include <Papillon/utils/array_view.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+namespace pmc {
+
+//============================================================================
+// LogHash
+// Index into a sorted energy grid, over NBINS bins of equal lethargy
+// between E_MIN and E_MAX. Each bin stores the grid interval holding its
+// lower edge, so that finding the interval of an energy is a binary search
+// over the few points in its bin. Every hash uses the same bins, so the bin
+// of an energy is found once for any number of grids. The table is shared
+// between copies, and may live in a memory mapped file.
+class LogHash {
+ public:
+  static constexpr double E_MIN = 1.E-11;  // MeV
+  static constexpr double E_MAX = 1.E3;    // MeV
+  static constexpr size_t NBINS = 8192;
+  // Bin of energies outside of [E_MIN, E_MAX)
+  static constexpr size_t NO_BIN = NBINS;
+  // Number of entries in the table
+  static constexpr size_t TABLE_SIZE = NBINS + 1;
+
+  LogHash() : storage_(), lower_(nullptr) {}
+  explicit LogHash(ArrayView<double> grid);
+  // Hash using a table of TABLE_SIZE entries built for the same bins, which
+  // is kept alive by storage
+  LogHash(const uint32_t* table, std::shared_ptr<const void> storage)
+      : storage_(std::move(storage)), lower_(table) {}
+
+  static size_t bin(double E) {
+    double x = (std::log(E) - LOG_E_MIN) * INV_WIDTH;
+    if (!(x >= 0.) || x >= static_cast<double>(NBINS)) return NO_BIN;
+    return static_cast<size_t>(x);
+  }
+
+  // Index i of the interval [grid[i], grid[i+1]] containing E, where grid
+  // is the one the hash was built for, and bin = bin(E). Energies outside
+  // of the grid are given the interval at the nearest end.
+  size_t index(ArrayView<double> grid, double E, size_t bin) const {
+    if (E <= grid.front()) return 0;
+    if (E >= grid.back()) return grid.size() - 2;
+    auto first = grid.begin();
+    auto last = grid.end();
+    if (bin != NO_BIN) {
+      first += lower_[bin];
+      last = grid.begin() + lower_[bin + 1] + 2;
+    }
+    return static_cast<size_t>(std::upper_bound(first, last, E) -
+                               grid.begin()) -
+           1;
+  }
+  size_t index(ArrayView<double> grid, double E) const {
+    return index(grid, E, bin(E));
+  }
+
+  const uint32_t* table() const { return lower_; }
+  size_t memory() const {
+    return lower_ == nullptr ? 0 : TABLE_SIZE * sizeof(uint32_t);
+  }
+
+ private:
+  static const double LOG_E_MIN;
+  static const double INV_WIDTH;
+
+  // Interval of the grid holding the lower edge of each bin, and the upper
+  // edge of the last one
+  std::shared_ptr<const void> storage_;
+  const uint32_t* lower_;
+};
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_MATERIAL_H
+#define PAPILLON_MATERIAL_H
+
+#include <Papillon/materials/log_hash.hpp>
+#include <Papillon/materials/nuclide.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pmc {
+
+// Macroscopic cross sections of a material at one energy, in 1/cm
+struct MacroXS {
+  double total;
+  double elastic;
+  double capture;
+  double fission;
+  double nu_fission;
+};
+
+// How the energy grids of the nuclides of a material are searched. With
+// Nuclide, each nuclide searches its own grid through its LogHash, in the
+// bin found once for all of them, which adds nothing to the material. With Unionized, the material keeps the
+// union of the grids of its nuclides, with a LogHash, and the interval of
+// every nuclide's grid at each of its points, so that one search serves all
+// of the nuclides. Both give identical cross sections.
+enum class EnergyGridMode { Nuclide, Unionized };
+
+//============================================================================
+// Material
+// Homogeneous mixture of nuclides, each with an atom density in atoms per
+// barn-cm.
+class Material {
+ public:
+  Material(uint32_t id, const std::string& name = "");
+
+  void add_nuclide(std::shared_ptr<Nuclide> nuclide, double atom_density);
+
+  void set_grid_mode(EnergyGridMode mode);
+  EnergyGridMode grid_mode() const { return grid_mode_; }
+
+  MacroXS xs(double E) const;
+
+  // Index of the nuclide a neutron of energy E collides with, given xi in
+  // [0, 1), chosen with a probability proportional to its part of the total
+  // macroscopic cross section.
+  size_t sample_nuclide(double E, double xi) const;
+
+  uint32_t id() const { return id_; }
+  const std::string& name() const { return name_; }
+  size_t size() const { return components_.size(); }
+  const Nuclide& nuclide(size_t i) const { return *components_[i].nuclide; }
+  double atom_density(size_t i) const { return components_[i].atom_density; }
+
+  // Bytes used by the material, not counting its nuclides
+  size_t memory() const;
+  // Bytes used by the materials and by their distinct nuclides
+  static size_t memory(const std::vector<const Material*>& materials);
+
+ private:
+  struct Component {
+    std::shared_ptr<Nuclide> nuclide;
+    double atom_density;
+  };
+
+  uint32_t id_;
+  std::string name_;
+  std::vector<Component> components_;
+  EnergyGridMode grid_mode_;
+  // Unionized grid, and the interval of the grid of nuclide j which holds
+  // interval u of the union at union_index_[u * size() + j]
+  std::vector<double> union_energy_;
+  LogHash union_hash_;
+  std::vector<uint32_t> union_index_;
+
+  void build_unionized_grid();
+
+  // Calls f(j, xs) with the microscopic cross sections of each nuclide j
+  template <class F>
+  void for_each_nuclide(double E, F f) const {
+    if (grid_mode_ == EnergyGridMode::Unionized && !union_energy_.empty()) {
+      size_t u = union_hash_.index(union_energy_, E);
+      const uint32_t* index = union_index_.data() + u * components_.size();
+      for (size_t j = 0; j < components_.size(); j++)
+        f(j, components_[j].nuclide->xs(index[j], E));
+    } else {
+      size_t bin = LogHash::bin(E);
+      for (size_t j = 0; j < components_.size(); j++) {
+        const Nuclide& nuclide = *components_[j].nuclide;
+        f(j, nuclide.xs(nuclide.grid_index(E, bin), E));
+      }
+    }
+  }
+};
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_NUCLEAR_DATA_LIBRARY_H
+#define PAPILLON_NUCLEAR_DATA_LIBRARY_H
+
+#include <Papillon/materials/nuclide.hpp>
+#include <Papillon/utils/mapped_file.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// NuclearDataLibrary
+// Binary library of nuclides, read through a memory mapping, so that
+// opening it only reads its index, and processes on one node share the
+// pages of the tables. The file is little-endian and made of
+//
+//   header   64 bytes: magic "PMCNDL\0\0", major and minor version, endian
+//            mark 0x01020304, number of nuclides, file size, FNV-1a
+//            checksum of the whole file, taken with this field zeroed, and
+//            the LogHash bins the hashes were built for
+//   index    64 bytes per nuclide: name (at most 31 characters, NUL
+//            padded), AWR, nu, number of grid points, flags (bit 0 set for
+//            fissile nuclides), and offset of the tables
+//   tables   per nuclide: energy, total, elastic, capture and fission, as
+//            doubles, then the LogHash table as uint32
+//
+// where every table starts on a 64 byte boundary. Readers accept any minor
+// version of their major version. When the hash bins of the file differ
+// from those of LogHash, the hashes are rebuilt when nuclides are loaded.
+// Loading a nuclide checks that its energy grid is sorted and that its
+// hash points into the grid, but does not read its cross sections, whose
+// pages are only read when they are first used.
+class NuclearDataLibrary {
+ public:
+  static constexpr uint32_t VERSION_MAJOR = 2;
+  static constexpr uint32_t VERSION_MINOR = 0;
+  static constexpr size_t ALIGNMENT = 64;
+  static constexpr size_t MAX_NAME_LENGTH = 31;
+  static constexpr uint32_t FLAG_FISSILE = 1;
+
+  // Maps the library in fname and checks its header and index. With
+  // verify, the checksum is checked as well, which reads the whole file.
+  explicit NuclearDataLibrary(const std::string& fname, bool verify = false);
+
+  size_t size() const { return entries_.size(); }
+  const std::vector<std::string>& names() const { return names_; }
+  bool has_nuclide(const std::string& name) const {
+    return index_.find(name) != index_.end();
+  }
+  // Nuclide viewing its tables in the mapped file, which stays mapped for
+  // as long as the nuclide exists
+  std::shared_ptr<Nuclide> nuclide(const std::string& name) const;
+
+  // Checksum stored in the header, and that of the mapped file
+  uint64_t stored_checksum() const;
+  uint64_t computed_checksum() const;
+  bool verify() const { return stored_checksum() == computed_checksum(); }
+
+  // Writes the nuclides to a library in fname
+  static void write(const std::string& fname,
+                    const std::vector<std::shared_ptr<const Nuclide>>& nuclides);
+  // 64 bit FNV-1a hash of the bytes, continuing from hash
+  static uint64_t checksum(const unsigned char* data, size_t size,
+                           uint64_t hash = 0xcbf29ce484222325);
+
+ private:
+  struct Entry {
+    double awr;
+    double nu;
+    uint32_t npoints;
+    uint32_t flags;
+    uint64_t offset;
+  };
+
+  std::shared_ptr<const MappedFile> file_;
+  std::vector<std::string> names_;
+  std::vector<Entry> entries_;
+  std::unordered_map<std::string, size_t> index_;
+  bool same_hash_;
+};
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_NUCLIDE_H
+#define PAPILLON_NUCLIDE_H
+
+#include <Papillon/materials/log_hash.hpp>
+#include <Papillon/utils/array_view.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pmc {
+
+// Microscopic cross sections of a nuclide at one energy, in barns
+struct MicroXS {
+  double total;
+  double elastic;
+  double capture;
+  double fission;
+};
+
+//============================================================================
+// Nuclide
+// Continuous energy cross sections of a nuclide, tabulated on an energy grid
+// in MeV and interpolated linearly between the points. Outside of the grid,
+// the values at its ends are used. The reactions are elastic scattering off
+// of a target at rest, isotropic in the center of mass frame, radiative
+// capture, and fission producing nu neutrons. The grid is searched through
+// a LogHash. The tables are either owned by the nuclide, or viewed in
+// storage shared with others, such as a NuclearDataLibrary mapped in memory.
+class Nuclide {
+ public:
+  Nuclide(const std::string& name, double awr, std::vector<double> energy,
+          std::vector<double> elastic, std::vector<double> capture,
+          std::vector<double> fission, double nu);
+  // Nuclide viewing tables which were validated when they were written, and
+  // which are kept alive by storage. The total is the sum of the partial
+  // cross sections, and the hash was built for the energy grid. The tables
+  // are not read, so whether the nuclide is fissile must be given.
+  Nuclide(const std::string& name, double awr, double nu, bool fissile,
+          ArrayView<double> energy, ArrayView<double> total,
+          ArrayView<double> elastic, ArrayView<double> capture,
+          ArrayView<double> fission, LogHash hash,
+          std::shared_ptr<const void> storage);
+
+  MicroXS xs(double E) const { return xs(grid_index(E), E); }
+  // Cross sections at E, which lies in [energy(i), energy(i+1)]
+  MicroXS xs(size_t i, double E) const {
+    double f = (E - energy_[i]) / (energy_[i + 1] - energy_[i]);
+    if (f < 0.) f = 0.;
+    else if (f > 1.) f = 1.;
+    return {total_[i] + f * (total_[i + 1] - total_[i]),
+            elastic_[i] + f * (elastic_[i + 1] - elastic_[i]),
+            capture_[i] + f * (capture_[i + 1] - capture_[i]),
+            fission_[i] + f * (fission_[i + 1] - fission_[i])};
+  }
+
+  // Index i of the grid interval [energy(i), energy(i+1)] containing E
+  size_t grid_index(double E) const { return hash_.index(energy_, E); }
+  // Same, with bin = LogHash::bin(E)
+  size_t grid_index(double E, size_t bin) const {
+    return hash_.index(energy_, E, bin);
+  }
+
+  const std::string& name() const { return name_; }
+  // Ratio of the mass of the nuclide to the mass of a neutron
+  double awr() const { return awr_; }
+  double nu() const { return nu_; }
+  bool fissile() const { return fissile_; }
+  const LogHash& hash() const { return hash_; }
+  ArrayView<double> energy() const { return energy_; }
+  ArrayView<double> total() const { return total_; }
+  ArrayView<double> elastic() const { return elastic_; }
+  ArrayView<double> capture() const { return capture_; }
+  ArrayView<double> fission() const { return fission_; }
+  // Bytes used by the cross sections and the hash of the grid, whether they
+  // are owned or shared
+  size_t memory() const;
+
+ private:
+  std::string name_;
+  double awr_;
+  double nu_;
+  bool fissile_;
+  std::shared_ptr<const void> storage_;
+  ArrayView<double> energy_;
+  ArrayView<double> total_;
+  ArrayView<double> elastic_;
+  ArrayView<double> capture_;
+  ArrayView<double> fission_;
+  LogHash hash_;
+};
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_MATERIAL_TALLY_H
+#define PAPILLON_MATERIAL_TALLY_H
+
+#include <Papillon/tallies/tally.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// MaterialTally
+// Track-length estimate of the flux and of reaction rates in each of a set
+// of materials. The bin of score s in material m is m * scores.size() + s.
+class MaterialTally : public Tally {
+ public:
+  MaterialTally(const std::string& name,
+                const std::vector<const Material*>& materials,
+                const std::vector<TallyScore>& scores,
+                TallyAccumulation accumulation =
+                    TallyAccumulation::ThreadPrivate);
+
+  void score_flight(int thread, const Position& r, const Direction& u,
+                    double distance, const Material* material, double E,
+                    double weight) override;
+
+  size_t bin(const Material* material, size_t score) const {
+    return index_.at(material) * scores_.size() + score;
+  }
+  const std::vector<TallyScore>& scores() const { return scores_; }
+
+ private:
+  std::vector<TallyScore> scores_;
+  std::unordered_map<const Material*, size_t> index_;
+};
+
+}  // namespace pmc
+
+#endif
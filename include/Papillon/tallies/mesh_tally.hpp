@@ -0,0 +1,172 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_MESH_TALLY_H
+#define PAPILLON_MESH_TALLY_H
+
+#include <Papillon/tallies/tally.hpp>
+#include <Papillon/utils/constants.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// MeshTally
+// Track-length estimate of the flux and of reaction rates in the cells of
+// a regular mesh laid over the geometry, in its global frame. Each flight
+// is walked through the cells it crosses with the 3D DDA of Amanatides and
+// Woo (1987), without looking at the geometry, so that a flight costs
+// O(cells crossed) whatever the size of the mesh. The cells crossed are
+// gathered in a small buffer with their chord lengths, and the cross
+// sections of the flight are found once for all of them. The bin of score
+// s in cell (i, j, k) is ((k * ny + j) * nx + i) * scores.size() + s.
+class MeshTally : public Tally {
+ public:
+  MeshTally(const std::string& name, const Position& lower,
+            const Position& upper, uint32_t nx, uint32_t ny, uint32_t nz,
+            const std::vector<TallyScore>& scores,
+            TallyAccumulation accumulation = TallyAccumulation::ThreadPrivate);
+
+  void score_flight(int thread, const Position& r, const Direction& u,
+                    double distance, const Material* material, double E,
+                    double weight) override;
+
+  // Calls f(cell, length) for each cell crossed by the segment of length
+  // distance starting at r in direction u, in the order in which they are
+  // crossed, where cell is (k * ny + j) * nx + i
+  template <class F>
+  void walk(const Position& r, const Direction& u, double distance,
+            F&& f) const;
+
+  size_t bin(uint32_t i, uint32_t j, uint32_t k, size_t score) const {
+    return ((static_cast<size_t>(k) * shape_[1] + j) * shape_[0] + i) *
+               scores_.size() +
+           score;
+  }
+  const std::array<uint32_t, 3>& shape() const { return shape_; }
+  const std::vector<TallyScore>& scores() const { return scores_; }
+  // Volume of one cell
+  double cell_volume() const { return width_[0] * width_[1] * width_[2]; }
+
+ private:
+  std::array<double, 3> lower_;
+  std::array<double, 3> upper_;
+  std::array<uint32_t, 3> shape_;
+  std::array<double, 3> width_;
+  std::vector<TallyScore> scores_;
+};
+
+template <class F>
+void MeshTally::walk(const Position& r, const Direction& u, double distance,
+                     F&& f) const {
+  // Part of the segment inside of the mesh, from slabs on each axis
+  double t_in = 0.;
+  double t_out = distance;
+  for (int a = 0; a < 3; a++) {
+    if (u[a] == 0.) {
+      if (r[a] < lower_[a] || r[a] >= upper_[a]) return;
+      continue;
+    }
+    double t0 = (lower_[a] - r[a]) / u[a];
+    double t1 = (upper_[a] - r[a]) / u[a];
+    if (t0 > t1) std::swap(t0, t1);
+    t_in = std::max(t_in, t0);
+    t_out = std::min(t_out, t1);
+  }
+  if (!(t_in < t_out)) return;
+
+  // Cell holding the entry point, and the distances at which the segment
+  // crosses the next face on each axis, and between two faces
+  int64_t cell[3];
+  int step[3];
+  double t_max[3];
+  double t_delta[3];
+  for (int a = 0; a < 3; a++) {
+    double x = r[a] + u[a] * t_in;
+    int64_t c = static_cast<int64_t>(std::floor((x - lower_[a]) / width_[a]));
+    if (c < 0) c = 0;
+    if (c >= shape_[a]) c = shape_[a] - 1;
+    if (u[a] > 0.) {
+      step[a] = 1;
+      t_max[a] = (lower_[a] + (c + 1) * width_[a] - r[a]) / u[a];
+      // On a face, which rounding put in the cell behind it
+      if (t_max[a] <= t_in) {
+        c++;
+        t_max[a] += width_[a] / u[a];
+      }
+      t_delta[a] = width_[a] / u[a];
+    } else if (u[a] < 0.) {
+      step[a] = -1;
+      t_max[a] = (lower_[a] + c * width_[a] - r[a]) / u[a];
+      if (t_max[a] <= t_in) {
+        c--;
+        t_max[a] -= width_[a] / u[a];
+      }
+      t_delta[a] = -width_[a] / u[a];
+    } else {
+      step[a] = 0;
+      t_max[a] = INF;
+      t_delta[a] = INF;
+    }
+    if (c < 0 || c >= shape_[a]) return;
+    cell[a] = c;
+  }
+
+  double t = t_in;
+  while (true) {
+    int a = t_max[0] < t_max[1] ? (t_max[0] < t_max[2] ? 0 : 2)
+                                : (t_max[1] < t_max[2] ? 1 : 2);
+    double t_next = std::min(t_max[a], t_out);
+    if (t_next > t) {
+      f((static_cast<size_t>(cell[2]) * shape_[1] +
+         static_cast<size_t>(cell[1])) *
+                shape_[0] +
+            static_cast<size_t>(cell[0]),
+        t_next - t);
+    }
+    if (t_next >= t_out) return;
+
+    t = t_next;
+    cell[a] += step[a];
+    if (cell[a] < 0 || cell[a] >= shape_[a]) return;
+    t_max[a] += t_delta[a];
+  }
+}
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_TALLY_H
+#define PAPILLON_TALLY_H
+
+#include <Papillon/utils/direction.hpp>
+#include <Papillon/utils/vector.hpp>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pmc {
+
+class Material;
+
+// With ThreadPrivate, each thread scores into a copy of the bins of its
+// own, and the copies are summed at the end of the batch. With Sharded, the
+// threads share a few copies, which they add to atomically, for tallies
+// whose bins are too many to be copied for every thread.
+enum class TallyAccumulation { ThreadPrivate, Sharded };
+
+// Quantities which may be tallied, each the integral of the flux times a
+// macroscopic cross section, or of the flux alone
+enum class TallyScore { Flux, Total, Absorption, Fission, NuFission };
+
+//============================================================================
+// Tally
+// Bins scored by transport during a batch, and the statistics of their
+// values over the batches. Scores made during a batch go to buffers made of
+// whole cache lines, so that no two threads ever write to the same line.
+// When the batch ends, the buffers are summed into the value of each bin
+// for the batch, from which the mean and the variance over the batches are
+// updated in one pass (Welford), so that no value of a past batch is kept.
+// Sums of thread buffers depend on which thread ran which history, so
+// results only agree to round-off between runs on several threads.
+class Tally {
+ public:
+  // Most scores a tally of reaction rates may have
+  static constexpr size_t MAX_SCORES = 16;
+
+  Tally(const std::string& name, size_t nbins,
+        TallyAccumulation accumulation = TallyAccumulation::ThreadPrivate,
+        size_t nshards = 4);
+  virtual ~Tally() = default;
+
+  // Scores the segment of a flight of length distance, starting at r in
+  // direction u, at energy E, in material, which is nullptr in a void.
+  // Called by transport, from thread thread.
+  virtual void score_flight(int thread, const Position& r, const Direction& u,
+                            double distance, const Material* material,
+                            double E, double weight) = 0;
+
+  // Makes room for the scores of nthreads threads. Called by transport
+  // before its threads start. Scores already made in the batch are kept.
+  void prepare(int nthreads);
+
+  void score(int thread, size_t bin, double value) {
+    if (accumulation_ == TallyAccumulation::ThreadPrivate) {
+      buffers_[static_cast<size_t>(thread)][bin / LINE].value[bin % LINE] +=
+          value;
+    } else {
+      double& sum = buffers_[static_cast<size_t>(thread) % buffers_.size()]
+                            [bin / LINE].value[bin % LINE];
+#pragma omp atomic
+      sum += value;
+    }
+  }
+
+  // Ends a batch, whose value in each bin is the sum of its scores divided
+  // by normalization, typically the weight of the source of the batch
+  void end_batch(double normalization);
+
+  const std::string& name() const { return name_; }
+  size_t size() const { return nbins_; }
+  TallyAccumulation accumulation() const { return accumulation_; }
+  size_t batches() const { return batches_; }
+
+  double mean(size_t bin) const { return mean_[bin]; }
+  // Variance of the values of the batches
+  double variance(size_t bin) const {
+    return batches_ > 1 ? m2_[bin] / static_cast<double>(batches_ - 1) : 0.;
+  }
+  // Standard deviation of the mean
+  double std_error(size_t bin) const {
+    return batches_ > 1
+               ? std::sqrt(variance(bin) / static_cast<double>(batches_))
+               : 0.;
+  }
+  double relative_error(size_t bin) const {
+    return mean_[bin] != 0. ? std_error(bin) / std::abs(mean_[bin]) : 0.;
+  }
+  // 1 / (R^2 T), for a relative error R reached in a time T in seconds
+  double figure_of_merit(size_t bin, double seconds) const {
+    double r = relative_error(bin);
+    return r > 0. && seconds > 0. ? 1. / (r * r * seconds) : 0.;
+  }
+
+  // Bytes used by the scores and the statistics
+  size_t memory() const;
+
+ protected:
+  // Throws unless there are between 1 and MAX_SCORES scores
+  void check_scores(const std::vector<TallyScore>& scores) const;
+  // Cross section multiplying the flux for each of scores, in material at
+  // E, written to sigma. Reaction rates are zero in a void.
+  static void score_xs(const std::vector<TallyScore>& scores,
+                       const Material* material, double E, double* sigma);
+
+ private:
+  static constexpr size_t LINE = 8;
+  struct alignas(64) CacheLine {
+    double value[LINE];
+  };
+
+  std::string name_;
+  size_t nbins_;
+  TallyAccumulation accumulation_;
+  size_t nshards_;
+  size_t batches_;
+  // Buffers of the threads, or the shards
+  std::vector<std::vector<CacheLine>> buffers_;
+  std::vector<double> mean_;
+  // Sum of the squared deviations from the mean
+  std::vector<double> m2_;
+};
+
+}  // namespace pmc
+
+#endif
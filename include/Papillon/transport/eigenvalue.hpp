@@ -0,0 +1,187 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_EIGENVALUE_H
+#define PAPILLON_EIGENVALUE_H
+
+#include <Papillon/geometry/geometry.hpp>
+#include <Papillon/transport/entropy.hpp>
+#include <Papillon/transport/transport.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pmc {
+
+// Puts in out n sites of weight 1, chosen from sites with probabilities
+// proportional to their weights by systematic sampling. With W_i the weight
+// of the sites before site i and W that of all of them, site i is copied
+// into out[floor(n W_i / W + xi)] up to out[floor(n W_{i+1} / W + xi)],
+// where xi is in [0, 1). The W_i come from a prefix sum over blocks of a
+// fixed number of sites, so that they do not depend on the number of
+// threads, and the sites are then copied to their places in parallel.
+void resample_sites(const std::vector<SourceSite>& sites, size_t n, double xi,
+                    std::vector<SourceSite>& out, int threads = 0);
+
+// Estimates of k of one batch, or of a set of batches
+struct KeffEstimate {
+  double collision = 0.;
+  double absorption = 0.;
+  double track_length = 0.;
+};
+
+//============================================================================
+// KeffStatistics
+// Means and covariances of the estimators of k over the active batches. The
+// estimators are combined with weights which minimize the variance of the
+// combination, given their covariance matrix. The track-length estimator is
+// left out of the combination when delta tracking is used, as it does not
+// see the flights sampled against the majorant.
+class KeffStatistics {
+ public:
+  explicit KeffStatistics(bool track_length = true);
+
+  void add(const KeffEstimate& k);
+
+  size_t batches() const { return batches_; }
+  KeffEstimate mean() const;
+  KeffEstimate std_error() const;
+
+  // Combined estimate of k, and its standard error. Until the covariance
+  // matrix may be inverted, the mean of the estimators is given.
+  double combined() const;
+  double combined_std_error() const;
+
+ private:
+  static constexpr size_t NEST = 3;
+  bool track_length_;
+  size_t batches_;
+  std::array<double, NEST> mean_;
+  // Sums of the products of the deviations from the means
+  std::array<std::array<double, NEST>, NEST> comoment_;
+
+  size_t nestimators() const { return track_length_ ? NEST : NEST - 1; }
+  // Weights of the estimators in the combination, and the variance of the
+  // combined mean. Returns false if the covariance matrix is singular.
+  bool combination(std::array<double, NEST>& weights, double& variance) const;
+};
+
+struct EigenvalueSettings {
+  // Number of source sites of every batch
+  size_t particles = 10000;
+  // Batches run to converge the source, which are not scored. With an
+  // entropy window, this is the most that are run.
+  size_t inactive = 20;
+  // Batches whose estimates of k are kept, and in which tallies are scored
+  size_t active = 100;
+  // Guess of k, by which the number of fission neutrons of the first batch
+  // is divided
+  double keff = 1.;
+  // Mesh on which the Shannon entropy of the fission source of each batch
+  // is found, if any
+  std::shared_ptr<const EntropyMesh> entropy_mesh;
+  // If above zero, the inactive batches end early, once the entropy has
+  // stopped drifting over the last entropy_window batches: the means of the
+  // entropies of the two halves of the window differ by no more than twice
+  // the standard error of their difference, or than entropy_tolerance bits.
+  size_t entropy_window = 0;
+  double entropy_tolerance = 0.01;
+  // Fission neutrons are always banked, and the batch and keff are set for
+  // each batch
+  TransportSettings transport;
+};
+
+struct BatchResult {
+  uint64_t batch = 0;
+  bool active = false;
+  KeffEstimate k;
+  // Shannon entropy of the fission sites banked, in bits
+  double entropy = 0.;
+  TransportResult transport;
+};
+
+//============================================================================
+// PowerIteration
+// Solves a k-eigenvalue problem by power iteration. The fission neutrons of
+// each batch are banked, and resampled to the number of particles to be the
+// source of the next batch. The number of fission neutrons is divided by the
+// estimate of k of the batch before, so that the bank stays near the size of
+// the source. Every step of a batch runs in parallel.
+//
+// The entropy of the fission source comes from the weights counted on the
+// entropy mesh by each thread as it banks fission sites, which are summed
+// once the batch is over.
+class PowerIteration {
+ public:
+  PowerIteration(Geometry& geometry, std::vector<SourceSite> source,
+                 const EigenvalueSettings& settings);
+
+  // Runs the next batch, and makes the source of the one after it
+  BatchResult run_batch();
+  // Runs all the batches left
+  std::vector<BatchResult> run();
+
+  bool done() const;
+  uint64_t batch() const { return batch_; }
+  bool active() const { return batch_ >= inactive_; }
+  // Number of inactive batches, which may be fewer than asked for if the
+  // entropy stopped drifting early
+  size_t inactive() const { return inactive_; }
+  double keff() const { return keff_; }
+  const std::vector<SourceSite>& source() const { return source_; }
+  const KeffStatistics& statistics() const { return statistics_; }
+  // Entropy of the fission source of every batch run, which is empty
+  // without an entropy mesh
+  const std::vector<double>& entropy() const { return entropy_; }
+
+ private:
+  Geometry& geometry_;
+  EigenvalueSettings settings_;
+  std::vector<SourceSite> source_;
+  std::vector<SourceSite> fission_bank_;
+  double source_weight_;
+  uint64_t batch_;
+  double keff_;
+  size_t inactive_;
+  KeffStatistics statistics_;
+  std::vector<double> entropy_;
+
+  // Whether the entropy of the last batches has stopped drifting
+  bool entropy_converged() const;
+};
+
+}  // namespace pmc
+
+#endif
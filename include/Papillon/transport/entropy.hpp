@@ -0,0 +1,86 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_ENTROPY_H
+#define PAPILLON_ENTROPY_H
+
+#include <Papillon/utils/vector.hpp>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// EntropyMesh
+// Regular mesh laid over the geometry, in its global frame, on which the
+// Shannon entropy of the fission source is found. Transport adds the weight
+// of each fission site banked to the cell holding it, in counts kept by
+// each thread, so that the entropy of a batch costs no pass over its
+// sites. Cell (i, j, k) is (k * ny + j) * nx + i, as in MeshTally.
+class EntropyMesh {
+ public:
+  EntropyMesh(const Position& lower, const Position& upper, uint32_t nx,
+              uint32_t ny, uint32_t nz);
+
+  // Cell holding r, or size() if r is outside of the mesh
+  size_t cell(const Position& r) const {
+    size_t c[3];
+    for (int a = 0; a < 3; a++) {
+      double x = std::floor((r[a] - lower_[a]) * inv_width_[a]);
+      if (!(x >= 0. && x < shape_[a])) return size();
+      c[a] = static_cast<size_t>(x);
+    }
+    return (c[2] * shape_[1] + c[1]) * shape_[0] + c[0];
+  }
+
+  size_t size() const {
+    return static_cast<size_t>(shape_[0]) * shape_[1] * shape_[2];
+  }
+  const std::array<uint32_t, 3>& shape() const { return shape_; }
+
+  // Shannon entropy, in bits, of the fractions of the total weight in each
+  // cell, which is 0 if there is no weight at all
+  static double entropy(const std::vector<double>& weights);
+
+ private:
+  std::array<double, 3> lower_;
+  std::array<double, 3> inv_width_;
+  std::array<uint32_t, 3> shape_;
+};
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_MAJORANT_H
+#define PAPILLON_MAJORANT_H
+
+#include <Papillon/materials/material.hpp>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// Majorant
+// Upper bound on the total macroscopic cross section of a set of materials,
+// for delta tracking. Between two points of the union of the energy grids
+// of their nuclides, the cross section of every material is linear, so the
+// majorant is taken constant over each such interval, at the largest value
+// any of the materials has at either end of it.
+class Majorant {
+ public:
+  explicit Majorant(const std::vector<const Material*>& materials);
+
+  double xs(double E) const;
+
+  const std::vector<double>& energy() const { return energy_; }
+
+ private:
+  std::vector<double> energy_;
+  // Value of the majorant over [energy_[i], energy_[i+1]]
+  std::vector<double> xs_;
+};
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_PARTICLE_BANK_H
+#define PAPILLON_PARTICLE_BANK_H
+
+#include <Papillon/geometry/geo_navigator.hpp>
+#include <Papillon/materials/material.hpp>
+#include <Papillon/transport/transport.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pmc {
+
+//============================================================================
+// ParticleBank
+// Particles in flight in event-based transport, stored as a structure of
+// arrays so that each event kernel only streams through the fields it uses.
+// The position and direction of a particle are kept by its GeoNavigator,
+// along with the rest of its place in the geometry tree.
+struct ParticleBank {
+  explicit ParticleBank(size_t capacity);
+
+  // Replaces the particles in the bank by the n histories starting with
+  // sites[first]. Their storage is reused once the bank has held n
+  // particles.
+  void load(Geometry& geometry, const std::vector<SourceSite>& sites,
+            size_t first, size_t n, uint64_t seed, uint64_t batch);
+
+  size_t size() const { return energy.size(); }
+
+  // Finds the boundary of the volume of the node which each particle of
+  // queue is in. The particles are gathered by node, and the distances to
+  // each surface of a node are found for all of its particles at once with
+  // Surface::distance_batch.
+  void find_volume_boundaries(const std::vector<uint32_t>& queue);
+
+  std::vector<GeoNavigator> navigators;
+  std::vector<RNG> rngs;
+  std::vector<double> energy;
+  std::vector<double> weight;
+  // Material at the position of the particle, and its total and nu-fission
+  // cross sections at the energy of the particle
+  std::vector<const Material*> material;
+  std::vector<double> sigma_t;
+  std::vector<double> nu_fission;
+  // Unweighted distance travelled by the particle since its birth
+  std::vector<double> track_length;
+  // Distance to the boundary of the volume of the particle's node, and the
+  // index of its surface, from find_volume_boundaries. batched is 0 for the
+  // particles in a node whose volume is not an intersection of half-spaces,
+  // whose boundary must be found with GeoNavigator::find_next_boundary.
+  std::vector<double> boundary_distance;
+  std::vector<uint32_t> boundary_surface;
+  std::vector<uint8_t> batched;
+
+ private:
+  // Particles sorted by node, and the coordinates of the particles of one
+  // node in its frame, for find_volume_boundaries
+  std::vector<std::pair<const GeoNode*, uint32_t>> by_node_;
+  std::vector<double> x_, y_, z_, u_, v_, w_, d_, distance_;
+  std::vector<uint32_t> surface_;
+};
+
+}  // namespace pmc
+
+#endif
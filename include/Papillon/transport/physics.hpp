@@ -0,0 +1,79 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_PHYSICS_H
+#define PAPILLON_PHYSICS_H
+
+#include <Papillon/materials/material.hpp>
+#include <Papillon/utils/constants.hpp>
+#include <Papillon/utils/direction.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <cmath>
+
+namespace pmc {
+
+enum class CollisionType { Scatter, Capture, Fission };
+
+// Distance to the next collision in a medium of total macroscopic cross
+// section sigma_t, which is INF in a void. No random number is drawn in a
+// void.
+inline double sample_flight_distance(double sigma_t, RNG& rng) {
+  if (sigma_t <= 0.) return INF;
+  return -std::log(1. - rng()) / sigma_t;
+}
+
+// Direction at an angle of cosine mu to u, and at an azimuthal angle phi
+// around it
+Direction rotate_direction(const Direction& u, double mu, double phi);
+
+// Samples the nuclide and the reaction of a collision at energy E. After a
+// scatter, E and u are the energy and the direction of the outgoing neutron.
+CollisionType collide(const Material& material, double& E, Direction& u,
+                      RNG& rng);
+// Same, also giving the nuclide which was hit
+CollisionType collide(const Material& material, double& E, Direction& u,
+                      RNG& rng, const Nuclide*& target);
+
+// Energy in MeV of a neutron born in fission, from the Watt spectrum of
+// thermal fission in U235
+double sample_fission_energy(RNG& rng);
+
+// Number of neutrons born in a fission of a nuclide giving nu of them on
+// average, each of which is given the weight of the neutron which caused it
+inline int sample_fission_yield(double nu, RNG& rng) {
+  return static_cast<int>(nu + rng());
+}
+
+}  // namespace pmc
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_TRANSPORT_H
+#define PAPILLON_TRANSPORT_H
+
+#include <Papillon/geometry/geometry.hpp>
+#include <Papillon/tallies/tally.hpp>
+#include <Papillon/transport/entropy.hpp>
+#include <Papillon/transport/majorant.hpp>
+#include <Papillon/utils/direction.hpp>
+#include <Papillon/utils/vector.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pmc {
+
+// Starting point of a history
+struct SourceSite {
+  Position r;
+  Direction u;
+  double energy;  // MeV
+  double weight;
+};
+
+// History-based transport follows one particle from birth to death before
+// starting the next. Event-based transport keeps a bank of particles in
+// flight, and moves all of them through one kind of event at a time. The
+// distances to the surfaces bounding the particles are then found for all
+// of the particles in the same node at once, with Surface::distance_batch.
+enum class TransportMode { History, Event };
+
+// Surface tracking stops a flight at every boundary. Delta (Woodcock)
+// tracking samples flights against a majorant of the total cross section,
+// and only locates the particle at the end of each, where the collision is
+// real with the probability of the local total cross section over the
+// majorant. Only the boundary of the root node is ever looked for.
+enum class Tracking { Surface, Delta };
+
+// What becomes of the neutrons born in fission. They are either not
+// followed, followed as secondaries of the history which made them, as in
+// fixed source problems of multiplying media, or banked as the source of
+// another batch, as in k-eigenvalue problems.
+enum class FissionNeutrons { Ignore, Secondary, Bank };
+
+struct TransportSettings {
+  TransportMode mode = TransportMode::History;
+  Tracking tracking = Tracking::Surface;
+  uint64_t seed = 1;
+  // Random numbers are drawn from streams keyed by the batch, the history,
+  // and the event within the history
+  uint64_t batch = 0;
+  // Number of particles in flight at once, in event-based transport
+  size_t event_bank_size = 10000;
+  // In delta tracking, flights which start where the total cross section is
+  // below this fraction of the majorant use surface tracking instead, as
+  // most of their collisions would be virtual.
+  double delta_threshold = 0.1;
+  FissionNeutrons fission_neutrons = FissionNeutrons::Ignore;
+  // Fission gives nu / keff neutrons on average, so that a k-eigenvalue
+  // source keeps about the same size from one batch to the next
+  double keff = 1.;
+  // Number of threads, or 0 for as many as OpenMP allows. Without OpenMP,
+  // transport runs on the calling thread.
+  int threads = 0;
+  // Number of histories handed to a thread at once in history-based
+  // transport. Threads take event_bank_size histories at once in
+  // event-based transport.
+  size_t chunk_size = 64;
+  // Majorant for delta tracking. One is built from the materials of the
+  // geometry if none is given.
+  std::shared_ptr<const Majorant> majorant;
+  // Tallies scored along every flight, which need surface tracking. The
+  // caller ends their batches.
+  std::vector<std::shared_ptr<Tally>> tallies;
+  // Mesh on which the weight of the banked fission sites is counted
+  std::shared_ptr<const EntropyMesh> entropy_mesh;
+};
+
+// Counts of the events met by a set of histories, and their total track
+// length. Transporting the same sites with the same seed gives identical
+// results in either mode, and on any number of threads.
+struct TransportResult {
+  uint64_t histories = 0;
+  uint64_t secondaries = 0;
+  uint64_t collisions = 0;
+  uint64_t virtual_collisions = 0;
+  uint64_t crossings = 0;
+  uint64_t reflections = 0;
+  uint64_t leaks = 0;
+  uint64_t captures = 0;
+  uint64_t fissions = 0;
+  uint64_t cutoffs = 0;
+  uint64_t lost = 0;
+  double track_length = 0.;  // Weighted, in cm
+  // Weighted sums of the collision, absorption and track-length estimators
+  // of the neutrons born in fission. Divided by the weight of the source,
+  // they estimate k. Delta-tracked flights add nothing to the track-length
+  // estimator.
+  double k_collision = 0.;
+  double k_absorption = 0.;
+  double k_track_length = 0.;
+  // Weight of the fission sites banked in each cell of the entropy mesh,
+  // which is empty without one. Sites outside of the mesh are not counted.
+  std::vector<double> source_mesh;
+
+  TransportResult& operator+=(const TransportResult& other);
+};
+
+// Transports each site to its death. The history of sites[i] draws its
+// random numbers from RNG(settings.seed, settings.batch, i), starting the
+// stream of a new event at every flight. Its secondaries continue the same
+// stream. Its results are thus the same whatever the order in which the
+// histories and their events are run, and whatever thread runs them.
+//
+// Histories are handed out to threads in chunks, as threads become free.
+// Each thread banks fission neutrons and secondaries in banks of its own,
+// and the fission banks are merged at the end. When fission neutrons are
+// banked, they are put in fission_bank, which is cleared first. The sites
+// of history i come before those of history i+1, in the order in which they
+// were made.
+TransportResult transport(Geometry& geometry,
+                          const std::vector<SourceSite>& sites,
+                          const TransportSettings& settings);
+TransportResult transport(Geometry& geometry,
+                          const std::vector<SourceSite>& sites,
+                          const TransportSettings& settings,
+                          std::vector<SourceSite>& fission_bank);
+
+TransportResult transport_histories(Geometry& geometry,
+                                    const std::vector<SourceSite>& sites,
+                                    const TransportSettings& settings);
+TransportResult transport_histories(Geometry& geometry,
+                                    const std::vector<SourceSite>& sites,
+                                    const TransportSettings& settings,
+                                    std::vector<SourceSite>& fission_bank);
+
+// Only surface tracking is done event by event, and fission neutrons may
+// not be followed as secondaries
+TransportResult transport_events(Geometry& geometry,
+                                 const std::vector<SourceSite>& sites,
+                                 const TransportSettings& settings);
+TransportResult transport_events(Geometry& geometry,
+                                 const std::vector<SourceSite>& sites,
+                                 const TransportSettings& settings,
+                                 std::vector<SourceSite>& fission_bank);
+
+}  // namespace pmc
+
+#endif
@@ -79,16 +79,17 @@ namespace pmc {
             return z_;
             break; 
           default:
-            std::string mssg = "index of " + std::to_string(i);
-            mssg += " out of range.";
-            throw PMCException(mssg, __FILE__, __LINE__);
-            break;
+            index_out_of_range(i, __FILE__, __LINE__);
         } 
       }
 
     protected:
       friend class Transformation;
       double x_, y_, z_;
+
+      // Throws the exception for a bad index. It is defined out of line, so
+      // that operator[] does not carry the code which builds the message.
+      [[noreturn]] static void index_out_of_range(size_t i, const char* file, int line);
   };
 
   //============================================================================
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_AABB_H
+#define PAPILLON_AABB_H
+
+#include <Papillon/utils/transformation.hpp>
+#include <Papillon/utils/constants.hpp>
+
+namespace pmc {
+
+  // Axis-aligned bounding box. A bound of INF (or -INF for a lower bound)
+  // means that the box is unbounded along that side. Boxes are used as
+  // conservative estimates of the extent of volumes, so all tests are
+  // inclusive of the box faces.
+  class AABB {
+    public:
+      // The default box is infinite, and contains every point.
+      AABB(): lower_(-INF, -INF, -INF), upper_(INF, INF, INF) {}
+      AABB(const Position& lower, const Position& upper): lower_(lower), upper_(upper) {}
+      ~AABB() = default;
+
+      const Position& lower() const {return lower_;}
+      const Position& upper() const {return upper_;}
+
+      bool is_bounded() const {
+        for(size_t i = 0; i < 3; i++) {
+          if(lower_[i] == -INF || upper_[i] == INF) return false;
+        }
+        return true;
+      }
+
+      bool is_empty() const {
+        return lower_.x() > upper_.x() || lower_.y() > upper_.y() || lower_.z() > upper_.z();
+      }
+
+      bool contains(const Position& r) const {
+        return r.x() >= lower_.x() && r.x() <= upper_.x() &&
+               r.y() >= lower_.y() && r.y() <= upper_.y() &&
+               r.z() >= lower_.z() && r.z() <= upper_.z();
+      }
+
+      // Slab test. Returns the distance along the ray to the point where it
+      // enters the box, 0 if r is inside the box, or INF if the ray never
+      // passes through the box.
+      double distance(const Position& r, const Direction& u) const {
+        double t_enter = 0.;
+        double t_exit = INF;
+        for(size_t i = 0; i < 3; i++) {
+          double lo = lower_[i];
+          double hi = upper_[i];
+          double ri = r[i];
+          double ui = u[i];
+
+          if(ui == 0.) {
+            if(ri < lo || ri > hi) return INF;
+            continue;
+          }
+
+          double near = ui > 0. ? lo : hi;
+          double far = ui > 0. ? hi : lo;
+          if(near != -INF && near != INF) {
+            double t = (near - ri) / ui;
+            if(t > t_enter) t_enter = t;
+          }
+          if(far != -INF && far != INF) {
+            double t = (far - ri) / ui;
+            if(t < t_exit) t_exit = t;
+          }
+          if(t_enter > t_exit) return INF;
+        }
+        // A ray which only touches the box, or which sits on a face and
+        // leaves the box, never enters it.
+        if(t_enter >= t_exit) return INF;
+        return t_enter;
+      }
+
+      // Returns a copy of the box, grown by eps on every bounded side.
+      AABB padded(double eps) const;
+
+      // Returns a box containing the image of this box under T.
+      AABB transformed(const Transformation& T) const;
+
+      static AABB bounding_union(const AABB& a, const AABB& b);
+      static AABB intersection(const AABB& a, const AABB& b);
+
+    private:
+      Position lower_;
+      Position upper_;
+  };
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_ARRAY_VIEW_H
+#define PAPILLON_ARRAY_VIEW_H
+
+#include <cstddef>
+#include <vector>
+
+namespace pmc {
+
+  //============================================================================
+  // ArrayView
+  // Read-only view of a contiguous array owned by someone else, such as a
+  // std::vector or a memory mapped file. The view does not keep the array
+  // alive.
+  template <class T>
+  class ArrayView {
+    public:
+      ArrayView() : data_(nullptr), size_(0) {}
+      ArrayView(const T* data, size_t size) : data_(data), size_(size) {}
+      ArrayView(const std::vector<T>& v) : data_(v.data()), size_(v.size()) {}
+
+      const T& operator[](size_t i) const { return data_[i]; }
+      const T& front() const { return data_[0]; }
+      const T& back() const { return data_[size_ - 1]; }
+      const T* begin() const { return data_; }
+      const T* end() const { return data_ + size_; }
+      const T* data() const { return data_; }
+      size_t size() const { return size_; }
+      bool empty() const { return size_ == 0; }
+
+    private:
+      const T* data_;
+      size_t size_;
+  };
+
+}
+
+#endif
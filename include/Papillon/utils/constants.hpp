@@ -63,6 +63,7 @@ namespace pmc {
   //============================================================================
   // Program Parameters
   extern const double SURFACE_COINCIDENT;
+  extern const double ENERGY_CUTOFF; // MeV, below which neutrons are killed
 
 }
 
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#ifndef PAPILLON_RNG_H
+#define PAPILLON_RNG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pmc {
+
+//============================================================================
+// RNG
+// Counter-based generator, using the Philox4x64-10 bijection of Salmon et
+// al. (2011). The key is made of the seed and the batch, and the counter of
+// the history, the event of the history, and the block of the event, each
+// block giving BLOCK random numbers. A random number is thus a function of
+// (seed, batch, history, event, position) alone, so that results do not
+// depend on how histories or events are scheduled, and any number can be
+// reached in O(1).
+class RNG {
+ public:
+  static constexpr size_t BLOCK = 4;
+  using Block = std::array<uint64_t, BLOCK>;
+
+  RNG(uint64_t seed, uint64_t batch = 0, uint64_t history = 0)
+      : key_{seed, batch}, counter_{history, 0, 0, 0}, buffer_(),
+        position_(BLOCK) {}
+  ~RNG() = default;
+
+  // Random number in [0, 1). Only the top 53 bits of a word are used, so
+  // that the result is never rounded up to 1.
+  double operator()() {
+    if (position_ == BLOCK) refill();
+    return to_double(buffer_[position_++]);
+  }
+
+  // Starts drawing from the stream of the given event of the history
+  void set_event(uint64_t event) {
+    counter_[1] = event;
+    counter_[2] = 0;
+    position_ = BLOCK;
+  }
+  void next_event() { set_event(counter_[1] + 1); }
+
+  // Moves each of the generators rngs[indices[i]], for i < n, to its
+  // next event, and generates the first blocks of their new streams two
+  // at a time, so that the rounds of one overlap with those of the other.
+  static void next_event(RNG* rngs, const uint32_t* indices, size_t n);
+
+  // Skips over the next n random numbers of the event
+  void advance(uint64_t n) {
+    uint64_t p = counter_[2] * BLOCK + position_ - BLOCK + n;
+    counter_[2] = p / BLOCK;
+    position_ = BLOCK;
+    if (p % BLOCK != 0) {
+      refill();
+      position_ = p % BLOCK;
+    }
+  }
+
+  // Writes the next n random numbers of the event to out. Whole blocks
+  // are generated straight into out, two at a time.
+  void fill(double* out, size_t n);
+
+  uint64_t seed() const { return key_[0]; }
+  uint64_t batch() const { return key_[1]; }
+  uint64_t history() const { return counter_[0]; }
+  uint64_t event() const { return counter_[1]; }
+
+  // The Philox4x64-10 bijection
+  static Block philox(Block counter, std::array<uint64_t, 2> key) {
+    for (int round = 0; round < 10; round++) {
+      if (round > 0) {
+        key[0] += W0;
+        key[1] += W1;
+      }
+      __uint128_t p0 = static_cast<__uint128_t>(M0) * counter[0];
+      __uint128_t p1 = static_cast<__uint128_t>(M1) * counter[2];
+      counter = {static_cast<uint64_t>(p1 >> 64) ^ counter[1] ^ key[0],
+                 static_cast<uint64_t>(p1),
+                 static_cast<uint64_t>(p0 >> 64) ^ counter[3] ^ key[1],
+                 static_cast<uint64_t>(p0)};
+    }
+    return counter;
+  }
+
+  static double to_double(uint64_t x) {
+    return static_cast<double>(x >> 11) * NORM;
+  }
+
+ private:
+  static constexpr uint64_t M0 = 0xD2E7470EE14C6C93ULL;
+  static constexpr uint64_t M1 = 0xCA5A826395121157ULL;
+  static constexpr uint64_t W0 = 0x9E3779B97F4A7C15ULL;
+  static constexpr uint64_t W1 = 0xBB67AE8584CAA73BULL;
+  static constexpr double NORM = 1. / static_cast<double>(1ULL << 53);
+
+  std::array<uint64_t, 2> key_;
+  // History, event, and next block of the event
+  Block counter_;
+  Block buffer_;
+  size_t position_;
+
+  void refill() {
+    buffer_ = philox(counter_, key_);
+    counter_[2]++;
+    position_ = 0;
+  }
+};
+
+}  // namespace pmc
+
+#endif
@@ -36,12 +36,18 @@
 
 #include <Papillon/utils/direction.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 
 namespace pmc {
 
   class Transformation {
     public:
+      // Kind of the transformation, from cheapest to most expensive to
+      // apply. Each kind includes all of the kinds before it.
+      enum class Kind : uint8_t {Identity, Translation, RotationTranslation, General};
+
       Transformation();
       ~Transformation() = default;
 
@@ -55,49 +61,97 @@ namespace pmc {
       static Transformation scale_y(double s);
       static Transformation scale_z(double s);
 
-      std::array<double,4>& operator[](size_t i) {return data_[i];}
       const std::array<double,4>& operator[](size_t i) const {return data_[i];}
 
-      Transformation inverse() const {
-        double a = data_[0][0]; double b = data_[0][1]; double c = data_[0][2];
-        double d = data_[1][0]; double e = data_[1][1]; double f = data_[1][2];
-        double g = data_[2][0]; double h = data_[2][1]; double i = data_[2][2];
-
-        double A = e*i - f*h; double B = -(d*i - f*g); double C = d*h - e*g;
-        double D = -(b*i - c*h); double E = a*i - c*g; double F = -(a*h - b*g);
-        double G = b*f - c*e; double H = -(a*f - c*d); double I = a*e - b*d;
+      // Sets the element in row i and column j. Writing to an element can
+      // turn the transformation into anything, so the kind falls back to
+      // General.
+      void set(size_t i, size_t j, double value) {
+        data_[i][j] = value;
+        kind_ = Kind::General;
+      }
 
-        // Calculate determinant of the 3x3 matrix in upper left
-        double det = a*A + b*B + c*C;
+      Kind kind() const {return kind_;}
 
+      Transformation inverse() const {
         Transformation out;
-        // Construct inverse of 3x3 matrix in upper left
-        out[0][0] = (1./det)*A; out[0][1] = (1./det)*D; out[0][2] = (1./det)*G;
-        out[1][0] = (1./det)*B; out[1][1] = (1./det)*E; out[1][2] = (1./det)*H; 
-        out[2][0] = (1./det)*C; out[2][1] = (1./det)*F; out[2][2] = (1./det)*I;
+        switch(kind_) {
+          case Kind::Identity:
+            return out;
+
+          case Kind::Translation:
+            out.data_[0][3] = -data_[0][3];
+            out.data_[1][3] = -data_[1][3];
+            out.data_[2][3] = -data_[2][3];
+            out.kind_ = Kind::Translation;
+            return out;
+
+          case Kind::RotationTranslation:
+            // Inverse of a rotation is its transpose
+            for(size_t i = 0; i < 3; i++) {
+              for(size_t j = 0; j < 3; j++) out.data_[i][j] = data_[j][i];
+            }
+            break;
+
+          case Kind::General: {
+            double a = data_[0][0]; double b = data_[0][1]; double c = data_[0][2];
+            double d = data_[1][0]; double e = data_[1][1]; double f = data_[1][2];
+            double g = data_[2][0]; double h = data_[2][1]; double i = data_[2][2];
+
+            double A = e*i - f*h; double B = -(d*i - f*g); double C = d*h - e*g;
+            double D = -(b*i - c*h); double E = a*i - c*g; double F = -(a*h - b*g);
+            double G = b*f - c*e; double H = -(a*f - c*d); double I = a*e - b*d;
+
+            // Calculate determinant of the 3x3 matrix in upper left
+            double det = a*A + b*B + c*C;
+
+            // Construct inverse of 3x3 matrix in upper left
+            out.data_[0][0] = (1./det)*A; out.data_[0][1] = (1./det)*D; out.data_[0][2] = (1./det)*G;
+            out.data_[1][0] = (1./det)*B; out.data_[1][1] = (1./det)*E; out.data_[1][2] = (1./det)*H;
+            out.data_[2][0] = (1./det)*C; out.data_[2][1] = (1./det)*F; out.data_[2][2] = (1./det)*I;
+            break;
+          }
+        }
 
         // Inverse portion for translation vector.
         //Uses previously defined inverse.
-        out[0][3] = -(out[0][0]*data_[0][3]+out[0][1]*data_[1][3]+out[0][2]*data_[2][3]);
-        out[1][3] = -(out[1][0]*data_[0][3]+out[1][1]*data_[1][3]+out[1][2]*data_[2][3]);
-        out[2][3] = -(out[2][0]*data_[0][3]+out[2][1]*data_[1][3]+out[2][2]*data_[2][3]);
+        out.data_[0][3] = -(out.data_[0][0]*data_[0][3]+out.data_[0][1]*data_[1][3]+out.data_[0][2]*data_[2][3]);
+        out.data_[1][3] = -(out.data_[1][0]*data_[0][3]+out.data_[1][1]*data_[1][3]+out.data_[1][2]*data_[2][3]);
+        out.data_[2][3] = -(out.data_[2][0]*data_[0][3]+out.data_[2][1]*data_[1][3]+out.data_[2][2]*data_[2][3]);
+        out.kind_ = kind_;
 
         return out;
       }
 
     private:
       std::array<std::array<double,4>,3> data_;
+      Kind kind_;
+
+      friend Transformation operator*(const Transformation& A, const Transformation& B);
   };
 
   inline Vector operator*(const Transformation& T, const Vector& v) {
-    double x = T[0][0]*v.x() + T[0][1]*v.y() + T[0][2]*v.z() + T[0][3];
-    double y = T[1][0]*v.x() + T[1][1]*v.y() + T[1][2]*v.z() + T[1][3];
-    double z = T[2][0]*v.x() + T[2][1]*v.y() + T[2][2]*v.z() + T[2][3];
+    switch(T.kind()) {
+      case Transformation::Kind::Identity:
+        return v;
 
-    return Vector(x,y,z);
+      case Transformation::Kind::Translation:
+        return Vector(v.x() + T[0][3], v.y() + T[1][3], v.z() + T[2][3]);
+
+      default: {
+        double x = T[0][0]*v.x() + T[0][1]*v.y() + T[0][2]*v.z() + T[0][3];
+        double y = T[1][0]*v.x() + T[1][1]*v.y() + T[1][2]*v.z() + T[1][3];
+        double z = T[2][0]*v.x() + T[2][1]*v.y() + T[2][2]*v.z() + T[2][3];
+
+        return Vector(x,y,z);
+      }
+    }
   }
 
   inline Direction operator*(const Transformation& T, const Direction& v) {
+    // Translations leave directions untouched
+    if(T.kind() <= Transformation::Kind::Translation) return v;
+
     double x = T[0][0]*v.x() + T[0][1]*v.y() + T[0][2]*v.z();
     double y = T[1][0]*v.x() + T[1][1]*v.y() + T[1][2]*v.z();
     double z = T[2][0]*v.x() + T[2][1]*v.y() + T[2][2]*v.z();
@@ -109,18 +163,21 @@ namespace pmc {
     Transformation out;
 
     // Zero diagonals
-    for(size_t i = 0; i < 3; i++) out[i][i] = 0.;
+    for(size_t i = 0; i < 3; i++) out.data_[i][i] = 0.;
 
     // Do multiplication
     for(size_t i = 0; i < 3; i++) {
       for(size_t j = 0; j < 4; j++) {
         for(size_t k = 0; k < 3; k++) {
-          out[i][j] += A[i][k]*B[k][j];
+          out.data_[i][j] += A[i][k]*B[k][j];
         }
-        if(j == 3) out[i][j] += A[i][j];
+        if(j == 3) out.data_[i][j] += A[i][j];
       }
     }
 
+    // Composing two transformations gives the more general of their kinds
+    out.kind_ = std::max(A.kind_, B.kind_);
+
     return out;
   }
 
@@ -59,10 +59,7 @@ namespace pmc {
             return z_;
             break; 
           default:
-            std::string mssg = "index of " + std::to_string(i);
-            mssg += " out of range.";
-            throw PMCException(mssg, __FILE__, __LINE__);
-            break;
+            index_out_of_range(i, __FILE__, __LINE__);
         } 
       }
 
@@ -7,14 +7,20 @@ set(PAPILLON_SOURCE_FILES ${PAPILLON_SOURCE_FILES}
   #src/plotter_3d.cpp
   #src/geo_plotter.cpp
   # Geometry
-  #src/geo_node.cpp
-  #src/geometry.cpp
+  src/bvh.cpp
+  src/geo_node.cpp
+  src/rect_lattice.cpp
+  src/hex_lattice.cpp
+  src/geometry.cpp
   # CSG
+  src/compiled_volume.cpp
+  src/ray.cpp
   src/intersection.cpp
   src/difference.cpp
   src/union.cpp
   src/half_space.cpp
   # Surfaces
+  src/surface_table.cpp
   src/sphere.cpp
   src/zcylinder.cpp
   src/ycylinder.cpp
@@ -23,7 +29,27 @@ set(PAPILLON_SOURCE_FILES ${PAPILLON_SOURCE_FILES}
   src/zplane.cpp
   src/yplane.cpp
   src/xplane.cpp
+  # Materials
+  src/log_hash.cpp
+  src/nuclide.cpp
+  src/material.cpp
+  src/nuclear_data_library.cpp
+  # Transport
+  src/majorant.cpp
+  src/physics.cpp
+  src/particle_bank.cpp
+  src/transport.cpp
+  src/entropy.cpp
+  src/eigenvalue.cpp
+  # Tallies
+  src/tally.cpp
+  src/material_tally.cpp
+  src/mesh_tally.cpp
   # Utils
+  src/_vector_base_.cpp
+  src/aabb.cpp
   src/constants.cpp
+  src/mapped_file.cpp
+  src/rng.cpp
   src/transformation.cpp
 )
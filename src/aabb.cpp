@@ -0,0 +1,97 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/utils/aabb.hpp>
+
+#include <algorithm>
+
+namespace pmc {
+
+  AABB AABB::padded(double eps) const {
+    Position lo = lower_;
+    Position hi = upper_;
+    for(size_t i = 0; i < 3; i++) {
+      if(lo[i] != -INF) lo[i] -= eps;
+      if(hi[i] != INF) hi[i] += eps;
+    }
+    return AABB(lo, hi);
+  }
+
+  AABB AABB::transformed(const Transformation& T) const {
+    // Interval arithmetic on each row of T. An output axis is unbounded if
+    // it depends on any unbounded input axis.
+    Position lo, hi;
+    for(size_t i = 0; i < 3; i++) {
+      double l = T[i][3];
+      double h = T[i][3];
+      bool unbounded_lo = false;
+      bool unbounded_hi = false;
+      for(size_t j = 0; j < 3; j++) {
+        double t = T[i][j];
+        if(t == 0.) continue;
+
+        double in_lo = lower_[j];
+        double in_hi = upper_[j];
+        if(t < 0.) std::swap(in_lo, in_hi);
+
+        if(in_lo == -INF || in_lo == INF) unbounded_lo = true;
+        else l += t*in_lo;
+
+        if(in_hi == INF || in_hi == -INF) unbounded_hi = true;
+        else h += t*in_hi;
+      }
+      lo[i] = unbounded_lo ? -INF : l;
+      hi[i] = unbounded_hi ? INF : h;
+    }
+    return AABB(lo, hi);
+  }
+
+  AABB AABB::bounding_union(const AABB& a, const AABB& b) {
+    Position lo, hi;
+    for(size_t i = 0; i < 3; i++) {
+      lo[i] = std::min(a.lower_[i], b.lower_[i]);
+      hi[i] = std::max(a.upper_[i], b.upper_[i]);
+    }
+    return AABB(lo, hi);
+  }
+
+  AABB AABB::intersection(const AABB& a, const AABB& b) {
+    Position lo, hi;
+    for(size_t i = 0; i < 3; i++) {
+      lo[i] = std::max(a.lower_[i], b.lower_[i]);
+      hi[i] = std::min(a.upper_[i], b.upper_[i]);
+    }
+    return AABB(lo, hi);
+  }
+
+}
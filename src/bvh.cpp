@@ -0,0 +1,89 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/geometry/bvh.hpp>
+#include <algorithm>
+
+namespace pmc {
+
+BVH::BVH(const std::vector<AABB>& boxes) : nodes_(), prims_(), unbounded_() {
+  std::vector<Position> centroids(boxes.size());
+  for (uint32_t i = 0; i < boxes.size(); i++) {
+    if (boxes[i].is_bounded()) {
+      prims_.push_back(i);
+      centroids[i] = 0.5 * (boxes[i].lower() + boxes[i].upper());
+    } else {
+      unbounded_.push_back(i);
+    }
+  }
+
+  if (prims_.empty()) return;
+  nodes_.reserve(2 * prims_.size() / LEAF_SIZE + 1);
+  build(boxes, centroids, 0, static_cast<uint32_t>(prims_.size()));
+}
+
+void BVH::build(const std::vector<AABB>& boxes,
+                const std::vector<Position>& centroids, uint32_t begin,
+                uint32_t end) {
+  uint32_t indx = static_cast<uint32_t>(nodes_.size());
+  nodes_.push_back({boxes[prims_[begin]], begin, end - begin});
+
+  AABB cbox(centroids[prims_[begin]], centroids[prims_[begin]]);
+  for (uint32_t p = begin + 1; p < end; p++) {
+    nodes_[indx].box = AABB::bounding_union(nodes_[indx].box, boxes[prims_[p]]);
+    cbox = AABB::bounding_union(cbox, AABB(centroids[prims_[p]], centroids[prims_[p]]));
+  }
+
+  if (end - begin <= LEAF_SIZE) return;
+
+  // Split at the median centroid along the axis of largest spread
+  size_t axis = 0;
+  Position extent = cbox.upper() - cbox.lower();
+  if (extent.y() > extent[axis]) axis = 1;
+  if (extent.z() > extent[axis]) axis = 2;
+
+  uint32_t mid = begin + (end - begin) / 2;
+  std::nth_element(prims_.begin() + begin, prims_.begin() + mid,
+                   prims_.begin() + end, [&](uint32_t a, uint32_t b) {
+                     return centroids[a][axis] < centroids[b][axis];
+                   });
+
+  build(boxes, centroids, begin, mid);
+  uint32_t right = static_cast<uint32_t>(nodes_.size());
+  build(boxes, centroids, mid, end);
+
+  nodes_[indx].first = right;
+  nodes_[indx].count = 0;
+}
+
+}  // namespace pmc
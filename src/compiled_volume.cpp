@@ -0,0 +1,93 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/geometry/csg/compiled_volume.hpp>
+#include <Papillon/geometry/csg/difference.hpp>
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/csg/union.hpp>
+
+#include <string>
+
+namespace pmc {
+
+CompiledVolume::CompiledVolume(const Volume& volume, const SurfaceTable& table)
+    : ops_(), table_(&table) {
+  compile(volume);
+}
+
+void CompiledVolume::compile(const Volume& volume) {
+  if (auto hs = dynamic_cast<const HalfSpace*>(&volume)) {
+    uint32_t indx = table_->find(hs->surface_->id());
+    if (indx == 0 || table_->surface(indx) != hs->surface_) {
+      std::string mssg = "surface with id " + std::to_string(hs->surface_->id()) +
+                         " of volume " + std::to_string(volume.id()) +
+                         " is not in the surface table.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    ops_.push_back({OpCode::HalfSpace, hs->side_, indx});
+    return;
+  }
+
+  const Volume* r1 = nullptr;
+  const Volume* r2 = nullptr;
+  OpCode jump = OpCode::JumpIfFalse;
+  bool negate = false;
+  if (auto un = dynamic_cast<const Union*>(&volume)) {
+    r1 = un->r1_.get();
+    r2 = un->r2_.get();
+    jump = OpCode::JumpIfTrue;
+  } else if (auto in = dynamic_cast<const Intersection*>(&volume)) {
+    r1 = in->r1_.get();
+    r2 = in->r2_.get();
+  } else if (auto df = dynamic_cast<const Difference*>(&volume)) {
+    r1 = df->r1_.get();
+    r2 = df->r2_.get();
+    negate = true;
+  } else {
+    std::string mssg = "volume with id " + std::to_string(volume.id()) +
+                       " has a type which cannot be compiled.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  compile(*r1);
+  size_t jump_pos = ops_.size();
+  ops_.push_back({jump, Surface::Side::Positive, 0});
+  compile(*r2);
+  if (negate) ops_.push_back({OpCode::Not, Surface::Side::Positive, 0});
+
+  // The jump target is only known once the second operand is written
+  ops_[jump_pos].arg = static_cast<uint32_t>(ops_.size());
+}
+
+}  // namespace pmc
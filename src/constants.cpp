@@ -64,5 +64,6 @@ namespace pmc {
   //============================================================================
   // Program Parameters
   const double SURFACE_COINCIDENT = 1E-12;
+  const double ENERGY_CUTOFF = 1E-11; // MeV
 
 }
\ No newline at end of file
@@ -49,4 +49,13 @@ namespace pmc {
 
     return (b1.distance <= b2.distance) ? b1 : b2;
   }
+
+  Ray Difference::get_ray(const Position& r, const Direction& u, uint32_t on_surf, Surface::Side on_side) const {
+    return Ray::subtract(r1_->get_ray(r, u, on_surf, on_side), r2_->get_ray(r, u, on_surf, on_side));
+  }
+
+  AABB Difference::bounding_box() const {
+    // Removing r2 can only shrink r1
+    return r1_->bounding_box();
+  }
 }
@@ -0,0 +1,352 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/transport/eigenvalue.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <Papillon/utils/threads.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace pmc {
+
+namespace {
+
+// Sites summed serially by each step of the prefix sum. Being fixed, the
+// sums, and so the resampled sites, are the same on any number of threads.
+constexpr size_t RESAMPLE_BLOCK = 4096;
+
+}  // namespace
+
+void resample_sites(const std::vector<SourceSite>& sites, size_t n, double xi,
+                    std::vector<SourceSite>& out, int threads) {
+  if (sites.empty()) {
+    std::string mssg = "Can not resample an empty set of sites.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  const size_t m = sites.size();
+  const size_t nblocks = (m + RESAMPLE_BLOCK - 1) / RESAMPLE_BLOCK;
+  const int nthreads = thread_count(threads);
+
+  // Weight of the sites before each block
+  std::vector<double> offsets(nblocks + 1, 0.);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for (size_t b = 0; b < nblocks; b++) {
+    const size_t last = std::min(m, (b + 1) * RESAMPLE_BLOCK);
+    double w = 0.;
+    for (size_t i = b * RESAMPLE_BLOCK; i < last; i++) w += sites[i].weight;
+    offsets[b + 1] = w;
+  }
+  for (size_t b = 0; b < nblocks; b++) offsets[b + 1] += offsets[b];
+
+  const double total = offsets.back();
+  if (!(total > 0.)) {
+    std::string mssg = "Sites to resample must have a positive total weight.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+  const double scale = static_cast<double>(n) / total;
+  auto position = [&](double w) {
+    double p = std::floor(w * scale + xi);
+    return p < static_cast<double>(n) ? static_cast<size_t>(std::max(p, 0.))
+                                      : n;
+  };
+
+  // Position in out after the copies of each site. Those of a block are kept
+  // between the positions of its ends, and in order, against round-off.
+  std::vector<size_t> ends(m);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for (size_t b = 0; b < nblocks; b++) {
+    const size_t last = std::min(m, (b + 1) * RESAMPLE_BLOCK);
+    const size_t block_end = b + 1 == nblocks ? n : position(offsets[b + 1]);
+    size_t previous = position(offsets[b]);
+    double w = offsets[b];
+    for (size_t i = b * RESAMPLE_BLOCK; i < last; i++) {
+      w += sites[i].weight;
+      previous = std::min(std::max(position(w), previous), block_end);
+      ends[i] = previous;
+    }
+    ends[last - 1] = block_end;
+  }
+
+  out.resize(n);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for (size_t i = 0; i < m; i++) {
+    for (size_t j = i == 0 ? 0 : ends[i - 1]; j < ends[i]; j++) {
+      out[j] = sites[i];
+      out[j].weight = 1.;
+    }
+  }
+  (void)nthreads;
+}
+
+//============================================================================
+// KeffStatistics
+KeffStatistics::KeffStatistics(bool track_length)
+    : track_length_(track_length), batches_(0), mean_(), comoment_() {}
+
+void KeffStatistics::add(const KeffEstimate& k) {
+  const std::array<double, NEST> x{k.collision, k.absorption, k.track_length};
+  batches_++;
+  const double n = static_cast<double>(batches_);
+
+  std::array<double, NEST> delta;
+  for (size_t i = 0; i < NEST; i++) {
+    delta[i] = x[i] - mean_[i];
+    mean_[i] += delta[i] / n;
+  }
+  for (size_t i = 0; i < NEST; i++)
+    for (size_t j = 0; j < NEST; j++)
+      comoment_[i][j] += delta[i] * (x[j] - mean_[j]);
+}
+
+KeffEstimate KeffStatistics::mean() const {
+  return {mean_[0], mean_[1], mean_[2]};
+}
+
+KeffEstimate KeffStatistics::std_error() const {
+  if (batches_ < 2) return {};
+  const double n = static_cast<double>(batches_);
+  auto error = [&](size_t i) {
+    return std::sqrt(comoment_[i][i] / (n * (n - 1.)));
+  };
+  return {error(0), error(1), error(2)};
+}
+
+bool KeffStatistics::combination(std::array<double, NEST>& weights,
+                                 double& variance) const {
+  const size_t m = nestimators();
+  if (batches_ <= m) return false;
+
+  // Solves C a = 1 for the covariance matrix C of the means of the
+  // estimators, by elimination with partial pivoting
+  const double n = static_cast<double>(batches_);
+  std::array<std::array<double, NEST + 1>, NEST> a;
+  double largest = 0.;
+  for (size_t i = 0; i < m; i++) {
+    for (size_t j = 0; j < m; j++) a[i][j] = comoment_[i][j] / (n * (n - 1.));
+    a[i][m] = 1.;
+    largest = std::max(largest, a[i][i]);
+  }
+  if (!(largest > 0.)) return false;
+
+  for (size_t c = 0; c < m; c++) {
+    size_t pivot = c;
+    for (size_t r = c + 1; r < m; r++)
+      if (std::abs(a[r][c]) > std::abs(a[pivot][c])) pivot = r;
+    if (std::abs(a[pivot][c]) <= 1.E-12 * largest) return false;
+    std::swap(a[c], a[pivot]);
+    for (size_t r = 0; r < m; r++) {
+      if (r == c) continue;
+      const double f = a[r][c] / a[c][c];
+      for (size_t j = c; j <= m; j++) a[r][j] -= f * a[c][j];
+    }
+  }
+
+  double sum = 0.;
+  for (size_t i = 0; i < m; i++) {
+    weights[i] = a[i][m] / a[i][i];
+    sum += weights[i];
+  }
+  if (!(sum > 0.)) return false;
+  variance = 1. / sum;
+  for (size_t i = 0; i < m; i++) weights[i] *= variance;
+  for (size_t i = m; i < NEST; i++) weights[i] = 0.;
+  return true;
+}
+
+double KeffStatistics::combined() const {
+  std::array<double, NEST> weights;
+  double variance;
+  const size_t m = nestimators();
+  if (!combination(weights, variance))
+    weights.fill(1. / static_cast<double>(m));
+
+  double k = 0.;
+  for (size_t i = 0; i < m; i++) k += weights[i] * mean_[i];
+  return k;
+}
+
+double KeffStatistics::combined_std_error() const {
+  std::array<double, NEST> weights;
+  double variance;
+  if (combination(weights, variance)) return std::sqrt(variance);
+  if (batches_ < 2) return 0.;
+
+  // Error of the mean of the estimators
+  const size_t m = nestimators();
+  const double n = static_cast<double>(batches_);
+  double sum = 0.;
+  for (size_t i = 0; i < m; i++)
+    for (size_t j = 0; j < m; j++) sum += comoment_[i][j];
+  return std::sqrt(std::max(sum, 0.) / (n * (n - 1.))) /
+         static_cast<double>(m);
+}
+
+//============================================================================
+// PowerIteration
+PowerIteration::PowerIteration(Geometry& geometry,
+                               std::vector<SourceSite> source,
+                               const EigenvalueSettings& settings)
+    : geometry_(geometry),
+      settings_(settings),
+      source_(std::move(source)),
+      fission_bank_(),
+      source_weight_(0.),
+      batch_(0),
+      keff_(settings.keff),
+      inactive_(settings.inactive),
+      statistics_(settings.transport.tracking == Tracking::Surface),
+      entropy_() {
+  if (settings_.particles == 0) {
+    std::string mssg = "Power iteration needs at least one particle a batch.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (!(keff_ > 0.)) {
+    std::string mssg = "The guess of keff must be above zero.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  for (const auto& site : source_) source_weight_ += site.weight;
+  if (!(source_weight_ > 0.)) {
+    std::string mssg = "The initial source must have a positive weight.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (settings_.entropy_window > 0 && !settings_.entropy_mesh) {
+    std::string mssg = "Ending the inactive batches on the entropy needs "
+                       "an entropy mesh.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  // The majorant is built once, and not for every batch
+  TransportSettings& transport = settings_.transport;
+  transport.entropy_mesh = settings_.entropy_mesh;
+  if (transport.tracking == Tracking::Delta && !transport.majorant)
+    transport.majorant = std::make_shared<Majorant>(geometry_.materials());
+}
+
+bool PowerIteration::done() const {
+  return batch_ >= inactive_ + settings_.active;
+}
+
+bool PowerIteration::entropy_converged() const {
+  const size_t half = settings_.entropy_window / 2;
+  if (half == 0 || entropy_.size() < 2 * half) return false;
+
+  // Means and variances of the two halves of the window
+  auto moments = [&](size_t begin, double& mean, double& variance) {
+    mean = 0.;
+    for (size_t i = begin; i < begin + half; i++) mean += entropy_[i];
+    mean /= static_cast<double>(half);
+    variance = 0.;
+    for (size_t i = begin; i < begin + half; i++)
+      variance += (entropy_[i] - mean) * (entropy_[i] - mean);
+    if (half > 1) variance /= static_cast<double>(half - 1);
+  };
+  double first, first_var, second, second_var;
+  moments(entropy_.size() - 2 * half, first, first_var);
+  moments(entropy_.size() - half, second, second_var);
+
+  double error =
+      std::sqrt((first_var + second_var) / static_cast<double>(half));
+  return std::abs(second - first) <=
+         std::max(2. * error, settings_.entropy_tolerance);
+}
+
+BatchResult PowerIteration::run_batch() {
+  if (done()) {
+    std::string mssg = "All batches of the power iteration have been run.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  TransportSettings settings = settings_.transport;
+  settings.fission_neutrons = FissionNeutrons::Bank;
+  settings.batch = batch_;
+  settings.keff = keff_;
+  if (!active()) settings.tallies.clear();
+
+  BatchResult result;
+  result.batch = batch_;
+  result.active = active();
+  result.transport = transport(geometry_, source_, settings, fission_bank_);
+  result.k.collision = result.transport.k_collision / source_weight_;
+  result.k.absorption = result.transport.k_absorption / source_weight_;
+  result.k.track_length = result.transport.k_track_length / source_weight_;
+
+  if (result.active) {
+    statistics_.add(result.k);
+    for (const auto& tally : settings.tallies) tally->end_batch(source_weight_);
+  }
+
+  if (settings_.entropy_mesh) {
+    result.entropy = EntropyMesh::entropy(result.transport.source_mesh);
+    entropy_.push_back(result.entropy);
+    if (!result.active && settings_.entropy_window > 0 && entropy_converged())
+      inactive_ = batch_ + 1;
+  }
+
+  if (fission_bank_.empty()) {
+    std::string mssg = "No fission neutrons were banked in batch " +
+                       std::to_string(batch_) + ".";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  // The next batch divides its fission neutrons by the estimate of this one
+  double k = result.k.collision + result.k.absorption;
+  if (settings.tracking == Tracking::Surface)
+    k = (k + result.k.track_length) / 3.;
+  else
+    k /= 2.;
+  if (k > 0.) keff_ = k;
+
+  // The number used for resampling is drawn from a stream no history uses
+  RNG rng(settings.seed, batch_, ~0ULL);
+  resample_sites(fission_bank_, settings_.particles, rng(), source_,
+                 settings.threads);
+  source_weight_ = static_cast<double>(settings_.particles);
+  batch_++;
+  return result;
+}
+
+std::vector<BatchResult> PowerIteration::run() {
+  std::vector<BatchResult> results;
+  while (!done()) results.push_back(run_batch());
+  return results;
+}
+
+}  // namespace pmc
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/transport/entropy.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+namespace pmc {
+
+EntropyMesh::EntropyMesh(const Position& lower, const Position& upper,
+                         uint32_t nx, uint32_t ny, uint32_t nz)
+    : lower_{lower.x(), lower.y(), lower.z()},
+      inv_width_(),
+      shape_{nx, ny, nz} {
+  for (int a = 0; a < 3; a++) {
+    if (shape_[a] == 0) {
+      std::string mssg = "Entropy mesh must have at least one cell a side.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    if (!(upper[a] > lower[a])) {
+      std::string mssg =
+          "Entropy mesh must have its upper corner above its lower one.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    inv_width_[a] = shape_[a] / (upper[a] - lower[a]);
+  }
+}
+
+double EntropyMesh::entropy(const std::vector<double>& weights) {
+  double total = 0.;
+  for (double w : weights) total += w;
+  if (!(total > 0.)) return 0.;
+
+  double h = 0.;
+  for (double w : weights) {
+    if (w > 0.) {
+      double p = w / total;
+      h -= p * std::log2(p);
+    }
+  }
+  return h;
+}
+
+}  // namespace pmc
@@ -33,26 +33,86 @@
  * */
 
 #include <Papillon/geometry/geo_node.hpp>
+#include <algorithm>
+#include <atomic>
+#include <vector>
 
 namespace pmc {
 
+static constexpr double BBOX_PADDING = 1.E-9;
+
 GeoNode::GeoNode(std::shared_ptr<Volume> v, const std::string& name)
-    : name_(name), parent_(nullptr), volume_(v), transform_(), children_() {}
+    : is_lattice_(false),
+      name_(name),
+      parent_(nullptr),
+      volume_(v),
+      material_(),
+      compiled_volume_(),
+      intersection_volume_(false),
+      transform_(),
+      inverse_transform_(),
+      bbox_(),
+      children_(),
+      universes_(),
+      placements_(),
+      bvh_(),
+      use_bvh_(true),
+      neighbor_surfaces_(),
+      neighbors_(),
+      finalize_pass_(0) {
+  update_bounding_box();
+}
 GeoNode::GeoNode(std::shared_ptr<Volume> v, Transformation t, const std::string& name)
-    : name_(name),
+    : is_lattice_(false),
+      name_(name),
       parent_(nullptr),
       volume_(v),
+      material_(),
+      compiled_volume_(),
+      intersection_volume_(false),
       transform_(t.inverse()),
-      children_() {}
+      inverse_transform_(t),
+      bbox_(),
+      children_(),
+      universes_(),
+      placements_(),
+      bvh_(),
+      use_bvh_(true),
+      neighbor_surfaces_(),
+      neighbors_(),
+      finalize_pass_(0) {
+  update_bounding_box();
+}
 GeoNode::GeoNode(GeoNode* p, std::shared_ptr<Volume> v, Transformation t,
                  const std::string& name)
-    : name_(name), parent_(p), volume_(v), transform_(t.inverse()), children_() {}
+    : is_lattice_(false),
+      name_(name),
+      parent_(p),
+      volume_(v),
+      material_(),
+      compiled_volume_(),
+      intersection_volume_(false),
+      transform_(t.inverse()),
+      inverse_transform_(t),
+      bbox_(),
+      children_(),
+      universes_(),
+      placements_(),
+      bvh_(),
+      use_bvh_(true),
+      neighbor_surfaces_(),
+      neighbors_(),
+      finalize_pass_(0) {
+  update_bounding_box();
+}
 
 //============================================================================
 // Methods to add nodes
+// Adding a child discards the BVH, which is rebuilt by the next finalize.
 GeoNode* GeoNode::add_node(std::shared_ptr<Volume> v, Transformation t,
                            std::string name) {
   children_.emplace_back(std::make_unique<GeoNode>(this, v, t, name));
+  add_placement(children_.back().get(), children_.back()->transform_);
   return children_.back().get();
 }
 
@@ -60,35 +120,185 @@ GeoNode* GeoNode::add_node(std::unique_ptr<GeoNode> node, Transformation t) {
   children_.push_back(std::move(node));
   children_.back()->set_parent(this);
   children_.back()->set_transformation(t);
+  add_placement(children_.back().get(), children_.back()->transform_);
   return children_.back().get();
 }
 
 GeoNode* GeoNode::add_node(std::unique_ptr<GeoNode> node) {
   children_.push_back(std::move(node));
   children_.back()->set_parent(this);
+  add_placement(children_.back().get(), children_.back()->transform_);
   return children_.back().get();
 }
 
+GeoNode* GeoNode::add_instance(std::shared_ptr<GeoNode> universe,
+                               Transformation t) {
+  add_universe(universe);
+  add_placement(universe.get(), universe->transform_ * t.inverse());
+  return universe.get();
+}
+
+void GeoNode::add_universe(std::shared_ptr<GeoNode> universe) {
+  // Universes are only stored once, however many times they are placed
+  if (std::find(universes_.begin(), universes_.end(), universe) ==
+      universes_.end())
+    universes_.push_back(universe);
+}
+
+void GeoNode::add_placement(GeoNode* node, const Transformation& to_child) {
+  bvh_ = BVH();
+  placements_.push_back({node, to_child, to_child.inverse(), AABB()});
+  placements_.back().box = node->volume_->bounding_box()
+                               .transformed(placements_.back().to_parent)
+                               .padded(BBOX_PADDING);
+}
+
+void GeoNode::update_placement(const GeoNode* child) {
+  for (auto& placement : placements_) {
+    if (placement.node == child) {
+      bvh_ = BVH();
+      placement.to_child = child->transform_;
+      placement.to_parent = child->inverse_transform_;
+      placement.box = child->bbox_;
+    }
+  }
+}
+
 //============================================================================
 // Cloning
 std::unique_ptr<GeoNode> GeoNode::clone() const {
-  // Must inverse transform, as we inverse it again in constructor
   std::unique_ptr<GeoNode> new_this =
-      std::make_unique<GeoNode>(volume_, transform_.inverse(), name_);
+      std::make_unique<GeoNode>(volume_, inverse_transform_, name_);
+  clone_into(*new_this);
+  return new_this;
+}
+
+void GeoNode::clone_into(GeoNode& copy) const {
+  copy.set_transformation(inverse_transform_);
+  copy.set_use_bvh(use_bvh_);
+  copy.set_material(material_);
 
-  // Add clones of all children
-  for (const auto& child : children_) {
-    new_this->add_node(std::move(child->clone()));
+  // Add clones of all owned children, and share the universes
+  copy.universes_ = universes_;
+  for (const auto& placement : placements_) {
+    if (placement.node->parent_ == this) {
+      copy.add_node(placement.node->clone());
+    } else {
+      copy.add_placement(placement.node, placement.to_child);
+    }
   }
+}
 
-  return new_this;
+//============================================================================
+// Materials
+void GeoNode::collect_materials(
+    std::vector<const Material*>& materials) const {
+  if (material_ && std::find(materials.begin(), materials.end(),
+                             material_.get()) == materials.end())
+    materials.push_back(material_.get());
+
+  for (const auto& child : children_) child->collect_materials(materials);
+  for (const auto& universe : universes_)
+    universe->collect_materials(materials);
+}
+
+//============================================================================
+// Batched boundary distances
+bool GeoNode::distance_to_boundary_batch(const double* x, const double* y,
+                                         const double* z, const double* u,
+                                         const double* v, const double* w,
+                                         double* d, size_t n, double* distance,
+                                         uint32_t* surface) const {
+  if (!intersection_volume_) return false;
+
+  // Same loop as CompiledVolume::distance_to_boundary, with the rays as the
+  // inner loop, so that ties between surfaces go the same way
+  const SurfaceTable& table = *compiled_volume_.table();
+  std::fill(distance, distance + n, INF);
+  std::fill(surface, surface + n, 0);
+  for (const auto& op : compiled_volume_.program()) {
+    if (op.code != CompiledVolume::OpCode::HalfSpace) continue;
+    table.surface(op.arg)->distance_batch(x, y, z, u, v, w, d, n);
+    for (size_t i = 0; i < n; i++) {
+      if (d[i] < distance[i]) {
+        distance[i] = d[i];
+        surface[i] = op.arg;
+      }
+    }
+  }
+  return true;
+}
+
+//============================================================================
+// Finalization
+static std::atomic<uint64_t> finalize_passes{0};
+
+void GeoNode::finalize(const SurfaceTable& table) {
+  finalize(table, ++finalize_passes);
+}
+
+void GeoNode::finalize(const SurfaceTable& table, uint64_t pass) {
+  // Universes are shared by all the nodes they are placed in, and only need
+  // to be compiled once
+  if (finalize_pass_ == pass) return;
+  finalize_pass_ = pass;
+
+  compiled_volume_ = CompiledVolume(*volume_, table);
+  intersection_volume_ = compiled_volume_.is_intersection();
+
+  for (auto& child : children_) child->finalize(table, pass);
+  for (auto& universe : universes_) universe->finalize(table, pass);
+
+  bvh_ = BVH();
+  if (use_bvh_ && placements_.size() >= BVH_MIN_CHILDREN) {
+    std::vector<AABB> boxes;
+    boxes.reserve(placements_.size());
+    for (const auto& placement : placements_) boxes.push_back(placement.box);
+    bvh_ = BVH(boxes);
+  }
+
+  build_neighbor_lists();
+}
+
+void GeoNode::build_neighbor_lists() {
+  neighbor_surfaces_.clear();
+  neighbors_.reset();
+  // With a single child, there is nothing to choose between
+  if (placements_.size() < 2) return;
+
+  for (const auto& placement : placements_) {
+    for (const auto& op : placement.node->compiled_volume_.program()) {
+      if (op.code == CompiledVolume::OpCode::HalfSpace)
+        neighbor_surfaces_.push_back(op.arg);
+    }
+  }
+  std::sort(neighbor_surfaces_.begin(), neighbor_surfaces_.end());
+  neighbor_surfaces_.erase(
+      std::unique(neighbor_surfaces_.begin(), neighbor_surfaces_.end()),
+      neighbor_surfaces_.end());
+  neighbors_ = std::make_unique<NeighborList[]>(2 * neighbor_surfaces_.size());
+}
+
+//============================================================================
+// Bounding box
+void GeoNode::update_bounding_box() {
+  // inverse_transform_ carries the volume's box into the parent frame. The padding keeps
+  // points lying on the volume's surfaces inside the box after rounding.
+  bbox_ = volume_->bounding_box()
+              .transformed(inverse_transform_)
+              .padded(BBOX_PADDING);
 }
 
 //============================================================================
 // Setters
 void GeoNode::set_parent(GeoNode* p) { parent_ = p; }
 
-void GeoNode::set_transformation(Transformation t) { transform_ = t.inverse(); }
+void GeoNode::set_transformation(Transformation t) {
+  transform_ = t.inverse();
+  inverse_transform_ = t;
+  update_bounding_box();
+  if (parent_) parent_->update_placement(this);
+}
 
 void GeoNode::set_name(const std::string& name) { name_ = name; }
 
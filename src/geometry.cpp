@@ -37,7 +37,11 @@ namespace pmc {
 
 Geometry::Geometry(std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs,
                    std::unique_ptr<GeoNode> r)
-    : boundary_conditions(), surfaces(surfs), volumes(), root_(std::move(r)) {
+    : boundary_conditions(),
+      surfaces(surfs),
+      surface_table_(surfaces),
+      volumes(),
+      root_(std::move(r)) {
   // Copy all surfaces with non-transparent boundary types into the
   // boundary_conditions vector
   for (const auto& surf : surfaces) {
@@ -45,6 +49,8 @@ Geometry::Geometry(std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs,
       boundary_conditions.push_back(surf.second);
     }
   }
+
+  root_->finalize(surface_table_);
 }
 
 Geometry::Geometry(std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs,
@@ -52,6 +58,7 @@ Geometry::Geometry(std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs,
                    std::unique_ptr<GeoNode> r)
     : boundary_conditions(),
       surfaces(surfs),
+      surface_table_(surfaces),
       volumes(vols),
       root_(std::move(r)) {
   // Copy all surfaces with non-transparent boundary types into the
@@ -61,6 +68,8 @@ Geometry::Geometry(std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs,
       boundary_conditions.push_back(surf.second);
     }
   }
+
+  root_->finalize(surface_table_);
 }
 
 }  // namespace pmc
\ No newline at end of file
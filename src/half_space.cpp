@@ -35,6 +35,11 @@
 
 #include<cmath>
 
+namespace {
+  // Crossings of the same surface closer than this are taken to be one
+  const double RAY_MIN_STEP = 1.E-9;
+}
+
 namespace pmc {
 
   HalfSpace::HalfSpace(std::shared_ptr<Surface> surface, Surface::Side side, uint32_t id): Volume(id), surface_(surface), side_(side) {}
@@ -71,4 +76,46 @@ namespace pmc {
     bound.boundary_type = surface_->boundary();
     return bound;
   }
+
+  Ray HalfSpace::get_ray(const Position& r, const Direction& u, uint32_t on_surf, Surface::Side on_side) const {
+    // Side of the surface the ray is on before entering the half-space
+    const Surface::Side outside = (side_ == Surface::Side::Positive) ? Surface::Side::Negative : Surface::Side::Positive;
+    const uint32_t id = surface_->id();
+
+    Ray ray;
+    bool inside = is_inside(r, u, on_surf, on_side);
+    SurfaceCrossing enter {0., 0, outside};
+    Position p = r;
+    double t = 0.;
+    // Distances are always found without on_surf, which would hide the far
+    // side of a quadric from a point on its surface.
+    bool on_surface = (on_surf == id);
+
+    // Surfaces are at most quadric, so a ray crosses one at most twice.
+    // The extra steps absorb a crossing which is found a second time, just
+    // behind the point it was found at, due to rounding.
+    for(int step = 0; step < 4; step++) {
+      double d = surface_->distance(p, u, 0);
+      if(d >= INF) break;
+      p += d*u;
+      t += d;
+      if(on_surface && d < RAY_MIN_STEP) continue;
+      on_surface = true;
+
+      if(inside) {
+        ray.push_back({enter, {t, id, side_}});
+        inside = false;
+      } else {
+        enter = {t, id, outside};
+        inside = true;
+      }
+    }
+    if(inside) ray.push_back({enter, {INF, 0, Surface::Side::Positive}});
+
+    return ray;
+  }
+
+  AABB HalfSpace::bounding_box() const {
+    return surface_->bounding_box(side_);
+  }
 }
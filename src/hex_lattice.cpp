@@ -0,0 +1,149 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/geometry/hex_lattice.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+namespace pmc {
+
+HexLattice::HexLattice(std::shared_ptr<Volume> v, Orientation orientation,
+                       uint32_t nrings, uint32_t nz, double pitch, double pz,
+                       Position origin, const std::string& name)
+    : GeoNode(v, name),
+      orientation_(orientation),
+      nrings_(nrings),
+      nz_(nz),
+      pitch_(pitch),
+      pz_(pz),
+      origin_(origin),
+      a1_(),
+      a2_(),
+      normals_(),
+      grid_box_(),
+      elements_() {
+  is_lattice_ = true;
+
+  if (nrings_ == 0 || nz_ == 0) {
+    std::string mssg = "HexLattice " + name + " has no elements.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+  if (pitch_ <= 0. || pitch_ == INF || pz_ <= 0.) {
+    std::string mssg = "HexLattice " + name + " has an invalid pitch.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+  if (pz_ == INF && nz_ != 1) {
+    std::string mssg = "HexLattice " + name +
+                       " is infinite along z with several layers.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  const double c = 0.5 * std::sqrt(3.);
+  if (orientation_ == Orientation::Y) {
+    a1_ = {c * pitch_, 0.5 * pitch_};
+    a2_ = {0., pitch_};
+  } else {
+    a1_ = {pitch_, 0.};
+    a2_ = {0.5 * pitch_, c * pitch_};
+  }
+  // Neighbouring centers are one pitch apart, along a1, a2 and a2 - a1
+  normals_[0] = {a1_[0] / pitch_, a1_[1] / pitch_};
+  normals_[1] = {a2_[0] / pitch_, a2_[1] / pitch_};
+  normals_[2] = {(a2_[0] - a1_[0]) / pitch_, (a2_[1] - a1_[1]) / pitch_};
+
+  // Every element lies within one pitch of the centers of the outer ring,
+  // which are at most (nrings - 1) pitches from the origin.
+  double half_width = nrings_ * pitch_;
+  Position lower(origin_.x() - half_width, origin_.y() - half_width, -INF);
+  Position upper(origin_.x() + half_width, origin_.y() + half_width, INF);
+  if (pz_ == INF) {
+    origin_[2] = -INF;
+  } else {
+    lower[2] = origin_.z();
+    upper[2] = origin_.z() + nz_ * pz_;
+  }
+  grid_box_ = AABB(lower, upper);
+
+  size_t side = 2 * nrings_ - 1;
+  elements_.resize(side * side * nz_, {nullptr, Transformation(), Transformation()});
+}
+
+Position HexLattice::element_center(int32_t q, int32_t r, uint32_t k) const {
+  double x = origin_.x() + q * a1_[0] + r * a2_[0];
+  double y = origin_.y() + q * a1_[1] + r * a2_[1];
+  double z = (pz_ == INF) ? 0. : origin_.z() + (k + 0.5) * pz_;
+  return {x, y, z};
+}
+
+void HexLattice::set_element(int32_t q, int32_t r, uint32_t k,
+                             std::shared_ptr<GeoNode> universe) {
+  if (!in_lattice({q, r, static_cast<int32_t>(k)})) {
+    std::string mssg = "Element (" + std::to_string(q) + "," +
+                       std::to_string(r) + "," + std::to_string(k) +
+                       ") is outside of HexLattice " + name() + ".";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  Element& e = elements_[flat_index(q, r, k)];
+  e.universe = universe.get();
+  if (!universe) return;
+
+  add_universe(universe);
+
+  // The universe may carry its own transformation, which is applied in the
+  // frame of the element.
+  Position center = element_center(q, r, k);
+  e.to_universe = universe->transformation() *
+                  Transformation::translation(-center.x(), -center.y(), -center.z());
+  e.to_lattice = e.to_universe.inverse();
+}
+
+void HexLattice::fill(std::shared_ptr<GeoNode> universe) {
+  int32_t n = static_cast<int32_t>(nrings_) - 1;
+  for (uint32_t k = 0; k < nz_; k++) {
+    for (int32_t r = -n; r <= n; r++) {
+      for (int32_t q = -n; q <= n; q++) {
+        if (std::abs(q + r) <= n) set_element(q, r, k, universe);
+      }
+    }
+  }
+}
+
+std::unique_ptr<GeoNode> HexLattice::clone() const {
+  auto new_this = std::make_unique<HexLattice>(
+      volume(), orientation_, nrings_, nz_, pitch_, pz_, origin_, name());
+  new_this->elements_ = elements_;
+  clone_into(*new_this);
+  return new_this;
+}
+
+}  // namespace pmc
@@ -48,4 +48,12 @@ namespace pmc {
 
     return (b1.distance <= b2.distance) ? b1 : b2;
   }
+
+  Ray Intersection::get_ray(const Position& r, const Direction& u, uint32_t on_surf, Surface::Side on_side) const {
+    return Ray::intersect(r1_->get_ray(r, u, on_surf, on_side), r2_->get_ray(r, u, on_surf, on_side));
+  }
+
+  AABB Intersection::bounding_box() const {
+    return AABB::intersection(r1_->bounding_box(), r2_->bounding_box());
+  }
 }
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/materials/log_hash.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <vector>
+
+namespace pmc {
+
+const double LogHash::LOG_E_MIN = std::log(LogHash::E_MIN);
+const double LogHash::INV_WIDTH =
+    static_cast<double>(LogHash::NBINS) /
+    (std::log(LogHash::E_MAX) - std::log(LogHash::E_MIN));
+
+LogHash::LogHash(ArrayView<double> grid) : storage_(), lower_(nullptr) {
+  if (grid.size() < 2) {
+    std::string mssg = "A LogHash needs a grid of at least two points.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  auto table = std::make_shared<std::vector<uint32_t>>(TABLE_SIZE);
+  const size_t last = grid.size() - 2;
+  for (size_t b = 0; b <= NBINS; b++) {
+    double E = std::exp(LOG_E_MIN + static_cast<double>(b) / INV_WIDTH);
+    size_t i = static_cast<size_t>(
+        std::upper_bound(grid.begin(), grid.end(), E) - grid.begin());
+    i = i > 0 ? i - 1 : 0;
+    (*table)[b] = static_cast<uint32_t>(std::min(i, last));
+  }
+  lower_ = table->data();
+  storage_ = std::move(table);
+}
+
+}  // namespace pmc
@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 const std::string papillon_logo = "\n"
@@ -41,12 +42,8 @@ const std::string papillon_help =
   " visit https://github.com/HunterBelanger/papillon\n\n"
 
   " Usage:\n"
-#ifdef _OPENMP
-  "   papillon (--input FILE) [--threads NUM --output FILE]\n"
-#else
   "   papillon (--input FILE) [--output FILE]\n"
-#endif
-  "   papillon (--input FILE --plot) [--threads NUM]\n"
+  "   papillon (--input FILE --plot)\n"
   "   papillon (-l | --license)\n"
   "   papillon (-h | --help)\n"
   "   papillon (-v | --version)\n\n"
@@ -56,22 +53,34 @@ const std::string papillon_help =
   "   -v --version      Show version number\n"
   "   -l --license      Show license for Papillon\n"
   "   -i --input FILE   Set input file\n"
+  "   -o --output FILE  Set output file\n"
+  "   -p --plot         Start Papillon in plotting mode\n"
 #ifdef _OPENMP
-  "   -t --threads NUM  Set number of OpenMP threads\n"
+  "\n"
+  " Transport runs on as many threads as OpenMP allows, which may be set\n"
+  " with OMP_NUM_THREADS, unless another number is set with\n"
+  " TransportSettings::threads.\n"
 #endif
-  "   -o --output FILE  Set output file\n"
-  "   -p --plot         Start Papillon in plotting mode\n";
+  ;
 
 
 
 
 using namespace pmc;
 
-int main() {
+int main(int argc, char** argv) {
 
   std::cout << papillon_logo;
   std::cout << papillon_header;
 
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-h" || arg == "--help") {
+      std::cout << papillon_help;
+      return 0;
+    }
+  }
+
   std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
   std::unordered_map<uint32_t, std::shared_ptr<Volume>> volumes;
 
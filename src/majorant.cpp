@@ -0,0 +1,74 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/transport/majorant.hpp>
+#include <algorithm>
+
+namespace pmc {
+
+Majorant::Majorant(const std::vector<const Material*>& materials)
+    : energy_(), xs_() {
+  for (const Material* mat : materials) {
+    for (size_t i = 0; i < mat->size(); i++) {
+      ArrayView<double> grid = mat->nuclide(i).energy();
+      energy_.insert(energy_.end(), grid.begin(), grid.end());
+    }
+  }
+  std::sort(energy_.begin(), energy_.end());
+  energy_.erase(std::unique(energy_.begin(), energy_.end()), energy_.end());
+  if (energy_.size() < 2) {
+    energy_.clear();
+    return;
+  }
+
+  std::vector<double> at_point(energy_.size(), 0.);
+  for (const Material* mat : materials) {
+    for (size_t j = 0; j < energy_.size(); j++)
+      at_point[j] = std::max(at_point[j], mat->xs(energy_[j]).total);
+  }
+
+  xs_.resize(energy_.size() - 1);
+  for (size_t j = 0; j + 1 < energy_.size(); j++)
+    xs_[j] = std::max(at_point[j], at_point[j + 1]);
+}
+
+double Majorant::xs(double E) const {
+  if (xs_.empty()) return 0.;
+  if (E <= energy_.front()) return xs_.front();
+  if (E >= energy_.back()) return xs_.back();
+  size_t i = static_cast<size_t>(
+      std::upper_bound(energy_.begin(), energy_.end(), E) - energy_.begin());
+  return xs_[i - 1];
+}
+
+}  // namespace pmc
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/utils/mapped_file.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pmc {
+
+  MappedFile::MappedFile(const std::string& fname)
+      : fname_(fname), data_(nullptr), size_(0) {
+    int fd = open(fname_.c_str(), O_RDONLY);
+    if (fd < 0) {
+      std::string mssg = "Could not open the file " + fname_ + ".";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+      close(fd);
+      std::string mssg = "The file " + fname_ + " is empty or unreadable.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping holds its own reference to the file
+    close(fd);
+    if (addr == MAP_FAILED) {
+      std::string mssg = "Could not map the file " + fname_ + " in memory.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    data_ = static_cast<const unsigned char*>(addr);
+  }
+
+  MappedFile::~MappedFile() {
+    munmap(const_cast<unsigned char*>(data_), size_);
+  }
+
+}
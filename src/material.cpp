@@ -0,0 +1,154 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/materials/material.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <algorithm>
+
+namespace pmc {
+
+Material::Material(uint32_t id, const std::string& name)
+    : id_(id),
+      name_(name),
+      components_(),
+      grid_mode_(EnergyGridMode::Nuclide),
+      union_energy_(),
+      union_hash_(),
+      union_index_() {}
+
+void Material::add_nuclide(std::shared_ptr<Nuclide> nuclide,
+                           double atom_density) {
+  if (!nuclide) {
+    std::string mssg = "Material " + std::to_string(id_) +
+                       " can not be given a null nuclide.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (atom_density <= 0.) {
+    std::string mssg = "Nuclide " + nuclide->name() + " in material " +
+                       std::to_string(id_) +
+                       " must have a positive atom density.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  components_.push_back({nuclide, atom_density});
+  if (grid_mode_ == EnergyGridMode::Unionized) build_unionized_grid();
+}
+
+void Material::set_grid_mode(EnergyGridMode mode) {
+  grid_mode_ = mode;
+  if (grid_mode_ == EnergyGridMode::Unionized) {
+    build_unionized_grid();
+  } else {
+    union_energy_ = std::vector<double>();
+    union_hash_ = LogHash();
+    union_index_ = std::vector<uint32_t>();
+  }
+}
+
+void Material::build_unionized_grid() {
+  union_energy_.clear();
+  for (const auto& c : components_) {
+    ArrayView<double> grid = c.nuclide->energy();
+    union_energy_.insert(union_energy_.end(), grid.begin(), grid.end());
+  }
+  std::sort(union_energy_.begin(), union_energy_.end());
+  union_energy_.erase(std::unique(union_energy_.begin(), union_energy_.end()),
+                      union_energy_.end());
+  union_energy_.shrink_to_fit();
+  if (union_energy_.empty()) return;
+
+  union_hash_ = LogHash(union_energy_);
+
+  // No nuclide has a point inside of an interval of the union, so the
+  // interval of its grid holding the lower end of an interval of the union
+  // holds all of it.
+  const size_t n = components_.size();
+  union_index_.assign((union_energy_.size() - 1) * n, 0);
+  for (size_t j = 0; j < n; j++) {
+    const Nuclide& nuclide = *components_[j].nuclide;
+    for (size_t u = 0; u + 1 < union_energy_.size(); u++)
+      union_index_[u * n + j] =
+          static_cast<uint32_t>(nuclide.grid_index(union_energy_[u]));
+  }
+}
+
+MacroXS Material::xs(double E) const {
+  MacroXS macro{0., 0., 0., 0., 0.};
+  for_each_nuclide(E, [&](size_t j, const MicroXS& micro) {
+    const Component& c = components_[j];
+    macro.total += c.atom_density * micro.total;
+    macro.elastic += c.atom_density * micro.elastic;
+    macro.capture += c.atom_density * micro.capture;
+    macro.fission += c.atom_density * micro.fission;
+    macro.nu_fission += c.atom_density * c.nuclide->nu() * micro.fission;
+  });
+  return macro;
+}
+
+size_t Material::sample_nuclide(double E, double xi) const {
+  double target = xi * xs(E).total;
+  double sum = 0.;
+  size_t chosen = components_.size();
+  for_each_nuclide(E, [&](size_t j, const MicroXS& micro) {
+    if (chosen < components_.size()) return;
+    sum += components_[j].atom_density * micro.total;
+    if (target < sum) chosen = j;
+  });
+  return chosen < components_.size() ? chosen : components_.size() - 1;
+}
+
+size_t Material::memory() const {
+  return sizeof(Material) + name_.capacity() +
+         components_.capacity() * sizeof(Component) +
+         union_energy_.capacity() * sizeof(double) + union_hash_.memory() +
+         union_index_.capacity() * sizeof(uint32_t);
+}
+
+size_t Material::memory(const std::vector<const Material*>& materials) {
+  size_t bytes = 0;
+  std::vector<const Nuclide*> nuclides;
+  for (const Material* mat : materials) {
+    bytes += mat->memory();
+    for (const auto& c : mat->components_) {
+      if (std::find(nuclides.begin(), nuclides.end(), c.nuclide.get()) ==
+          nuclides.end()) {
+        nuclides.push_back(c.nuclide.get());
+        bytes += c.nuclide->memory();
+      }
+    }
+  }
+  return bytes;
+}
+
+}  // namespace pmc
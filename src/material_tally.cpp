@@ -0,0 +1,73 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/materials/material.hpp>
+#include <Papillon/tallies/material_tally.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+namespace pmc {
+
+MaterialTally::MaterialTally(const std::string& name,
+                             const std::vector<const Material*>& materials,
+                             const std::vector<TallyScore>& scores,
+                             TallyAccumulation accumulation)
+    : Tally(name, materials.size() * scores.size(), accumulation),
+      scores_(scores),
+      index_() {
+  check_scores(scores_);
+  for (size_t m = 0; m < materials.size(); m++) {
+    if (!index_.emplace(materials[m], m).second) {
+      std::string mssg = "Material " + std::to_string(materials[m]->id()) +
+                         " is given twice to tally " + name + ".";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+  }
+}
+
+void MaterialTally::score_flight(int thread, const Position& /*r*/,
+                                 const Direction& /*u*/, double distance,
+                                 const Material* material, double E,
+                                 double weight) {
+  if (!material) return;
+  auto it = index_.find(material);
+  if (it == index_.end()) return;
+
+  const double flux = weight * distance;
+  const size_t first = it->second * scores_.size();
+  double sigma[MAX_SCORES];
+  score_xs(scores_, material, E, sigma);
+  for (size_t s = 0; s < scores_.size(); s++)
+    score(thread, first + s, flux * sigma[s]);
+}
+
+}  // namespace pmc
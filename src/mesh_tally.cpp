@@ -0,0 +1,100 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/tallies/mesh_tally.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+namespace pmc {
+
+MeshTally::MeshTally(const std::string& name, const Position& lower,
+                     const Position& upper, uint32_t nx, uint32_t ny,
+                     uint32_t nz, const std::vector<TallyScore>& scores,
+                     TallyAccumulation accumulation)
+    : Tally(name,
+            static_cast<size_t>(nx) * ny * nz * std::max<size_t>(scores.size(), 1),
+            accumulation),
+      lower_{lower.x(), lower.y(), lower.z()},
+      upper_{upper.x(), upper.y(), upper.z()},
+      shape_{nx, ny, nz},
+      width_(),
+      scores_(scores) {
+  check_scores(scores_);
+  for (int a = 0; a < 3; a++) {
+    if (!(upper_[a] > lower_[a])) {
+      std::string mssg = "Mesh of tally " + name +
+                         " must have its upper corner above its lower one.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    width_[a] = (upper_[a] - lower_[a]) / shape_[a];
+  }
+}
+
+void MeshTally::score_flight(int thread, const Position& r,
+                             const Direction& u, double distance,
+                             const Material* material, double E,
+                             double weight) {
+  // Cells crossed are gathered, then scored together with the cross
+  // sections of the flight, which are only looked up if the mesh is hit
+  struct Chord {
+    size_t cell;
+    double length;
+  };
+  constexpr size_t NCHORDS = 64;
+  Chord chords[NCHORDS];
+  size_t nchords = 0;
+  double sigma[MAX_SCORES];
+  bool have_xs = false;
+  const size_t nscores = scores_.size();
+
+  auto flush = [&]() {
+    if (!have_xs) {
+      score_xs(scores_, material, E, sigma);
+      have_xs = true;
+    }
+    for (size_t c = 0; c < nchords; c++) {
+      const size_t first = chords[c].cell * nscores;
+      const double flux = weight * chords[c].length;
+      for (size_t s = 0; s < nscores; s++)
+        score(thread, first + s, flux * sigma[s]);
+    }
+    nchords = 0;
+  };
+
+  walk(r, u, distance, [&](size_t cell, double length) {
+    chords[nchords++] = {cell, length};
+    if (nchords == NCHORDS) flush();
+  });
+  if (nchords > 0) flush();
+}
+
+}  // namespace pmc
@@ -0,0 +1,327 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/materials/nuclear_data_library.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <cstring>
+#include <fstream>
+
+namespace pmc {
+
+namespace {
+
+const char MAGIC[8] = {'P', 'M', 'C', 'N', 'D', 'L', '\0', '\0'};
+const uint32_t ENDIAN_MARK = 0x01020304;
+const size_t HEADER_SIZE = 64;
+const size_t ENTRY_SIZE = 64;
+const size_t NAME_SIZE = 32;
+
+// Offsets of the fields of the header
+const size_t H_MAGIC = 0;
+const size_t H_MAJOR = 8;
+const size_t H_MINOR = 12;
+const size_t H_ENDIAN = 16;
+const size_t H_NNUCLIDES = 20;
+const size_t H_FILE_SIZE = 24;
+const size_t H_CHECKSUM = 32;
+const size_t H_HASH_BINS = 40;
+const size_t H_HASH_E_MIN = 48;
+const size_t H_HASH_E_MAX = 56;
+
+// Offsets of the fields of an index entry
+const size_t E_NAME = 0;
+const size_t E_AWR = 32;
+const size_t E_NU = 40;
+const size_t E_NPOINTS = 48;
+const size_t E_FLAGS = 52;
+const size_t E_OFFSET = 56;
+
+bool little_endian() {
+  const uint32_t one = 1;
+  unsigned char byte;
+  std::memcpy(&byte, &one, 1);
+  return byte == 1;
+}
+
+size_t aligned(size_t n) {
+  const size_t a = NuclearDataLibrary::ALIGNMENT;
+  return (n + a - 1) / a * a;
+}
+
+size_t table_bytes(size_t npoints) { return aligned(npoints * sizeof(double)); }
+
+// Bytes of the tables of a nuclide with npoints grid points
+size_t block_bytes(size_t npoints) {
+  return 5 * table_bytes(npoints) +
+         aligned(LogHash::TABLE_SIZE * sizeof(uint32_t));
+}
+
+template <class T>
+void put(std::vector<unsigned char>& buffer, size_t offset, T value) {
+  std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+template <class T>
+T get(const unsigned char* data, size_t offset) {
+  T value;
+  std::memcpy(&value, data + offset, sizeof(T));
+  return value;
+}
+
+}  // namespace
+
+NuclearDataLibrary::NuclearDataLibrary(const std::string& fname, bool verify)
+    : file_(), names_(), entries_(), index_(), same_hash_(false) {
+  if (!little_endian()) {
+    std::string mssg = "Nuclear data libraries can only be read on "
+                       "little-endian hosts.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  file_ = std::make_shared<const MappedFile>(fname);
+  const unsigned char* data = file_->data();
+  const size_t size = file_->size();
+
+  if (size < HEADER_SIZE ||
+      std::memcmp(data + H_MAGIC, MAGIC, sizeof(MAGIC)) != 0) {
+    std::string mssg = fname + " is not a nuclear data library.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  uint32_t major = get<uint32_t>(data, H_MAJOR);
+  if (major != VERSION_MAJOR) {
+    std::string mssg = fname + " has version " + std::to_string(major) + "." +
+                       std::to_string(get<uint32_t>(data, H_MINOR)) +
+                       ", but only version " + std::to_string(VERSION_MAJOR) +
+                       ".x can be read.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (get<uint32_t>(data, H_ENDIAN) != ENDIAN_MARK ||
+      get<uint64_t>(data, H_FILE_SIZE) != size) {
+    std::string mssg = fname + " is truncated or corrupted.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  same_hash_ = get<uint32_t>(data, H_HASH_BINS) == LogHash::NBINS &&
+               get<double>(data, H_HASH_E_MIN) == LogHash::E_MIN &&
+               get<double>(data, H_HASH_E_MAX) == LogHash::E_MAX;
+
+  const size_t nnuclides = get<uint32_t>(data, H_NNUCLIDES);
+  if (HEADER_SIZE + nnuclides * ENTRY_SIZE > size) {
+    std::string mssg = fname + " is truncated or corrupted.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  for (size_t n = 0; n < nnuclides; n++) {
+    const unsigned char* entry = data + HEADER_SIZE + n * ENTRY_SIZE;
+    const char* name = reinterpret_cast<const char*>(entry + E_NAME);
+    Entry e{get<double>(entry, E_AWR), get<double>(entry, E_NU),
+            get<uint32_t>(entry, E_NPOINTS), get<uint32_t>(entry, E_FLAGS),
+            get<uint64_t>(entry, E_OFFSET)};
+
+    if (std::memchr(name, '\0', NAME_SIZE) == nullptr || e.npoints < 2 ||
+        e.offset % ALIGNMENT != 0 || e.offset > size ||
+        e.npoints > size / sizeof(double) ||
+        block_bytes(e.npoints) > size - e.offset || !(e.awr > 0.) ||
+        !(e.nu >= 0.)) {
+      std::string mssg = fname + " has a corrupted index.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+
+    names_.emplace_back(name);
+    entries_.push_back(e);
+    if (!index_.emplace(names_.back(), n).second) {
+      std::string mssg = fname + " holds " + names_.back() + " twice.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+  }
+
+  if (verify && !this->verify()) {
+    std::string mssg = fname + " does not match its checksum.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+}
+
+std::shared_ptr<Nuclide> NuclearDataLibrary::nuclide(
+    const std::string& name) const {
+  auto it = index_.find(name);
+  if (it == index_.end()) {
+    std::string mssg = "No nuclide " + name + " in " + file_->fname() + ".";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  const Entry& e = entries_[it->second];
+  const size_t n = e.npoints;
+  const unsigned char* block = file_->data() + e.offset;
+  auto table = [&](size_t i) {
+    return ArrayView<double>(
+        reinterpret_cast<const double*>(block + i * table_bytes(n)), n);
+  };
+
+  // The grid and the hash are read to be checked, as a bad grid or a hash
+  // pointing past the grid would send lookups outside of the tables. The
+  // cross sections are not read.
+  ArrayView<double> energy = table(0);
+  for (size_t i = 0; i + 1 < n; i++) {
+    if (!(energy[i] <= energy[i + 1])) {
+      std::string mssg = "Nuclide " + name + " in " + file_->fname() +
+                         " has an unsorted energy grid.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+  }
+
+  LogHash hash;
+  if (same_hash_) {
+    const uint32_t* lower =
+        reinterpret_cast<const uint32_t*>(block + 5 * table_bytes(n));
+    for (size_t b = 0; b < LogHash::TABLE_SIZE; b++) {
+      if (lower[b] > n - 2 || (b > 0 && lower[b] < lower[b - 1])) {
+        std::string mssg = "Nuclide " + name + " in " + file_->fname() +
+                           " has a corrupted grid hash.";
+        throw PMCException(mssg, __FILE__, __LINE__);
+      }
+    }
+    hash = LogHash(lower, file_);
+  } else {
+    hash = LogHash(energy);
+  }
+
+  return std::make_shared<Nuclide>(name, e.awr, e.nu,
+                                   (e.flags & FLAG_FISSILE) != 0, energy,
+                                   table(1), table(2), table(3), table(4),
+                                   std::move(hash), file_);
+}
+
+uint64_t NuclearDataLibrary::stored_checksum() const {
+  return get<uint64_t>(file_->data(), H_CHECKSUM);
+}
+
+uint64_t NuclearDataLibrary::computed_checksum() const {
+  unsigned char header[HEADER_SIZE];
+  std::memcpy(header, file_->data(), HEADER_SIZE);
+  std::memset(header + H_CHECKSUM, 0, sizeof(uint64_t));
+  return checksum(file_->data() + HEADER_SIZE, file_->size() - HEADER_SIZE,
+                  checksum(header, HEADER_SIZE));
+}
+
+void NuclearDataLibrary::write(
+    const std::string& fname,
+    const std::vector<std::shared_ptr<const Nuclide>>& nuclides) {
+  if (!little_endian()) {
+    std::string mssg = "Nuclear data libraries can only be written on "
+                       "little-endian hosts.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  size_t size = aligned(HEADER_SIZE + nuclides.size() * ENTRY_SIZE);
+  std::vector<size_t> offsets;
+  std::unordered_map<std::string, size_t> seen;
+  for (const auto& nuc : nuclides) {
+    if (nuc->name().empty() || nuc->name().size() > MAX_NAME_LENGTH) {
+      std::string mssg = "The name of nuclide " + nuc->name() +
+                         " must have between 1 and " +
+                         std::to_string(MAX_NAME_LENGTH) + " characters.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    if (nuc->energy().size() > UINT32_MAX) {
+      std::string mssg = "Nuclide " + nuc->name() + " has too many points.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    if (!seen.emplace(nuc->name(), offsets.size()).second) {
+      std::string mssg = "Nuclide " + nuc->name() + " was given twice.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    offsets.push_back(size);
+    size += block_bytes(nuc->energy().size());
+  }
+
+  std::vector<unsigned char> buffer(size, 0);
+  std::memcpy(buffer.data() + H_MAGIC, MAGIC, sizeof(MAGIC));
+  put<uint32_t>(buffer, H_MAJOR, VERSION_MAJOR);
+  put<uint32_t>(buffer, H_MINOR, VERSION_MINOR);
+  put<uint32_t>(buffer, H_ENDIAN, ENDIAN_MARK);
+  put<uint32_t>(buffer, H_NNUCLIDES, static_cast<uint32_t>(nuclides.size()));
+  put<uint64_t>(buffer, H_FILE_SIZE, size);
+  put<uint32_t>(buffer, H_HASH_BINS, static_cast<uint32_t>(LogHash::NBINS));
+  put<double>(buffer, H_HASH_E_MIN, LogHash::E_MIN);
+  put<double>(buffer, H_HASH_E_MAX, LogHash::E_MAX);
+
+  for (size_t n = 0; n < nuclides.size(); n++) {
+    const Nuclide& nuc = *nuclides[n];
+    const size_t entry = HEADER_SIZE + n * ENTRY_SIZE;
+    const size_t npoints = nuc.energy().size();
+    std::memcpy(buffer.data() + entry + E_NAME, nuc.name().data(),
+                nuc.name().size());
+    put<double>(buffer, entry + E_AWR, nuc.awr());
+    put<double>(buffer, entry + E_NU, nuc.nu());
+    put<uint32_t>(buffer, entry + E_NPOINTS, static_cast<uint32_t>(npoints));
+    put<uint32_t>(buffer, entry + E_FLAGS, nuc.fissile() ? FLAG_FISSILE : 0);
+    put<uint64_t>(buffer, entry + E_OFFSET, offsets[n]);
+
+    const ArrayView<double> tables[5] = {nuc.energy(), nuc.total(),
+                                         nuc.elastic(), nuc.capture(),
+                                         nuc.fission()};
+    size_t offset = offsets[n];
+    for (const auto& table : tables) {
+      std::memcpy(buffer.data() + offset, table.data(),
+                  npoints * sizeof(double));
+      offset += table_bytes(npoints);
+    }
+    std::memcpy(buffer.data() + offset, nuc.hash().table(),
+                LogHash::TABLE_SIZE * sizeof(uint32_t));
+  }
+
+  // The checksum field is still zero
+  put<uint64_t>(buffer, H_CHECKSUM, checksum(buffer.data(), size));
+
+  std::ofstream file(fname, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(buffer.data()),
+             static_cast<std::streamsize>(size));
+  if (!file) {
+    std::string mssg = "Could not write the nuclear data library " + fname +
+                       ".";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+}
+
+uint64_t NuclearDataLibrary::checksum(const unsigned char* data, size_t size,
+                                      uint64_t hash) {
+  for (size_t i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+}  // namespace pmc
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/materials/nuclide.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+namespace pmc {
+
+namespace {
+
+// Tables owned by a nuclide built from vectors
+struct NuclideTables {
+  std::vector<double> energy;
+  std::vector<double> total;
+  std::vector<double> elastic;
+  std::vector<double> capture;
+  std::vector<double> fission;
+};
+
+}  // namespace
+
+Nuclide::Nuclide(const std::string& name, double awr,
+                 std::vector<double> energy, std::vector<double> elastic,
+                 std::vector<double> capture, std::vector<double> fission,
+                 double nu)
+    : name_(name),
+      awr_(awr),
+      nu_(nu),
+      fissile_(false),
+      storage_(),
+      energy_(),
+      total_(),
+      elastic_(),
+      capture_(),
+      fission_(),
+      hash_() {
+  if (awr_ <= 0.) {
+    std::string mssg = "Nuclide " + name_ + " must have a positive AWR.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (nu_ < 0.) {
+    std::string mssg = "Nuclide " + name_ + " must have a positive nu.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (energy.size() < 2) {
+    std::string mssg =
+        "Nuclide " + name_ + " must have at least two energy points.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (elastic.size() != energy.size() || capture.size() != energy.size() ||
+      fission.size() != energy.size()) {
+    std::string mssg = "Nuclide " + name_ +
+                       " has cross sections and an energy grid of different "
+                       "lengths.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  auto tables = std::make_shared<NuclideTables>();
+  tables->total.reserve(energy.size());
+  for (size_t i = 0; i < energy.size(); i++) {
+    if (energy[i] <= 0. || (i > 0 && energy[i] <= energy[i - 1])) {
+      std::string mssg = "Nuclide " + name_ +
+                         " must have a positive, strictly increasing energy "
+                         "grid.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+
+    if (elastic[i] < 0. || capture[i] < 0. || fission[i] < 0.) {
+      std::string mssg =
+          "Nuclide " + name_ + " has a negative cross section.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+
+    tables->total.push_back(elastic[i] + capture[i] + fission[i]);
+    if (fission[i] > 0.) fissile_ = true;
+  }
+
+  tables->energy = std::move(energy);
+  tables->elastic = std::move(elastic);
+  tables->capture = std::move(capture);
+  tables->fission = std::move(fission);
+  energy_ = tables->energy;
+  total_ = tables->total;
+  elastic_ = tables->elastic;
+  capture_ = tables->capture;
+  fission_ = tables->fission;
+  hash_ = LogHash(energy_);
+  storage_ = std::move(tables);
+}
+
+Nuclide::Nuclide(const std::string& name, double awr, double nu,
+                 bool fissile, ArrayView<double> energy, ArrayView<double> total,
+                 ArrayView<double> elastic, ArrayView<double> capture,
+                 ArrayView<double> fission, LogHash hash,
+                 std::shared_ptr<const void> storage)
+    : name_(name),
+      awr_(awr),
+      nu_(nu),
+      fissile_(fissile),
+      storage_(std::move(storage)),
+      energy_(energy),
+      total_(total),
+      elastic_(elastic),
+      capture_(capture),
+      fission_(fission),
+      hash_(std::move(hash)) {
+  if (awr_ <= 0. || nu_ < 0. || energy_.size() < 2 ||
+      total_.size() != energy_.size() || elastic_.size() != energy_.size() ||
+      capture_.size() != energy_.size() || fission_.size() != energy_.size() ||
+      hash_.table() == nullptr) {
+    std::string mssg = "Nuclide " + name_ + " was given inconsistent tables.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+}
+
+size_t Nuclide::memory() const {
+  return sizeof(Nuclide) + name_.capacity() +
+         sizeof(double) * 5 * energy_.size() + hash_.memory();
+}
+
+}  // namespace pmc
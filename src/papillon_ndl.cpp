@@ -0,0 +1,182 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/materials/nuclear_data_library.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const std::string papillon_ndl_help =
+  " Converts tabulated cross sections to a Papillon nuclear data library,\n"
+  " which is memory mapped by the transport code.\n\n"
+
+  " Usage:\n"
+  "   papillon-ndl (--output FILE) INPUT...\n"
+  "   papillon-ndl (--verify FILE)\n"
+  "   papillon-ndl (-h | --help)\n\n"
+
+  " Options:\n"
+  "   -h --help         Show this screen\n"
+  "   -o --output FILE  Write the library to FILE\n"
+  "   --verify FILE     Check the header, index and checksum of FILE\n\n"
+
+  " Input files hold one or more nuclides, each given as\n\n"
+
+  "   nuclide NAME AWR NU\n"
+  "   ENERGY ELASTIC CAPTURE FISSION\n"
+  "   ...\n"
+  "   end\n\n"
+
+  " with energies in MeV and cross sections in barns. Lines starting\n"
+  " with # are ignored.\n";
+
+using namespace pmc;
+
+static std::vector<std::shared_ptr<const Nuclide>> read_nuclides(
+    const std::string& fname) {
+  std::ifstream file(fname);
+  if (!file) {
+    std::string mssg = "Could not open the file " + fname + ".";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  std::vector<std::shared_ptr<const Nuclide>> nuclides;
+  std::string line, name;
+  double awr = 0., nu = 0.;
+  std::vector<double> energy, elastic, capture, fission;
+  bool in_nuclide = false;
+  size_t line_number = 0;
+  while (std::getline(file, line)) {
+    line_number++;
+    std::istringstream in(line);
+    std::string word;
+    if (!(in >> word) || word[0] == '#') continue;
+
+    std::string where = fname + ":" + std::to_string(line_number);
+    if (word == "nuclide") {
+      if (in_nuclide || !(in >> name >> awr >> nu)) {
+        std::string mssg = "Bad nuclide card at " + where + ".";
+        throw PMCException(mssg, __FILE__, __LINE__);
+      }
+      in_nuclide = true;
+    } else if (word == "end") {
+      if (!in_nuclide) {
+        std::string mssg = "Unexpected end at " + where + ".";
+        throw PMCException(mssg, __FILE__, __LINE__);
+      }
+      nuclides.push_back(std::make_shared<const Nuclide>(
+          name, awr, std::move(energy), std::move(elastic),
+          std::move(capture), std::move(fission), nu));
+      energy.clear();
+      elastic.clear();
+      capture.clear();
+      fission.clear();
+      in_nuclide = false;
+    } else {
+      std::istringstream point(line);
+      double E, el, cap, fis;
+      if (!in_nuclide || !(point >> E >> el >> cap >> fis)) {
+        std::string mssg = "Bad cross section line at " + where + ".";
+        throw PMCException(mssg, __FILE__, __LINE__);
+      }
+      energy.push_back(E);
+      elastic.push_back(el);
+      capture.push_back(cap);
+      fission.push_back(fis);
+    }
+  }
+
+  if (in_nuclide) {
+    std::string mssg = "Nuclide " + name + " in " + fname + " has no end.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  return nuclides;
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> args(argv + 1, argv + argc);
+  std::string output, verify;
+  std::vector<std::string> inputs;
+  for (size_t i = 0; i < args.size(); i++) {
+    if (args[i] == "-h" || args[i] == "--help") {
+      std::cout << papillon_ndl_help;
+      return 0;
+    } else if ((args[i] == "-o" || args[i] == "--output") &&
+               i + 1 < args.size()) {
+      output = args[++i];
+    } else if (args[i] == "--verify" && i + 1 < args.size()) {
+      verify = args[++i];
+    } else if (!args[i].empty() && args[i][0] == '-') {
+      std::cerr << " Unknown option " << args[i] << "\n\n" << papillon_ndl_help;
+      return 1;
+    } else {
+      inputs.push_back(args[i]);
+    }
+  }
+
+  if (verify.empty() == (output.empty() || inputs.empty())) {
+    std::cerr << papillon_ndl_help;
+    return 1;
+  }
+
+  try {
+    if (!verify.empty()) {
+      NuclearDataLibrary library(verify);
+      bool ok = library.verify();
+      std::cout << " " << verify << ": " << library.size() << " nuclides, "
+                << (ok ? "checksum OK" : "CHECKSUM MISMATCH") << "\n";
+      for (const auto& name : library.names()) std::cout << "   " << name << "\n";
+      return ok ? 0 : 1;
+    }
+
+    std::vector<std::shared_ptr<const Nuclide>> nuclides;
+    for (const auto& input : inputs) {
+      auto read = read_nuclides(input);
+      nuclides.insert(nuclides.end(), read.begin(), read.end());
+    }
+    NuclearDataLibrary::write(output, nuclides);
+    std::cout << " Wrote " << nuclides.size() << " nuclides to " << output
+              << "\n";
+  } catch (const PMCException& err) {
+    std::cerr << err.what() << "\n";
+    return 1;
+  }
+
+  return 0;
+}
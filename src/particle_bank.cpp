@@ -0,0 +1,135 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/transport/particle_bank.hpp>
+#include <algorithm>
+
+namespace pmc {
+
+ParticleBank::ParticleBank(size_t capacity)
+    : navigators(),
+      rngs(),
+      energy(),
+      weight(),
+      material(),
+      sigma_t(),
+      nu_fission(),
+      track_length(),
+      boundary_distance(),
+      boundary_surface(),
+      batched(),
+      by_node_(),
+      x_(),
+      y_(),
+      z_(),
+      u_(),
+      v_(),
+      w_(),
+      d_(),
+      distance_(),
+      surface_() {
+  navigators.reserve(capacity);
+  rngs.reserve(capacity);
+  energy.reserve(capacity);
+  weight.reserve(capacity);
+  material.reserve(capacity);
+  sigma_t.reserve(capacity);
+  nu_fission.reserve(capacity);
+  track_length.reserve(capacity);
+}
+
+void ParticleBank::load(Geometry& geometry,
+                        const std::vector<SourceSite>& sites, size_t first,
+                        size_t n, uint64_t seed, uint64_t batch) {
+  navigators.clear();
+  rngs.clear();
+  energy.clear();
+  weight.clear();
+  for (size_t i = first; i < first + n; i++) {
+    navigators.emplace_back(&geometry, sites[i].r, sites[i].u);
+    rngs.emplace_back(seed, batch, i);
+    energy.push_back(sites[i].energy);
+    weight.push_back(sites[i].weight);
+  }
+  material.assign(n, nullptr);
+  sigma_t.assign(n, 0.);
+  nu_fission.assign(n, 0.);
+  track_length.assign(n, 0.);
+  boundary_distance.assign(n, INF);
+  boundary_surface.assign(n, 0);
+  batched.assign(n, 0);
+}
+
+void ParticleBank::find_volume_boundaries(const std::vector<uint32_t>& queue) {
+  by_node_.clear();
+  for (uint32_t i : queue)
+    by_node_.push_back({navigators[i].current_node(), i});
+  std::sort(by_node_.begin(), by_node_.end());
+
+  for (size_t first = 0; first < by_node_.size();) {
+    const GeoNode* node = by_node_[first].first;
+    size_t last = first;
+    while (last < by_node_.size() && by_node_[last].first == node) last++;
+    const size_t n = last - first;
+
+    for (auto* a : {&x_, &y_, &z_, &u_, &v_, &w_, &d_, &distance_}) a->resize(n);
+    surface_.resize(n);
+    for (size_t k = 0; k < n; k++) {
+      const GeoNavigator& nav = navigators[by_node_[first + k].second];
+      Position r = nav.r_local();
+      Direction u = nav.u_local();
+      x_[k] = r.x();
+      y_[k] = r.y();
+      z_[k] = r.z();
+      u_[k] = u.x();
+      v_[k] = u.y();
+      w_[k] = u.z();
+    }
+
+    bool done = node->distance_to_boundary_batch(
+        x_.data(), y_.data(), z_.data(), u_.data(), v_.data(), w_.data(),
+        d_.data(), n, distance_.data(), surface_.data());
+    for (size_t k = 0; k < n; k++) {
+      uint32_t i = by_node_[first + k].second;
+      batched[i] = done;
+      if (done) {
+        boundary_distance[i] = distance_[k];
+        boundary_surface[i] = surface_[k];
+      }
+    }
+
+    first = last;
+  }
+}
+
+}  // namespace pmc
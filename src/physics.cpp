@@ -0,0 +1,102 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/transport/physics.hpp>
+#include <algorithm>
+
+namespace pmc {
+
+Direction rotate_direction(const Direction& u, double mu, double phi) {
+  double sin_theta = std::sqrt(std::max(0., 1. - mu * mu));
+  double cos_phi = std::cos(phi);
+  double sin_phi = std::sin(phi);
+
+  // Rotate about z, unless u is too close to it, in which case y is used
+  double b = std::sqrt(std::max(0., 1. - u.z() * u.z()));
+  if (b > 1.E-10) {
+    return Direction(
+        mu * u.x() + sin_theta * (u.x() * u.z() * cos_phi - u.y() * sin_phi) / b,
+        mu * u.y() + sin_theta * (u.y() * u.z() * cos_phi + u.x() * sin_phi) / b,
+        mu * u.z() - sin_theta * b * cos_phi);
+  }
+
+  b = std::sqrt(1. - u.y() * u.y());
+  return Direction(
+      mu * u.x() + sin_theta * (u.x() * u.y() * cos_phi + u.z() * sin_phi) / b,
+      mu * u.y() - sin_theta * b * cos_phi,
+      mu * u.z() + sin_theta * (u.y() * u.z() * cos_phi - u.x() * sin_phi) / b);
+}
+
+CollisionType collide(const Material& material, double& E, Direction& u,
+                      RNG& rng) {
+  const Nuclide* target = nullptr;
+  return collide(material, E, u, rng, target);
+}
+
+CollisionType collide(const Material& material, double& E, Direction& u,
+                      RNG& rng, const Nuclide*& target) {
+  const Nuclide& nuclide = material.nuclide(material.sample_nuclide(E, rng()));
+  target = &nuclide;
+  MicroXS micro = nuclide.xs(E);
+
+  double xi = rng() * micro.total;
+  if (xi >= micro.elastic + micro.capture) return CollisionType::Fission;
+  if (xi >= micro.elastic) return CollisionType::Capture;
+
+  // Elastic scatter off of a target at rest, isotropic in the center of
+  // mass frame
+  double A = nuclide.awr();
+  double mu_cm = 2. * rng() - 1.;
+  double denom = A * A + 2. * A * mu_cm + 1.;
+  E *= denom / ((A + 1.) * (A + 1.));
+  double mu_lab = (1. + A * mu_cm) / std::sqrt(denom);
+  if (mu_lab > 1.) mu_lab = 1.;
+  else if (mu_lab < -1.) mu_lab = -1.;
+  double phi = 2. * PI * rng();
+  u = rotate_direction(u, mu_lab, phi);
+  return CollisionType::Scatter;
+}
+
+double sample_fission_energy(RNG& rng) {
+  // Watt spectrum parameters of ENDF/B-VII.1 for U235
+  const double a = 0.988;  // MeV
+  const double b = 2.249;  // 1/MeV
+
+  // Energy w from a Maxwellian of temperature a, from which the Watt
+  // energy follows, as in MCNP and OpenMC
+  double c = std::cos(0.5 * PI * rng());
+  double w = -a * (std::log(1. - rng()) + std::log(1. - rng()) * c * c);
+  return w + 0.25 * a * a * b + (2. * rng() - 1.) * std::sqrt(a * a * b * w);
+}
+
+}  // namespace pmc
@@ -34,7 +34,8 @@
 #include <Papillon/geometry/surfaces/plane.hpp>
 #include <Papillon/utils/constants.hpp>
 
-#include<cmath>
+#include <array>
+#include <cmath>
 
 namespace pmc {
   
@@ -59,4 +60,42 @@ namespace pmc {
   }
 
   Direction Plane::normal(const Position& /*r*/) const {return {A, B, C};}
+
+  void Plane::distance_batch(const double* __restrict x, const double* __restrict y,
+      const double* __restrict z, const double* __restrict u, const double* __restrict v,
+      const double* __restrict w, double* __restrict d, size_t n,
+      const uint32_t* on_surf) const {
+    // Every case is a select rather than a branch, so that the loop is
+    // vectorized. A direction parallel to the plane makes an infinity or a
+    // NaN, which is then replaced.
+    const double a = A, b = B, c = C, d0 = D;
+    const double inf = INF, coincident = SURFACE_COINCIDENT;
+    #pragma omp simd
+    for(size_t i = 0; i < n; i++) {
+      double num = d0 - a*x[i] - b*y[i] - c*z[i];
+      double denom = a*u[i] + b*v[i] + c*w[i];
+      double di = num / denom;
+      double dist = (di < 0.) ? inf : di;
+      dist = (std::fabs(di) < coincident) ? inf : dist;
+      d[i] = (denom == 0.) ? inf : dist;
+    }
+    mask_on_surface(on_surf, d, n);
+  }
+
+  AABB Plane::bounding_box(Side side) const {
+    // Only planes normal to one of the axes bound their half-spaces
+    std::array<double,3> n{A, B, C};
+    for(size_t i = 0; i < 3; i++) {
+      if(n[i] == 0. || n[(i+1)%3] != 0. || n[(i+2)%3] != 0.) continue;
+
+      Position lo(-INF, -INF, -INF);
+      Position hi(INF, INF, INF);
+      // A positive coefficient puts the positive side above the plane
+      bool above = (side == Side::Positive) == (n[i] > 0.);
+      if(above) lo[i] = D / n[i];
+      else hi[i] = D / n[i];
+      return AABB(lo, hi);
+    }
+    return AABB();
+  }
 }
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/geometry/csg/ray.hpp>
+
+namespace pmc {
+
+Ray Ray::unite(const Ray& a, const Ray& b) {
+  Ray out;
+  size_t i = 0, j = 0;
+  bool open = false;
+  RayInterval current{};
+
+  while (i < a.size_ || j < b.size_) {
+    // Take the interval which starts first
+    const RayInterval& next =
+        (j == b.size_ ||
+         (i < a.size_ && a[i].enter.distance <= b[j].enter.distance))
+            ? a[i++]
+            : b[j++];
+
+    if (!open) {
+      current = next;
+      open = true;
+    } else if (next.enter.distance <= current.exit.distance) {
+      // Overlapping or touching intervals merge
+      if (current.exit < next.exit) current.exit = next.exit;
+    } else {
+      out.push_back(current);
+      current = next;
+    }
+  }
+  if (open) out.push_back(current);
+
+  out.clip(a.limit_ < b.limit_ ? a.limit_ : b.limit_);
+  return out;
+}
+
+Ray Ray::intersect(const Ray& a, const Ray& b) {
+  Ray out;
+  size_t i = 0, j = 0;
+
+  while (i < a.size_ && j < b.size_) {
+    const SurfaceCrossing& enter =
+        a[i].enter < b[j].enter ? b[j].enter : a[i].enter;
+    const SurfaceCrossing& exit = a[i].exit < b[j].exit ? a[i].exit : b[j].exit;
+    if (enter.distance < exit.distance) out.push_back({enter, exit});
+
+    // The interval which ends first cannot overlap anything else
+    if (a[i].exit < b[j].exit) i++;
+    else j++;
+  }
+
+  out.clip(a.limit_ < b.limit_ ? a.limit_ : b.limit_);
+  return out;
+}
+
+Ray Ray::complement(const Ray& a) {
+  Ray out;
+  SurfaceCrossing start{0., 0, Surface::Side::Positive};
+
+  for (const auto& interval : a) {
+    if (start.distance < interval.enter.distance)
+      out.push_back({start, interval.enter});
+    start = interval.exit;
+  }
+  if (start.distance < INF)
+    out.push_back({start, {INF, 0, Surface::Side::Positive}});
+
+  out.clip(a.limit_);
+  return out;
+}
+
+Ray Ray::subtract(const Ray& a, const Ray& b) {
+  return intersect(a, complement(b));
+}
+
+void Ray::clip(const SurfaceCrossing& limit) {
+  if (!(limit < limit_)) return;
+  limit_ = limit;
+  while (size_ > 0 && !(intervals_[size_ - 1].enter < limit_)) size_--;
+  if (size_ > 0 && limit_ < intervals_[size_ - 1].exit)
+    intervals_[size_ - 1].exit = limit_;
+}
+
+}  // namespace pmc
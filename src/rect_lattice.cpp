@@ -0,0 +1,128 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/geometry/rect_lattice.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+namespace pmc {
+
+RectLattice::RectLattice(std::shared_ptr<Volume> v, uint32_t nx, uint32_t ny,
+                         uint32_t nz, double px, double py, double pz,
+                         Position lower_left, const std::string& name)
+    : GeoNode(v, name),
+      shape_{nx, ny, nz},
+      pitch_{px, py, pz},
+      inv_pitch_{},
+      lower_left_(lower_left),
+      grid_box_(),
+      elements_() {
+  is_lattice_ = true;
+
+  Position upper_right;
+  for (size_t a = 0; a < 3; a++) {
+    if (shape_[a] == 0) {
+      std::string mssg = "RectLattice " + name + " has no elements along an axis.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    if (pitch_[a] <= 0.) {
+      std::string mssg = "RectLattice " + name + " has a non-positive pitch.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+
+    if (pitch_[a] == INF) {
+      if (shape_[a] != 1) {
+        std::string mssg = "RectLattice " + name +
+                           " is infinite along an axis with several elements.";
+        throw PMCException(mssg, __FILE__, __LINE__);
+      }
+      inv_pitch_[a] = 0.;
+      lower_left_[a] = -INF;
+      upper_right[a] = INF;
+    } else {
+      inv_pitch_[a] = 1. / pitch_[a];
+      upper_right[a] = lower_left_[a] + shape_[a] * pitch_[a];
+    }
+  }
+  grid_box_ = AABB(lower_left_, upper_right);
+
+  elements_.resize(static_cast<size_t>(nx) * ny * nz,
+                   {nullptr, Transformation(), Transformation()});
+}
+
+void RectLattice::set_element(uint32_t i, uint32_t j, uint32_t k,
+                              std::shared_ptr<GeoNode> universe) {
+  if (i >= shape_[0] || j >= shape_[1] || k >= shape_[2]) {
+    std::string mssg = "Element (" + std::to_string(i) + "," +
+                       std::to_string(j) + "," + std::to_string(k) +
+                       ") is outside of RectLattice " + name() + ".";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  Element& e = elements_[flat_index(i, j, k)];
+  e.universe = universe.get();
+  if (!universe) return;
+
+  add_universe(universe);
+
+  std::array<uint32_t, 3> ijk{i, j, k};
+  Position center;
+  for (size_t a = 0; a < 3; a++) {
+    if (pitch_[a] == INF)
+      center[a] = 0.;
+    else
+      center[a] = lower_left_[a] + (ijk[a] + 0.5) * pitch_[a];
+  }
+
+  // The universe may carry its own transformation, which is applied in the
+  // frame of the element.
+  e.to_universe = universe->transformation() *
+                  Transformation::translation(-center.x(), -center.y(), -center.z());
+  e.to_lattice = e.to_universe.inverse();
+}
+
+void RectLattice::fill(std::shared_ptr<GeoNode> universe) {
+  for (uint32_t k = 0; k < shape_[2]; k++)
+    for (uint32_t j = 0; j < shape_[1]; j++)
+      for (uint32_t i = 0; i < shape_[0]; i++) set_element(i, j, k, universe);
+}
+
+std::unique_ptr<GeoNode> RectLattice::clone() const {
+  auto new_this = std::make_unique<RectLattice>(
+      volume(), shape_[0], shape_[1], shape_[2], pitch_[0], pitch_[1],
+      pitch_[2], lower_left_, name());
+  new_this->elements_ = elements_;
+  clone_into(*new_this);
+  return new_this;
+}
+
+}  // namespace pmc
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/utils/rng.hpp>
+
+namespace pmc {
+
+void RNG::next_event(RNG* rngs, const uint32_t* indices, size_t n) {
+  size_t i = 0;
+  for (; i + 1 < n; i += 2) {
+    RNG& a = rngs[indices[i]];
+    RNG& b = rngs[indices[i + 1]];
+    a.set_event(a.counter_[1] + 1);
+    b.set_event(b.counter_[1] + 1);
+    a.buffer_ = philox(a.counter_, a.key_);
+    b.buffer_ = philox(b.counter_, b.key_);
+    a.counter_[2] = b.counter_[2] = 1;
+    a.position_ = b.position_ = 0;
+  }
+  if (i < n) {
+    RNG& a = rngs[indices[i]];
+    a.next_event();
+    a.refill();
+  }
+}
+
+void RNG::fill(double* out, size_t n) {
+  size_t i = 0;
+  while (i < n && position_ != BLOCK) out[i++] = (*this)();
+
+  Block c = counter_;
+  for (; n - i >= 2 * BLOCK; i += 2 * BLOCK) {
+    Block a = philox(c, key_);
+    c[2]++;
+    Block b = philox(c, key_);
+    c[2]++;
+    for (size_t w = 0; w < BLOCK; w++) {
+      out[i + w] = to_double(a[w]);
+      out[i + BLOCK + w] = to_double(b[w]);
+    }
+  }
+  counter_ = c;
+
+  while (i < n) out[i++] = (*this)();
+}
+
+}  // namespace pmc
@@ -56,7 +56,7 @@ namespace pmc {
   double Sphere::distance(const Position& r, const Direction& u, uint32_t on_surf) const {
     double x = r.x() - x0;
     double y = r.y() - y0;
-    double z = r.y() - z0;
+    double z = r.z() - z0;
     double k = x*u.x() + y*u.y() + z*u.z();
     double c = x*x + y*y + z*z - R*R;
     double quad = k*k - c;
@@ -82,4 +82,39 @@ namespace pmc {
     double z = r.z() - z0;
     return {x,y,z};
   }
+
+  AABB Sphere::bounding_box(Side side) const {
+    if(side == Side::Positive) return AABB();
+    return AABB({x0 - R, y0 - R, z0 - R}, {x0 + R, y0 + R, z0 + R});
+  }
+
+  void Sphere::distance_batch(const double* __restrict x, const double* __restrict y,
+      const double* __restrict z, const double* __restrict u, const double* __restrict v,
+      const double* __restrict w, double* __restrict d, size_t n,
+      const uint32_t* on_surf) const {
+    // Both roots are always evaluated, and the right one is then selected,
+    // so that the loop is vectorized
+    const double cx = x0, cy = y0, cz = z0, R2 = R*R;
+    const double inf = INF, coincident = SURFACE_COINCIDENT;
+    #pragma omp simd
+    for(size_t i = 0; i < n; i++) {
+      double xi = x[i] - cx;
+      double yi = y[i] - cy;
+      double zi = z[i] - cz;
+      double k = xi*u[i] + yi*v[i] + zi*w[i];
+      double c = xi*xi + yi*yi + zi*zi - R2;
+      double quad = k*k - c;
+
+      double sq = std::sqrt((quad < 0.) ? 0. : quad);
+      double d_far = -k + sq;
+      double d_near = -k - sq;
+
+      double di = (d_near < 0.) ? inf : d_near;
+      di = (c < 0.) ? d_far : di;
+      double on = (k >= 0.) ? inf : d_far;
+      di = (std::fabs(c) < coincident) ? on : di;
+      d[i] = (quad < 0.) ? inf : di;
+    }
+    mask_on_surface(on_surf, d, n);
+  }
 }
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/geometry/surfaces/plane.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/surface_table.hpp>
+#include <Papillon/geometry/surfaces/xcylinder.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/ycylinder.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <Papillon/geometry/surfaces/zplane.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace pmc {
+
+SurfaceTable::SurfaceTable()
+    : entries_(1, Entry{Type::None, Surface::BoundaryType::Transparent, 0,
+                        {0., 0., 0., 0.}}),
+      surfaces_(1, nullptr),
+      id_to_index_() {}
+
+SurfaceTable::SurfaceTable(
+    const std::unordered_map<uint32_t, std::shared_ptr<Surface>>& surfs)
+    : SurfaceTable() {
+  // Surfaces are placed in order of increasing id, so that the indices do
+  // not depend on the iteration order of the map.
+  std::vector<uint32_t> ids;
+  ids.reserve(surfs.size());
+  for (const auto& surf : surfs) ids.push_back(surf.first);
+  std::sort(ids.begin(), ids.end());
+
+  entries_.reserve(ids.size() + 1);
+  surfaces_.reserve(ids.size() + 1);
+  for (const auto& id : ids) {
+    const std::shared_ptr<Surface>& surf = surfs.at(id);
+    if (surf->id() != id) {
+      std::string mssg = "surface with id " + std::to_string(surf->id()) +
+                         " is stored under key " + std::to_string(id) + ".";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+
+    uint32_t indx = static_cast<uint32_t>(entries_.size());
+    entries_.push_back(make_entry(*surf));
+    surfaces_.push_back(surf);
+    id_to_index_[id] = indx;
+  }
+}
+
+uint32_t SurfaceTable::index(uint32_t id) const {
+  uint32_t indx = find(id);
+  if (indx == 0) {
+    std::string mssg = "Cannot find surface with id " + std::to_string(id) + ".";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+  return indx;
+}
+
+SurfaceTable::Entry SurfaceTable::make_entry(const Surface& surf) {
+  Entry e{Type::None, surf.boundary(), surf.id(), {0., 0., 0., 0.}};
+
+  if (auto s = dynamic_cast<const XPlane*>(&surf)) {
+    e.type = Type::XPlane;
+    e.c[0] = s->x0;
+  } else if (auto s = dynamic_cast<const YPlane*>(&surf)) {
+    e.type = Type::YPlane;
+    e.c[0] = s->y0;
+  } else if (auto s = dynamic_cast<const ZPlane*>(&surf)) {
+    e.type = Type::ZPlane;
+    e.c[0] = s->z0;
+  } else if (auto s = dynamic_cast<const Plane*>(&surf)) {
+    e.type = Type::Plane;
+    e.c = {s->A, s->B, s->C, s->D};
+  } else if (auto s = dynamic_cast<const XCylinder*>(&surf)) {
+    e.type = Type::XCylinder;
+    e.c = {s->y0, s->z0, s->R, 0.};
+  } else if (auto s = dynamic_cast<const YCylinder*>(&surf)) {
+    e.type = Type::YCylinder;
+    e.c = {s->x0, s->z0, s->R, 0.};
+  } else if (auto s = dynamic_cast<const ZCylinder*>(&surf)) {
+    e.type = Type::ZCylinder;
+    e.c = {s->x0, s->y0, s->R, 0.};
+  } else if (auto s = dynamic_cast<const Sphere*>(&surf)) {
+    e.type = Type::Sphere;
+    e.c = {s->x0, s->y0, s->z0, s->R};
+  } else {
+    std::string mssg = "surface with id " + std::to_string(surf.id()) +
+                       " has a type which cannot be placed in a SurfaceTable.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  return e;
+}
+
+}  // namespace pmc
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/materials/material.hpp>
+#include <Papillon/tallies/tally.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+
+namespace pmc {
+
+Tally::Tally(const std::string& name, size_t nbins,
+             TallyAccumulation accumulation, size_t nshards)
+    : name_(name),
+      nbins_(nbins),
+      accumulation_(accumulation),
+      nshards_(nshards),
+      batches_(0),
+      buffers_(),
+      mean_(nbins, 0.),
+      m2_(nbins, 0.) {
+  if (nbins_ == 0) {
+    std::string mssg = "Tally " + name_ + " must have at least one bin.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (accumulation_ == TallyAccumulation::Sharded) {
+    if (nshards_ == 0) {
+      std::string mssg = "Tally " + name_ + " must have at least one shard.";
+      throw PMCException(mssg, __FILE__, __LINE__);
+    }
+    buffers_.resize(nshards_);
+  } else {
+    buffers_.resize(1);
+  }
+
+  const size_t nlines = (nbins_ + LINE - 1) / LINE;
+  for (auto& buffer : buffers_) buffer.assign(nlines, CacheLine{});
+}
+
+void Tally::prepare(int nthreads) {
+  // Shards are made once, whatever the number of threads
+  if (accumulation_ == TallyAccumulation::Sharded) return;
+
+  const size_t n = nthreads > 0 ? static_cast<size_t>(nthreads) : 1;
+  const size_t nlines = (nbins_ + LINE - 1) / LINE;
+  while (buffers_.size() < n) buffers_.emplace_back(nlines, CacheLine{});
+}
+
+void Tally::end_batch(double normalization) {
+  if (normalization <= 0.) {
+    std::string mssg = "Tally " + name_ + " needs a positive normalization.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  batches_++;
+  const double n = static_cast<double>(batches_);
+  const size_t nlines = (nbins_ + LINE - 1) / LINE;
+
+  // Each line of bins is summed over the buffers, and cleared, by one thread
+#pragma omp parallel for schedule(static)
+  for (size_t l = 0; l < nlines; l++) {
+    for (size_t k = 0; k < LINE && l * LINE + k < nbins_; k++) {
+      double x = 0.;
+      for (auto& buffer : buffers_) {
+        x += buffer[l].value[k];
+        buffer[l].value[k] = 0.;
+      }
+      x /= normalization;
+
+      const size_t bin = l * LINE + k;
+      double delta = x - mean_[bin];
+      mean_[bin] += delta / n;
+      m2_[bin] += delta * (x - mean_[bin]);
+    }
+  }
+}
+
+void Tally::check_scores(const std::vector<TallyScore>& scores) const {
+  if (scores.empty() || scores.size() > MAX_SCORES) {
+    std::string mssg = "Tally " + name_ + " must have between 1 and " +
+                       std::to_string(MAX_SCORES) + " scores.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+}
+
+void Tally::score_xs(const std::vector<TallyScore>& scores,
+                     const Material* material, double E, double* sigma) {
+  MacroXS xs{0., 0., 0., 0., 0.};
+  for (TallyScore score : scores) {
+    if (material && score != TallyScore::Flux) {
+      xs = material->xs(E);
+      break;
+    }
+  }
+
+  for (size_t s = 0; s < scores.size(); s++) {
+    switch (scores[s]) {
+      case TallyScore::Flux:
+        sigma[s] = 1.;
+        break;
+      case TallyScore::Total:
+        sigma[s] = xs.total;
+        break;
+      case TallyScore::Absorption:
+        sigma[s] = xs.capture + xs.fission;
+        break;
+      case TallyScore::Fission:
+        sigma[s] = xs.fission;
+        break;
+      case TallyScore::NuFission:
+        sigma[s] = xs.nu_fission;
+        break;
+    }
+  }
+}
+
+size_t Tally::memory() const {
+  size_t bytes = sizeof(Tally) + sizeof(double) * (mean_.capacity() +
+                                                   m2_.capacity());
+  for (const auto& buffer : buffers_)
+    bytes += sizeof(CacheLine) * buffer.capacity();
+  return bytes;
+}
+
+}  // namespace pmc
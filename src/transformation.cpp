@@ -42,6 +42,7 @@ namespace pmc {
     data_ = {1., 0., 0., 0.,
              0., 1., 0., 0.,
              0., 0., 1., 0.};
+    kind_ = Kind::Identity;
   }
 
   Transformation Transformation::translation(double x, double y, double z) {
@@ -51,6 +52,8 @@ namespace pmc {
                  0., 1., 0., y,
                  0., 0., 1., z};
 
+    out.kind_ = Kind::Translation;
+
     return out;
   }
 
@@ -61,6 +64,8 @@ namespace pmc {
                  0., 1., 0., v.y(),
                  0., 0., 1., v.z()};
 
+    out.kind_ = Kind::Translation;
+
     return out;
   }
 
@@ -73,6 +78,8 @@ namespace pmc {
                  0., c , -s, 0.,
                  0., s ,  c, 0.};
 
+    out.kind_ = Kind::RotationTranslation;
+
     return out;
   }
 
@@ -85,6 +92,8 @@ namespace pmc {
                  0., 1 , 0., 0.,
                  -s, 0., c , 0.};
 
+    out.kind_ = Kind::RotationTranslation;
+
     return out;
   }
 
@@ -98,6 +107,8 @@ namespace pmc {
                  s , c , 0., 0.,
                  0., 0., 1., 0.};
 
+    out.kind_ = Kind::RotationTranslation;
+
     return out;
   }
 
@@ -108,6 +119,8 @@ namespace pmc {
                  0., s , 0., 0.,
                  0., 0., s , 0.};
 
+    out.kind_ = Kind::General;
+
     return out;
   }
 
@@ -118,6 +131,8 @@ namespace pmc {
                  0., 1., 0., 0.,
                  0., 0., 1., 0.};
 
+    out.kind_ = Kind::General;
+
     return out;
   }
 
@@ -128,6 +143,8 @@ namespace pmc {
                  0., s , 0., 0.,
                  0., 0., 1., 0.};
 
+    out.kind_ = Kind::General;
+
     return out;
   }
 
@@ -138,6 +155,8 @@ namespace pmc {
                  0., 1., 0., 0.,
                  0., 0., s , 0.};
 
+    out.kind_ = Kind::General;
+
     return out;
   }
 
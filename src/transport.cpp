@@ -0,0 +1,647 @@
+/*
+ * Copyright 2021, Hunter Belanger
+ *
+ * hunter.belanger@gmail.com
+ *
+ * Ce logiciel est régi par la licence CeCILL soumise au droit français et
+ * respectant les principes de diffusion des logiciels libres. Vous pouvez
+ * utiliser, modifier et/ou redistribuer ce programme sous les conditions
+ * de la licence CeCILL telle que diffusée par le CEA, le CNRS et l'INRIA
+ * sur le site "http://www.cecill.info".
+ *
+ * En contrepartie de l'accessibilité au code source et des droits de copie,
+ * de modification et de redistribution accordés par cette licence, il n'est
+ * offert aux utilisateurs qu'une garantie limitée.  Pour les mêmes raisons,
+ * seule une responsabilité restreinte pèse sur l'auteur du programme,  le
+ * titulaire des droits patrimoniaux et les concédants successifs.
+ *
+ * A cet égard  l'attention de l'utilisateur est attirée sur les risques
+ * associés au chargement,  à l'utilisation,  à la modification et/ou au
+ * développement et à la reproduction du logiciel par l'utilisateur étant
+ * donné sa spécificité de logiciel libre, qui peut le rendre complexe à
+ * manipuler et qui le réserve donc à des développeurs et des professionnels
+ * avertis possédant  des  connaissances  informatiques approfondies.  Les
+ * utilisateurs sont donc invités à charger  et  tester  l'adéquation  du
+ * logiciel à leurs besoins dans des conditions permettant d'assurer la
+ * sécurité de leurs systèmes et ou de leurs données et, plus généralement,
+ * à l'utiliser et l'exploiter dans les mêmes conditions de sécurité.
+ *
+ * Le fait que vous puissiez accéder à cet en-tête signifie que vous avez
+ * pris connaissance de la licence CeCILL, et que vous en avez accepté les
+ * termes.
+ *
+ * */
+#include <Papillon/geometry/geo_navigator.hpp>
+#include <Papillon/transport/particle_bank.hpp>
+#include <Papillon/transport/physics.hpp>
+#include <Papillon/transport/transport.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <Papillon/utils/threads.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace pmc {
+
+TransportResult& TransportResult::operator+=(const TransportResult& other) {
+  histories += other.histories;
+  secondaries += other.secondaries;
+  collisions += other.collisions;
+  virtual_collisions += other.virtual_collisions;
+  crossings += other.crossings;
+  reflections += other.reflections;
+  leaks += other.leaks;
+  captures += other.captures;
+  fissions += other.fissions;
+  cutoffs += other.cutoffs;
+  lost += other.lost;
+  track_length += other.track_length;
+  k_collision += other.k_collision;
+  k_absorption += other.k_absorption;
+  k_track_length += other.k_track_length;
+  if (source_mesh.size() < other.source_mesh.size())
+    source_mesh.resize(other.source_mesh.size(), 0.);
+  for (size_t i = 0; i < other.source_mesh.size(); i++)
+    source_mesh[i] += other.source_mesh[i];
+  return *this;
+}
+
+TransportResult transport(Geometry& geometry,
+                          const std::vector<SourceSite>& sites,
+                          const TransportSettings& settings) {
+  std::vector<SourceSite> fission_bank;
+  return transport(geometry, sites, settings, fission_bank);
+}
+
+TransportResult transport(Geometry& geometry,
+                          const std::vector<SourceSite>& sites,
+                          const TransportSettings& settings,
+                          std::vector<SourceSite>& fission_bank) {
+  if (settings.mode == TransportMode::Event) {
+    return transport_events(geometry, sites, settings, fission_bank);
+  }
+  return transport_histories(geometry, sites, settings, fission_bank);
+}
+
+TransportResult transport_histories(Geometry& geometry,
+                                    const std::vector<SourceSite>& sites,
+                                    const TransportSettings& settings) {
+  std::vector<SourceSite> fission_bank;
+  return transport_histories(geometry, sites, settings, fission_bank);
+}
+
+TransportResult transport_events(Geometry& geometry,
+                                 const std::vector<SourceSite>& sites,
+                                 const TransportSettings& settings) {
+  std::vector<SourceSite> fission_bank;
+  return transport_events(geometry, sites, settings, fission_bank);
+}
+
+//============================================================================
+// Threads
+namespace {
+
+// Results and banks of one thread, which no other thread touches while
+// transport runs. Each starts on a cache line of its own, so that counting
+// events does not invalidate the lines of other threads.
+struct alignas(64) ThreadBanks {
+  int thread = 0;
+  TransportResult result;
+  std::vector<SourceSite> fission;
+  // History which made each of the fission sites
+  std::vector<uint64_t> fission_history;
+  // Secondaries of the history being run, followed last in first out
+  std::vector<SourceSite> secondary;
+};
+
+// Sums kept for each history, so that they are added up in the order of
+// the histories whatever thread ran them
+struct HistoryScores {
+  double track_length = 0.;
+  double k_collision = 0.;
+  double k_absorption = 0.;
+  double k_track_length = 0.;
+};
+
+// Fission sites made by the histories of one chunk, in the bank of the
+// thread which ran it
+struct ChunkSites {
+  int thread;
+  size_t begin;
+  size_t end;
+};
+
+std::vector<ThreadBanks> make_banks(int nthreads,
+                                   const TransportSettings& settings) {
+  std::vector<ThreadBanks> banks(static_cast<size_t>(nthreads));
+  for (int t = 0; t < nthreads; t++) {
+    ThreadBanks& bank = banks[static_cast<size_t>(t)];
+    bank.thread = t;
+    if (settings.entropy_mesh &&
+        settings.fission_neutrons == FissionNeutrons::Bank)
+      bank.result.source_mesh.assign(settings.entropy_mesh->size(), 0.);
+  }
+  return banks;
+}
+
+// Readies the tallies for the threads. Flights are only scored with surface
+// tracking, as delta tracking does not know the materials it flies through.
+void prepare_tallies(const TransportSettings& settings, int nthreads) {
+  if (settings.tallies.empty()) return;
+  if (settings.tracking != Tracking::Surface) {
+    std::string mssg = "Tallies can only be scored with surface tracking.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+  for (const auto& tally : settings.tallies) tally->prepare(nthreads);
+}
+
+void score_flight(const TransportSettings& settings, int thread,
+                  const GeoNavigator& nav, double distance,
+                  const Material* material, double E, double weight) {
+  for (const auto& tally : settings.tallies)
+    tally->score_flight(thread, nav.r_global(), nav.u_global(), distance,
+                        material, E, weight);
+}
+
+// Sums the results of the threads, with the scores of each history summed
+// in the order of the histories, and puts the fission sites of each
+// chunk in fission_bank in the order of the chunks. The offsets of the
+// chunks in fission_bank come from a prefix sum of their number of sites,
+// after which the chunks are copied in parallel.
+TransportResult gather(const std::vector<ThreadBanks>& banks,
+                       const std::vector<ChunkSites>& chunks,
+                       const std::vector<HistoryScores>& scores,
+                       std::vector<SourceSite>& fission_bank) {
+  TransportResult result;
+  for (const auto& bank : banks) result += bank.result;
+  for (const auto& history : scores) {
+    result.track_length += history.track_length;
+    result.k_collision += history.k_collision;
+    result.k_absorption += history.k_absorption;
+    result.k_track_length += history.k_track_length;
+  }
+
+  std::vector<size_t> offsets(chunks.size() + 1, 0);
+  for (size_t c = 0; c < chunks.size(); c++)
+    offsets[c + 1] = offsets[c] + (chunks[c].end - chunks[c].begin);
+
+  fission_bank.clear();
+  fission_bank.resize(offsets.back());
+  const int nthreads = static_cast<int>(banks.size());
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+  for (size_t c = 0; c < chunks.size(); c++) {
+    const auto& sites = banks[chunks[c].thread].fission;
+    std::copy(sites.begin() + chunks[c].begin, sites.begin() + chunks[c].end,
+              fission_bank.begin() + offsets[c]);
+  }
+  (void)nthreads;
+  return result;
+}
+
+}  // namespace
+
+//============================================================================
+// Events shared by both modes. Each returns false if the particle is killed.
+namespace {
+
+bool is_reflective(const GeoNavigator::Boundary& boundary) {
+  return boundary.surface &&
+         boundary.surface->boundary() == Surface::BoundaryType::Reflective;
+}
+
+// Neutrons born in the fission of target by a neutron of the given weight,
+// at the current position, isotropic, and with energies from the fission
+// spectrum. Their number is nu / keff on average.
+void fission_neutrons(const GeoNavigator& nav, const Nuclide& target,
+                      double weight, uint64_t history, RNG& rng,
+                      const TransportSettings& settings, ThreadBanks& banks) {
+  const FissionNeutrons fate = settings.fission_neutrons;
+  if (fate == FissionNeutrons::Ignore) return;
+
+  int n = sample_fission_yield(target.nu() / settings.keff, rng);
+  if (n > 0 && !banks.result.source_mesh.empty()) {
+    // All of the sites are born at the same place
+    size_t cell = settings.entropy_mesh->cell(nav.r_global());
+    if (cell < banks.result.source_mesh.size())
+      banks.result.source_mesh[cell] += n * weight;
+  }
+  for (int i = 0; i < n; i++) {
+    Direction u(2. * rng() - 1., 2. * PI * rng());
+    SourceSite site{nav.r_global(), u, sample_fission_energy(rng), weight};
+    if (settings.fission_neutrons == FissionNeutrons::Secondary) {
+      banks.secondary.push_back(site);
+    } else {
+      banks.fission.push_back(site);
+      banks.fission_history.push_back(history);
+    }
+  }
+}
+
+// Estimate of k from an absorption in target at E, which is the number of
+// neutrons it gives in fission per absorption
+double absorption_k(const Nuclide& target, double E, double weight) {
+  MicroXS micro = target.xs(E);
+  double absorption = micro.capture + micro.fission;
+  return absorption > 0. ? weight * target.nu() * micro.fission / absorption
+                         : 0.;
+}
+
+// Collision of the particle at its current position, where the material
+// has total and nu-fission cross sections sigma_t and nu_sigma_f
+bool collision_event(GeoNavigator& nav, const Material& material,
+                     double sigma_t, double nu_sigma_f, double& E,
+                     double weight, uint64_t history, RNG& rng,
+                     const TransportSettings& settings, ThreadBanks& banks,
+                     HistoryScores& scores) {
+  TransportResult& result = banks.result;
+  result.collisions++;
+  scores.k_collision += weight * nu_sigma_f / sigma_t;
+  Direction u = nav.u_local();
+  const Nuclide* target = nullptr;
+  switch (collide(material, E, u, rng, target)) {
+    case CollisionType::Capture:
+      result.captures++;
+      scores.k_absorption += absorption_k(*target, E, weight);
+      return false;
+    case CollisionType::Fission:
+      result.fissions++;
+      scores.k_absorption += absorption_k(*target, E, weight);
+      fission_neutrons(nav, *target, weight, history, rng, settings, banks);
+      return false;
+    case CollisionType::Scatter:
+      break;
+  }
+
+  if (E < ENERGY_CUTOFF) {
+    result.cutoffs++;
+    return false;
+  }
+  nav.set_direction(u);
+  return true;
+}
+
+// Moves the particle across its next boundary, which is not reflective
+bool crossing_event(GeoNavigator& nav, TransportResult& result) {
+  GeoNavigator::Boundary boundary = nav.next_boundary();
+  if (boundary.surface &&
+      boundary.surface->boundary() == Surface::BoundaryType::Vacuum) {
+    result.leaks++;
+    return false;
+  }
+
+  nav.cross_next_boundary();
+  nav.find_location_from_current();
+  if (nav.is_lost()) {
+    result.lost++;
+    return false;
+  }
+  result.crossings++;
+  return true;
+}
+
+void reflection_event(GeoNavigator& nav, TransportResult& result) {
+  nav.reflect_with_next_boundary();
+  result.reflections++;
+}
+
+// Flight sampled against the majorant, ending at a tentative collision or at
+// the boundary of the root node. The particle is located again at its end.
+bool delta_flight(Geometry& geometry, GeoNavigator& nav, double sigma_maj,
+                  double& E, double weight, uint64_t history,
+                  double& track_length, RNG& rng,
+                  const TransportSettings& settings, ThreadBanks& banks,
+                  HistoryScores& scores) {
+  TransportResult& result = banks.result;
+  SurfaceCrossing outer =
+      geometry.root()->distance_to_boundary(nav.r_global(), nav.u_global());
+  double d = sample_flight_distance(sigma_maj, rng);
+
+  if (d >= outer.distance) {
+    if (outer.distance == INF) {
+      result.lost++;
+      return false;
+    }
+    track_length += outer.distance;
+
+    const Surface* surface = geometry.surface_table().surface(outer.surface).get();
+    if (!surface || surface->boundary() != Surface::BoundaryType::Reflective) {
+      if (surface && surface->boundary() == Surface::BoundaryType::Vacuum)
+        result.leaks++;
+      else
+        result.lost++;
+      return false;
+    }
+
+    // Reflect in the frame of the root node, staying on the same side
+    nav.move_distance(outer.distance);
+    Direction u = nav.u_global();
+    Direction n = geometry.surface_table().normal(outer.surface, nav.r_global());
+    nav.set_new_global_coords(nav.r_global(), u - 2. * (u * n) * n);
+    nav.set_on_surface(surface->id(), outer.side);
+    nav.find_location_from_current();
+    result.reflections++;
+    if (nav.is_lost()) {
+      result.lost++;
+      return false;
+    }
+    return true;
+  }
+
+  nav.move_distance(d);
+  track_length += d;
+  nav.find_location_from_current();
+  if (nav.is_lost()) {
+    result.lost++;
+    return false;
+  }
+
+  const Material* material = nav.current_node()->material();
+  MacroXS xs = material ? material->xs(E) : MacroXS{0., 0., 0., 0., 0.};
+  if (rng() * sigma_maj >= xs.total) {
+    result.virtual_collisions++;
+    return true;
+  }
+  return collision_event(nav, *material, xs.total, xs.nu_fission, E, weight,
+                         history, rng, settings, banks, scores);
+}
+
+}  // namespace
+
+//============================================================================
+// History-based transport
+namespace {
+
+// Follows the particle of site to its death, adding to the scores of its
+// history
+void follow_particle(Geometry& geometry, const Majorant* majorant,
+                     const TransportSettings& settings, const SourceSite& site,
+                     uint64_t history, RNG& rng, ThreadBanks& banks,
+                     HistoryScores& scores) {
+  TransportResult& result = banks.result;
+  GeoNavigator nav(&geometry, site.r, site.u);
+  double E = site.energy;
+  double track_length = 0.;
+
+  bool alive = !nav.is_lost();
+  if (!alive) result.lost++;
+
+  while (alive) {
+    rng.next_event();
+    const Material* material = nav.current_node()->material();
+    MacroXS xs = material ? material->xs(E) : MacroXS{0., 0., 0., 0., 0.};
+
+    if (majorant) {
+      double sigma_maj = majorant->xs(E);
+      if (sigma_maj > 0. && xs.total >= settings.delta_threshold * sigma_maj) {
+        alive = delta_flight(geometry, nav, sigma_maj, E, site.weight, history,
+                             track_length, rng, settings, banks, scores);
+        continue;
+      }
+    }
+
+    GeoNavigator::Boundary boundary = nav.find_next_boundary();
+    double d = sample_flight_distance(xs.total, rng);
+    double flight = std::min(d, boundary.distance);
+    if (flight < INF) {
+      scores.k_track_length += site.weight * flight * xs.nu_fission;
+      if (!settings.tallies.empty())
+        score_flight(settings, banks.thread, nav, flight, material, E,
+                     site.weight);
+    }
+
+    if (d < boundary.distance) {
+      nav.move_distance(d);
+      track_length += d;
+      alive = collision_event(nav, *material, xs.total, xs.nu_fission, E,
+                              site.weight, history, rng, settings, banks,
+                              scores);
+    } else if (boundary.distance == INF) {
+      // Nothing left to hit, in a void which never ends
+      result.lost++;
+      alive = false;
+    } else if (is_reflective(boundary)) {
+      track_length += boundary.distance;
+      reflection_event(nav, result);
+    } else {
+      track_length += boundary.distance;
+      alive = crossing_event(nav, result);
+    }
+  }
+
+  scores.track_length += site.weight * track_length;
+}
+
+}  // namespace
+
+TransportResult transport_histories(Geometry& geometry,
+                                    const std::vector<SourceSite>& sites,
+                                    const TransportSettings& settings,
+                                    std::vector<SourceSite>& fission_bank) {
+  const size_t chunk_size = settings.chunk_size;
+  if (chunk_size == 0) {
+    std::string mssg = "Histories must be handed out in chunks above zero.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  std::shared_ptr<const Majorant> majorant;
+  if (settings.tracking == Tracking::Delta) {
+    majorant = settings.majorant;
+    if (!majorant) majorant = std::make_shared<Majorant>(geometry.materials());
+  }
+
+  const size_t n = sites.size();
+  const size_t nchunks = (n + chunk_size - 1) / chunk_size;
+  const int nthreads = thread_count(settings.threads);
+  std::vector<ThreadBanks> banks = make_banks(nthreads, settings);
+  prepare_tallies(settings, nthreads);
+  std::vector<ChunkSites> chunks(nchunks);
+  std::vector<HistoryScores> scores(n);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+  for (size_t c = 0; c < nchunks; c++) {
+    ThreadBanks& bank = banks[static_cast<size_t>(thread_id())];
+    const size_t begin = bank.fission.size();
+    const size_t last = std::min(n, (c + 1) * chunk_size);
+
+    for (size_t i = c * chunk_size; i < last; i++) {
+      RNG rng(settings.seed, settings.batch, i);
+      bank.result.histories++;
+      follow_particle(geometry, majorant.get(), settings, sites[i], i, rng,
+                      bank, scores[i]);
+
+      // Secondaries continue the random number stream of their history
+      while (!bank.secondary.empty()) {
+        SourceSite site = bank.secondary.back();
+        bank.secondary.pop_back();
+        bank.result.secondaries++;
+        follow_particle(geometry, majorant.get(), settings, site, i, rng,
+                        bank, scores[i]);
+      }
+    }
+
+    chunks[c] = {thread_id(), begin, bank.fission.size()};
+  }
+
+  return gather(banks, chunks, scores, fission_bank);
+}
+
+//============================================================================
+// Event-based transport
+TransportResult transport_events(Geometry& geometry,
+                                 const std::vector<SourceSite>& sites,
+                                 const TransportSettings& settings,
+                                 std::vector<SourceSite>& fission_bank) {
+  const uint64_t seed = settings.seed;
+  const size_t bank_size = settings.event_bank_size;
+  if (bank_size == 0) {
+    std::string mssg = "Event-based transport needs a bank size above zero.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (settings.tracking != Tracking::Surface) {
+    std::string mssg = "Event-based transport only does surface tracking.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  if (settings.fission_neutrons == FissionNeutrons::Secondary) {
+    std::string mssg = "Event-based transport can not follow secondaries.";
+    throw PMCException(mssg, __FILE__, __LINE__);
+  }
+
+  const size_t n = sites.size();
+  const size_t nchunks = (n + bank_size - 1) / bank_size;
+  const int nthreads = thread_count(settings.threads);
+  std::vector<ThreadBanks> banks = make_banks(nthreads, settings);
+  prepare_tallies(settings, nthreads);
+  std::vector<ChunkSites> chunks(nchunks);
+  std::vector<HistoryScores> scores(n);
+
+#pragma omp parallel num_threads(nthreads)
+  {
+    ThreadBanks& banked = banks[static_cast<size_t>(thread_id())];
+    TransportResult& result = banked.result;
+    ParticleBank bank(std::min(bank_size, n));
+
+    // Indices in the bank of the particles waiting on each kind of event
+    std::vector<uint32_t> lookup_queue;
+    std::vector<uint32_t> collision_queue;
+    std::vector<uint32_t> crossing_queue;
+    std::vector<uint32_t> reflection_queue;
+
+    // Each thread takes a whole bank of histories at once
+#pragma omp for schedule(dynamic, 1)
+    for (size_t c = 0; c < nchunks; c++) {
+      const size_t first = c * bank_size;
+      const size_t count = std::min(bank_size, n - first);
+      const size_t begin = banked.fission.size();
+      bank.load(geometry, sites, first, count, seed, settings.batch);
+
+      lookup_queue.clear();
+      for (uint32_t i = 0; i < count; i++) {
+        result.histories++;
+        if (bank.navigators[i].is_lost()) result.lost++;
+        else lookup_queue.push_back(i);
+      }
+
+      while (!lookup_queue.empty()) {
+        // Cross sections at the position and energy of each particle
+        for (uint32_t i : lookup_queue) {
+          const Material* material =
+              bank.navigators[i].current_node()->material();
+          bank.material[i] = material;
+          MacroXS xs = material ? material->xs(bank.energy[i])
+                                : MacroXS{0., 0., 0., 0., 0.};
+          bank.sigma_t[i] = xs.total;
+          bank.nu_fission[i] = xs.nu_fission;
+        }
+
+        // Flight to the next collision or boundary, which decides the queue
+        // of the next event. Every flight starts a new event, whose random
+        // numbers are generated for all of the particles at once. The
+        // boundaries of the volumes the particles are in are found for all
+        // of the particles of each node at once, and the navigators then
+        // look for nearer boundaries of children and lattice elements.
+        RNG::next_event(bank.rngs.data(), lookup_queue.data(),
+                        lookup_queue.size());
+        bank.find_volume_boundaries(lookup_queue);
+        for (uint32_t i : lookup_queue) {
+          GeoNavigator& nav = bank.navigators[i];
+          GeoNavigator::Boundary boundary =
+              bank.batched[i] ? nav.find_next_boundary(bank.boundary_distance[i],
+                                                       bank.boundary_surface[i])
+                              : nav.find_next_boundary();
+          double d = sample_flight_distance(bank.sigma_t[i], bank.rngs[i]);
+          double flight = std::min(d, boundary.distance);
+          if (flight < INF) {
+            scores[first + i].k_track_length +=
+                bank.weight[i] * flight * bank.nu_fission[i];
+            if (!settings.tallies.empty())
+              score_flight(settings, banked.thread, nav, flight,
+                           bank.material[i], bank.energy[i], bank.weight[i]);
+          }
+
+          if (d < boundary.distance) {
+            nav.move_distance(d);
+            bank.track_length[i] += d;
+            collision_queue.push_back(i);
+          } else if (boundary.distance == INF) {
+            result.lost++;
+          } else if (is_reflective(boundary)) {
+            bank.track_length[i] += boundary.distance;
+            reflection_queue.push_back(i);
+          } else {
+            bank.track_length[i] += boundary.distance;
+            crossing_queue.push_back(i);
+          }
+        }
+        lookup_queue.clear();
+
+        for (uint32_t i : reflection_queue) {
+          reflection_event(bank.navigators[i], result);
+          lookup_queue.push_back(i);
+        }
+
+        for (uint32_t i : crossing_queue) {
+          if (crossing_event(bank.navigators[i], result))
+            lookup_queue.push_back(i);
+        }
+
+        for (uint32_t i : collision_queue) {
+          if (collision_event(bank.navigators[i], *bank.material[i],
+                              bank.sigma_t[i], bank.nu_fission[i],
+                              bank.energy[i], bank.weight[i], first + i,
+                              bank.rngs[i], settings, banked,
+                              scores[first + i]))
+            lookup_queue.push_back(i);
+        }
+
+        reflection_queue.clear();
+        crossing_queue.clear();
+        collision_queue.clear();
+      }
+
+      for (size_t i = 0; i < count; i++) {
+        scores[first + i].track_length = bank.weight[i] * bank.track_length[i];
+      }
+
+      // Fission sites were banked in the order of the events, and are put
+      // back in the order of the histories, as in history-based transport
+      std::vector<size_t> order(banked.fission.size() - begin);
+      std::iota(order.begin(), order.end(), begin);
+      std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return banked.fission_history[a] < banked.fission_history[b];
+      });
+      std::vector<SourceSite> sorted;
+      sorted.reserve(order.size());
+      for (size_t k : order) sorted.push_back(banked.fission[k]);
+      std::copy(sorted.begin(), sorted.end(), banked.fission.begin() + begin);
+
+      chunks[c] = {thread_id(), begin, banked.fission.size()};
+    }
+  }
+
+  return gather(banks, chunks, scores, fission_bank);
+}
+
+}  // namespace pmc
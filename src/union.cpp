@@ -49,4 +49,11 @@ namespace pmc {
     return (b1.distance <= b2.distance) ? b1 : b2;
   }
 
+  Ray Union::get_ray(const Position& r, const Direction& u, uint32_t on_surf, Surface::Side on_side) const {
+    return Ray::unite(r1_->get_ray(r, u, on_surf, on_side), r2_->get_ray(r, u, on_surf, on_side));
+  }
+
+  AABB Union::bounding_box() const {
+    return AABB::bounding_union(r1_->bounding_box(), r2_->bounding_box());
+  }
 }
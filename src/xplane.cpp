@@ -57,4 +57,27 @@ namespace pmc {
   }
 
   Direction XPlane::normal(const Position& /*r*/) const {return {1., 0., 0.};}
+
+  void XPlane::distance_batch(const double* __restrict x, const double* /*y*/, const double* /*z*/,
+      const double* __restrict u, const double* /*v*/, const double* /*w*/, double* __restrict d,
+      size_t n, const uint32_t* on_surf) const {
+    // Every case is a select rather than a branch, so that the loop is
+    // vectorized. A zero direction component makes an infinity or a NaN,
+    // which is then replaced.
+    const double p0 = x0, inf = INF, coincident = SURFACE_COINCIDENT;
+    #pragma omp simd
+    for(size_t i = 0; i < n; i++) {
+      double diff = p0 - x[i];
+      double di = diff / u[i];
+      di = (di < 0.) ? inf : di;
+      di = (u[i] == 0.) ? inf : di;
+      d[i] = (std::fabs(diff) < coincident) ? inf : di;
+    }
+    mask_on_surface(on_surf, d, n);
+  }
+
+  AABB XPlane::bounding_box(Side side) const {
+    if(side == Side::Positive) return AABB({x0, -INF, -INF}, {INF, INF, INF});
+    else return AABB({-INF, -INF, -INF}, {x0, INF, INF});
+  }
 }
\ No newline at end of file
@@ -57,4 +57,27 @@ namespace pmc {
   }
 
   Direction YPlane::normal(const Position& /*r*/) const {return {0., 1., 0.};}
+
+  void YPlane::distance_batch(const double* /*x*/, const double* __restrict y, const double* /*z*/,
+      const double* /*u*/, const double* __restrict v, const double* /*w*/, double* __restrict d,
+      size_t n, const uint32_t* on_surf) const {
+    // Every case is a select rather than a branch, so that the loop is
+    // vectorized. A zero direction component makes an infinity or a NaN,
+    // which is then replaced.
+    const double p0 = y0, inf = INF, coincident = SURFACE_COINCIDENT;
+    #pragma omp simd
+    for(size_t i = 0; i < n; i++) {
+      double diff = p0 - y[i];
+      double di = diff / v[i];
+      di = (di < 0.) ? inf : di;
+      di = (v[i] == 0.) ? inf : di;
+      d[i] = (std::fabs(diff) < coincident) ? inf : di;
+    }
+    mask_on_surface(on_surf, d, n);
+  }
+
+  AABB YPlane::bounding_box(Side side) const {
+    if(side == Side::Positive) return AABB({-INF, y0, -INF}, {INF, INF, INF});
+    else return AABB({-INF, -INF, -INF}, {INF, y0, INF});
+  }
 }
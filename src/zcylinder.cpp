@@ -81,4 +81,41 @@ namespace pmc {
     double y = r.y() - y0;
     return {x,y,0.};
   }
+
+  AABB ZCylinder::bounding_box(Side side) const {
+    if(side == Side::Positive) return AABB();
+    return AABB({x0 - R, y0 - R, -INF}, {x0 + R, y0 + R, INF});
+  }
+
+  void ZCylinder::distance_batch(const double* __restrict x, const double* __restrict y,
+      const double* /*z*/, const double* __restrict u, const double* __restrict v,
+      const double* /*w*/, double* __restrict d, size_t n,
+      const uint32_t* on_surf) const {
+    // Both roots are always evaluated, and the right one is then selected,
+    // so that the loop is vectorized. A direction along the axis makes an
+    // infinity or a NaN, which is then replaced.
+    const double c1 = x0, c2 = y0, R2 = R*R;
+    const double inf = INF, coincident = SURFACE_COINCIDENT;
+    #pragma omp simd
+    for(size_t i = 0; i < n; i++) {
+      double a = u[i]*u[i] + v[i]*v[i];
+      double p1 = x[i] - c1;
+      double p2 = y[i] - c2;
+      double k = p1*u[i] + p2*v[i];
+      double c = p1*p1 + p2*p2 - R2;
+      double quad = k*k - a*c;
+
+      double sq = std::sqrt((quad < 0.) ? 0. : quad);
+      double d_far = (-k + sq)/a;
+      double d_near = (-k - sq)/a;
+
+      double di = (d_near < 0.) ? inf : d_near;
+      di = (c < 0.) ? d_far : di;
+      double on = (k >= 0.) ? inf : d_far;
+      di = (std::fabs(c) < coincident) ? on : di;
+      di = (quad < 0.) ? inf : di;
+      d[i] = (a == 0.) ? inf : di;
+    }
+    mask_on_surface(on_surf, d, n);
+  }
 }
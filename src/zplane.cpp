@@ -57,4 +57,27 @@ namespace pmc {
   }
 
   Direction ZPlane::normal(const Position& /*r*/) const {return {0., 0., 1.};}
+
+  void ZPlane::distance_batch(const double* /*x*/, const double* /*y*/, const double* __restrict z,
+      const double* /*u*/, const double* /*v*/, const double* __restrict w, double* __restrict d,
+      size_t n, const uint32_t* on_surf) const {
+    // Every case is a select rather than a branch, so that the loop is
+    // vectorized. A zero direction component makes an infinity or a NaN,
+    // which is then replaced.
+    const double p0 = z0, inf = INF, coincident = SURFACE_COINCIDENT;
+    #pragma omp simd
+    for(size_t i = 0; i < n; i++) {
+      double diff = p0 - z[i];
+      double di = diff / w[i];
+      di = (di < 0.) ? inf : di;
+      di = (w[i] == 0.) ? inf : di;
+      d[i] = (std::fabs(diff) < coincident) ? inf : di;
+    }
+    mask_on_surface(on_surf, d, n);
+  }
+
+  AABB ZPlane::bounding_box(Side side) const {
+    if(side == Side::Positive) return AABB({-INF, -INF, z0}, {INF, INF, INF});
+    else return AABB({-INF, -INF, -INF}, {INF, INF, z0});
+  }
 }
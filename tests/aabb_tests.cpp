@@ -0,0 +1,146 @@
+#include <Papillon/geometry/csg/difference.hpp>
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/csg/union.hpp>
+#include <Papillon/geometry/geo_node.hpp>
+#include <Papillon/geometry/surfaces/plane.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <Papillon/geometry/surfaces/zplane.hpp>
+#include <Papillon/utils/aabb.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+
+namespace {
+  using namespace pmc;
+
+  const auto T = Surface::BoundaryType::Transparent;
+  const auto P = Surface::Side::Positive;
+  const auto N = Surface::Side::Negative;
+
+  TEST(AABB, contains) {
+    AABB box({-1., -2., -3.}, {1., 2., 3.});
+    EXPECT_TRUE(box.is_bounded());
+    EXPECT_FALSE(box.is_empty());
+    EXPECT_TRUE(box.contains({0., 0., 0.}));
+    EXPECT_TRUE(box.contains({1., 2., 3.}));
+    EXPECT_FALSE(box.contains({1.1, 0., 0.}));
+    EXPECT_FALSE(box.contains({0., 0., -3.1}));
+
+    AABB inf;
+    EXPECT_FALSE(inf.is_bounded());
+    EXPECT_TRUE(inf.contains({1.E100, -1.E100, 0.}));
+  }
+
+  TEST(AABB, distance) {
+    AABB box({-1., -1., -1.}, {1., 1., 1.});
+    EXPECT_DOUBLE_EQ(box.distance({-3., 0., 0.}, {1., 0., 0.}), 2.);
+    EXPECT_DOUBLE_EQ(box.distance({0., 0., 0.}, {1., 0., 0.}), 0.);
+    EXPECT_EQ(box.distance({-3., 0., 0.}, {-1., 0., 0.}), INF);
+    EXPECT_EQ(box.distance({-3., 2., 0.}, {1., 0., 0.}), INF);
+    EXPECT_NEAR(box.distance({-3., -3., 0.}, Direction(1., 1., 0.)),
+                2.*std::sqrt(2.), 1.E-12);
+
+    // Half-infinite box
+    AABB half({0., -INF, -INF}, {INF, INF, INF});
+    EXPECT_DOUBLE_EQ(half.distance({-2., 5., 5.}, {1., 0., 0.}), 2.);
+    EXPECT_EQ(half.distance({-2., 5., 5.}, {0., 1., 0.}), INF);
+  }
+
+  TEST(AABB, transformed) {
+    AABB box({-1., -1., -1.}, {1., 1., 1.});
+    AABB moved = box.transformed(Transformation::translation(2., 0., -1.));
+    EXPECT_DOUBLE_EQ(moved.lower().x(), 1.);
+    EXPECT_DOUBLE_EQ(moved.upper().x(), 3.);
+    EXPECT_DOUBLE_EQ(moved.lower().z(), -2.);
+
+    // A 45 degree rotation grows the box by sqrt(2) in x and y
+    AABB rot = box.transformed(Transformation::rotation_z(PI/4.));
+    EXPECT_NEAR(rot.upper().x(), std::sqrt(2.), 1.E-12);
+    EXPECT_NEAR(rot.lower().y(), -std::sqrt(2.), 1.E-12);
+    EXPECT_NEAR(rot.upper().z(), 1., 1.E-12);
+
+    // Unbounded axes spread to every axis which depends on them
+    AABB slab({-INF, -INF, -1.}, {INF, INF, 1.});
+    AABB rslab = slab.transformed(Transformation::rotation_z(PI/6.));
+    EXPECT_EQ(rslab.lower().x(), -INF);
+    EXPECT_EQ(rslab.upper().y(), INF);
+    EXPECT_NEAR(rslab.upper().z(), 1., 1.E-12);
+  }
+
+  TEST(AABB, union_intersection) {
+    AABB a({0., 0., 0.}, {1., 1., 1.});
+    AABB b({2., -1., 0.5}, {3., 0.5, 2.});
+    AABB u = AABB::bounding_union(a, b);
+    EXPECT_DOUBLE_EQ(u.lower().y(), -1.);
+    EXPECT_DOUBLE_EQ(u.upper().x(), 3.);
+    EXPECT_DOUBLE_EQ(u.upper().z(), 2.);
+
+    EXPECT_TRUE(AABB::intersection(a, b).is_empty());
+    AABB c({0.5, 0.5, 0.5}, {4., 4., 4.});
+    AABB i = AABB::intersection(a, c);
+    EXPECT_DOUBLE_EQ(i.lower().x(), 0.5);
+    EXPECT_DOUBLE_EQ(i.upper().x(), 1.);
+  }
+
+  TEST(AABB, surfaces) {
+    Sphere sph(1., 2., 3., 0.5, T, 1);
+    AABB sb = sph.bounding_box(N);
+    EXPECT_DOUBLE_EQ(sb.lower().x(), 0.5);
+    EXPECT_DOUBLE_EQ(sb.upper().z(), 3.5);
+    EXPECT_FALSE(sph.bounding_box(P).is_bounded());
+
+    ZPlane zp(2., T, 2);
+    EXPECT_DOUBLE_EQ(zp.bounding_box(P).lower().z(), 2.);
+    EXPECT_EQ(zp.bounding_box(P).upper().z(), INF);
+    EXPECT_DOUBLE_EQ(zp.bounding_box(N).upper().z(), 2.);
+
+    // -2x = 4 has its positive side at x < -2
+    Plane pl(-2., 0., 0., 4., T, 3);
+    EXPECT_DOUBLE_EQ(pl.bounding_box(P).upper().x(), -2.);
+    EXPECT_EQ(pl.bounding_box(P).lower().x(), -INF);
+    Plane skew(1., 1., 0., 1., T, 4);
+    EXPECT_EQ(skew.bounding_box(N).upper().x(), INF);
+  }
+
+  TEST(AABB, volumes) {
+    auto cyl = std::make_shared<ZCylinder>(0., 0., 1., T, 1);
+    auto zlo = std::make_shared<ZPlane>(-2., T, 2);
+    auto zhi = std::make_shared<ZPlane>(2., T, 3);
+    auto sph = std::make_shared<Sphere>(0., 0., 3., 1., T, 4);
+
+    auto c = std::make_shared<HalfSpace>(cyl, N, 1);
+    auto lo = std::make_shared<HalfSpace>(zlo, P, 2);
+    auto hi = std::make_shared<HalfSpace>(zhi, N, 3);
+    auto s = std::make_shared<HalfSpace>(sph, N, 4);
+    auto pin = std::make_shared<Intersection>(
+        c, std::make_shared<Intersection>(lo, hi, 5), 6);
+
+    AABB pb = pin->bounding_box();
+    EXPECT_TRUE(pb.is_bounded());
+    EXPECT_DOUBLE_EQ(pb.lower().z(), -2.);
+    EXPECT_DOUBLE_EQ(pb.upper().x(), 1.);
+
+    Union un(pin, s, 7);
+    EXPECT_DOUBLE_EQ(un.bounding_box().upper().z(), 4.);
+
+    Difference df(pin, s, 8);
+    EXPECT_DOUBLE_EQ(df.bounding_box().upper().z(), 2.);
+  }
+
+  TEST(AABB, geo_node) {
+    auto sph = std::make_shared<Sphere>(0., 0., 0., 1., T, 1);
+    auto s = std::make_shared<HalfSpace>(sph, N, 1);
+    GeoNode node(s, Transformation::translation(5., 0., 0.), "sphere");
+
+    const AABB& b = node.bounding_box();
+    EXPECT_NEAR(b.lower().x(), 4., 1.E-8);
+    EXPECT_NEAR(b.upper().x(), 6., 1.E-8);
+    EXPECT_TRUE(b.contains({6., 0., 0.}));
+    EXPECT_FALSE(b.contains({0., 0., 0.}));
+
+    node.set_transformation(Transformation::translation(0., -3., 0.));
+    EXPECT_NEAR(node.bounding_box().upper().y(), -2., 1.E-8);
+  }
+};
@@ -0,0 +1,111 @@
+#include <Papillon/geometry/bvh.hpp>
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/geo_node.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/surface_table.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  std::vector<AABB> random_boxes(size_t n, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> pos(-10., 10.);
+    std::uniform_real_distribution<double> len(0.1, 1.);
+    std::vector<AABB> boxes;
+    for (size_t i = 0; i < n; i++) {
+      Position lo(pos(rng), pos(rng), pos(rng));
+      boxes.emplace_back(lo, lo + Position(len(rng), len(rng), len(rng)));
+    }
+    return boxes;
+  }
+
+  TEST(BVH, find) {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> pos(-10., 10.);
+    std::vector<AABB> boxes = random_boxes(500, rng);
+    boxes.push_back(AABB({-INF, 0., 0.}, {INF, 0.5, 0.5}));
+    BVH bvh(boxes);
+    EXPECT_FALSE(bvh.empty());
+
+    for (int q = 0; q < 1000; q++) {
+      Position r(pos(rng), pos(rng), pos(rng));
+      size_t nfound = 0;
+      bvh.find(r, [&](uint32_t i) {
+        if (boxes[i].contains(r)) nfound++;
+        return false;
+      });
+
+      size_t nexpected = 0;
+      for (const auto& b : boxes) nexpected += b.contains(r);
+      EXPECT_EQ(nfound, nexpected);
+    }
+  }
+
+  TEST(BVH, nearest) {
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> pos(-12., 12.);
+    std::uniform_real_distribution<double> mu(-1., 1.);
+    std::vector<AABB> boxes = random_boxes(500, rng);
+    BVH bvh(boxes);
+
+    for (int q = 0; q < 1000; q++) {
+      Position r(pos(rng), pos(rng), pos(rng));
+      Direction u(mu(rng), mu(rng), mu(rng));
+      double d = bvh.nearest(r, u, INF, [&](uint32_t i, double dmin) {
+        return std::min(dmin, boxes[i].distance(r, u));
+      });
+
+      double expected = INF;
+      for (const auto& b : boxes) expected = std::min(expected, b.distance(r, u));
+      EXPECT_EQ(d, expected);
+    }
+  }
+
+  TEST(BVH, geo_node) {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs;
+    surfs[1] = std::make_shared<Sphere>(0., 0., 0., 0.4, Surface::BoundaryType::Transparent, 1);
+    surfs[2] = std::make_shared<Sphere>(0., 0., 0., 20., Surface::BoundaryType::Vacuum, 2);
+    SurfaceTable table(surfs);
+    auto pin = std::make_shared<HalfSpace>(surfs[1], Surface::Side::Negative, 1);
+    auto world = std::make_shared<HalfSpace>(surfs[2], Surface::Side::Negative, 2);
+
+    GeoNode with(world, "with");
+    GeoNode without(world, "without");
+    without.set_use_bvh(false);
+    for (int i = 0; i < 6; i++) {
+      for (int j = 0; j < 6; j++) {
+        for (int k = 0; k < 6; k++) {
+          auto t = Transformation::translation(i - 2.5, j - 2.5, k - 2.5);
+          with.add_node(pin, t, "pin");
+          without.add_node(pin, t, "pin");
+        }
+      }
+    }
+    with.finalize(table);
+    without.finalize(table);
+    EXPECT_TRUE(with.has_bvh());
+    EXPECT_FALSE(without.has_bvh());
+
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> pos(-4., 4.);
+    std::uniform_real_distribution<double> mu(-1., 1.);
+    for (int q = 0; q < 1000; q++) {
+      Position r(pos(rng), pos(rng), pos(rng));
+      Direction u(mu(rng), mu(rng), mu(rng));
+
+      GeoNode* c1 = with.find_child_node(r, u, 0, Surface::Side::Positive);
+      GeoNode* c2 = without.find_child_node(r, u, 0, Surface::Side::Positive);
+      EXPECT_EQ(c1 == nullptr, c2 == nullptr);
+      if (c1 && c2) EXPECT_EQ(c1->bounding_box().lower().x(), c2->bounding_box().lower().x());
+
+      SurfaceCrossing b1 = with.distance_to_child_boundary(r, u);
+      SurfaceCrossing b2 = without.distance_to_child_boundary(r, u);
+      EXPECT_EQ(b1.distance, b2.distance);
+      EXPECT_EQ(b1.surface, b2.surface);
+    }
+  }
+};
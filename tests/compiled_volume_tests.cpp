@@ -0,0 +1,127 @@
+#include <Papillon/geometry/csg/compiled_volume.hpp>
+#include <Papillon/geometry/csg/difference.hpp>
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/csg/union.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+namespace {
+  using namespace pmc;
+
+  const auto T = Surface::BoundaryType::Transparent;
+  const auto P = Surface::Side::Positive;
+  const auto N = Surface::Side::Negative;
+
+  TEST(CompiledVolume, program) {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs;
+    surfs[1] = std::make_shared<XPlane>(0., T, 1);
+    surfs[2] = std::make_shared<XPlane>(2., T, 2);
+    surfs[3] = std::make_shared<XPlane>(1., T, 3);
+    SurfaceTable table(surfs);
+
+    auto px = std::make_shared<HalfSpace>(surfs[1], P, 1);
+    auto nx = std::make_shared<HalfSpace>(surfs[2], N, 2);
+    auto i1 = std::make_shared<Intersection>(px, nx, 3);
+    auto h3 = std::make_shared<HalfSpace>(surfs[3], P, 4);
+    Difference d(i1, h3, 5);
+
+    CompiledVolume cv(d, table);
+    const auto& ops = cv.program();
+    ASSERT_EQ(ops.size(), 6u);
+    EXPECT_EQ(ops[0].code, CompiledVolume::OpCode::HalfSpace);
+    EXPECT_EQ(ops[0].arg, table.index(1));
+    EXPECT_EQ(ops[1].code, CompiledVolume::OpCode::JumpIfFalse);
+    EXPECT_EQ(ops[1].arg, 3u);
+    EXPECT_EQ(ops[2].code, CompiledVolume::OpCode::HalfSpace);
+    EXPECT_EQ(ops[3].code, CompiledVolume::OpCode::JumpIfFalse);
+    EXPECT_EQ(ops[3].arg, 6u);
+    EXPECT_EQ(ops[4].code, CompiledVolume::OpCode::HalfSpace);
+    EXPECT_EQ(ops[4].arg, table.index(3));
+    EXPECT_EQ(ops[5].code, CompiledVolume::OpCode::Not);
+
+    EXPECT_TRUE(cv.is_inside({0.5,0.,0.},{1.,0.,0.}));
+    EXPECT_FALSE(cv.is_inside({1.5,0.,0.},{1.,0.,0.}));
+    EXPECT_FALSE(cv.is_inside({-0.5,0.,0.},{1.,0.,0.}));
+    EXPECT_TRUE(cv.is_inside({1.,0.,0.},{1.,0.,0.}, 3, N));
+  }
+
+  TEST(CompiledVolume, matches_volume_tree) {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs;
+    surfs[1] = std::make_shared<Sphere>(0., 0., 0., 3., T, 1);
+    surfs[2] = std::make_shared<ZCylinder>(1., 0., 1., T, 2);
+    surfs[3] = std::make_shared<ZCylinder>(-1., 0., 1., T, 3);
+    surfs[4] = std::make_shared<XPlane>(0., T, 4);
+    surfs[5] = std::make_shared<Sphere>(0., 2., 0., 0.5, T, 5);
+    SurfaceTable table(surfs);
+
+    // (Sphere1 - (Cyl2 U Cyl3)) ^ (+X4 U -Sphere5)
+    std::shared_ptr<Volume> s1 = std::make_shared<HalfSpace>(surfs[1], N, 1);
+    std::shared_ptr<Volume> c2 = std::make_shared<HalfSpace>(surfs[2], N, 2);
+    std::shared_ptr<Volume> c3 = std::make_shared<HalfSpace>(surfs[3], N, 3);
+    std::shared_ptr<Volume> x4 = std::make_shared<HalfSpace>(surfs[4], P, 4);
+    std::shared_ptr<Volume> s5 = std::make_shared<HalfSpace>(surfs[5], N, 5);
+    std::shared_ptr<Volume> cyls = std::make_shared<Union>(c2, c3, 6);
+    std::shared_ptr<Volume> left = std::make_shared<Difference>(s1, cyls, 7);
+    std::shared_ptr<Volume> right = std::make_shared<Union>(x4, s5, 8);
+    Intersection vol(left, right, 9);
+
+    CompiledVolume cv(vol, table);
+    Direction u(1., 2., 0.5);
+
+    for(int i = -16; i <= 16; i++) {
+      for(int j = -16; j <= 16; j++) {
+        Position r(0.23*i, 0.21*j, 0.1);
+        EXPECT_EQ(vol.is_inside(r, u), cv.is_inside(r, u));
+
+        Boundary b = vol.get_boundary(r, u);
+        SurfaceCrossing c = cv.distance_to_boundary(r, u);
+        EXPECT_NEAR(b.distance, c.distance, 1.E-12*std::max(1., b.distance));
+        if(b.distance < INF) {
+          EXPECT_EQ(b.surface_id, table[c.surface].id);
+          EXPECT_EQ(b.current_side, c.side);
+        }
+      }
+    }
+  }
+
+  TEST(CompiledVolume, unknown_surface) {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs;
+    surfs[1] = std::make_shared<XPlane>(0., T, 1);
+    SurfaceTable table(surfs);
+
+    auto other = std::make_shared<XPlane>(1., T, 2);
+    HalfSpace h(other, P, 1);
+    EXPECT_THROW(CompiledVolume(h, table), PMCException);
+  }
+
+  TEST(CompiledVolume, shared_surfaces) {
+    // The same surfaces have different indices in each table, and building
+    // the second table must not change how volumes compile against the first
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs;
+    surfs[1] = std::make_shared<XPlane>(0., T, 1);
+    surfs[2] = std::make_shared<XPlane>(1., T, 2);
+    SurfaceTable t1(surfs);
+    surfs.erase(1);
+    SurfaceTable t2(surfs);
+
+    HalfSpace h(surfs[2], N, 1);
+    CompiledVolume cv1(h, t1);
+    CompiledVolume cv2(h, t2);
+    EXPECT_EQ(cv1.program()[0].arg, 2u);
+    EXPECT_EQ(cv2.program()[0].arg, 1u);
+
+    SurfaceCrossing c1 = cv1.distance_to_boundary({0.5,0.,0.}, {1.,0.,0.});
+    SurfaceCrossing c2 = cv2.distance_to_boundary({0.5,0.,0.}, {1.,0.,0.});
+    EXPECT_EQ(t1[c1.surface].id, 2u);
+    EXPECT_EQ(t2[c2.surface].id, 2u);
+    EXPECT_DOUBLE_EQ(c1.distance, 0.5);
+    EXPECT_DOUBLE_EQ(c2.distance, 0.5);
+  }
+
+};
@@ -64,4 +64,28 @@ namespace {
     EXPECT_DOUBLE_EQ(b3.distance, x0->distance(r2, u2));
     EXPECT_EQ(b3.current_side, x0->sign(r2, u2));
   }
+
+  TEST(Difference, get_ray) {
+    // Slab 0 < x < 4 with the slab 1 < x < 2 removed
+    std::shared_ptr<Surface> x0 = std::make_shared<XPlane>(0., Surface::BoundaryType::Transparent, 1);
+    std::shared_ptr<Surface> x1 = std::make_shared<XPlane>(1., Surface::BoundaryType::Transparent, 2);
+    std::shared_ptr<Surface> x2 = std::make_shared<XPlane>(2., Surface::BoundaryType::Transparent, 3);
+    std::shared_ptr<Surface> x4 = std::make_shared<XPlane>(4., Surface::BoundaryType::Transparent, 4);
+    auto slab = [](std::shared_ptr<Surface> lo, std::shared_ptr<Surface> hi, uint32_t id) {
+      return std::make_shared<Intersection>(
+          std::make_shared<HalfSpace>(lo, Surface::Side::Positive, id),
+          std::make_shared<HalfSpace>(hi, Surface::Side::Negative, id + 1), id + 2);
+    };
+    Difference d(slab(x0, x4, 1), slab(x1, x2, 4), 7);
+
+    Ray ray = d.get_ray({-1., 0., 0.}, {1., 0., 0.});
+    ASSERT_EQ(ray.size(), 2u);
+    EXPECT_DOUBLE_EQ(ray[0].enter.distance, 1.);
+    EXPECT_DOUBLE_EQ(ray[0].exit.distance, 2.);
+    EXPECT_EQ(ray[0].exit.side, Surface::Side::Negative);
+    EXPECT_DOUBLE_EQ(ray[1].enter.distance, 3.);
+    EXPECT_EQ(ray[1].enter.side, Surface::Side::Negative);
+    EXPECT_DOUBLE_EQ(ray[1].exit.distance, 5.);
+  }
+
 };
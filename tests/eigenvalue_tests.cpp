@@ -0,0 +1,235 @@
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zplane.hpp>
+#include <Papillon/transport/eigenvalue.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+
+namespace {
+  using namespace pmc;
+
+  // Reflective cube of fuel with cross sections constant in energy, whose
+  // k is nu sigma_f / (sigma_c + sigma_f) = 1.25
+  std::unique_ptr<Geometry> make_fuel_box() {
+    const auto R = Surface::BoundaryType::Reflective;
+    const auto N = Surface::Side::Negative;
+    const auto P = Surface::Side::Positive;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<XPlane>(-10., R, 1);
+    surfaces[2] = std::make_shared<XPlane>(10., R, 2);
+    surfaces[3] = std::make_shared<YPlane>(-10., R, 3);
+    surfaces[4] = std::make_shared<YPlane>(10., R, 4);
+    surfaces[5] = std::make_shared<ZPlane>(-10., R, 5);
+    surfaces[6] = std::make_shared<ZPlane>(10., R, 6);
+    auto box = std::make_shared<Intersection>(
+        std::make_shared<Intersection>(
+            std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[1], P, 1),
+                                           std::make_shared<HalfSpace>(surfaces[2], N, 2), 3),
+            std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[3], P, 4),
+                                           std::make_shared<HalfSpace>(surfaces[4], N, 5), 6), 7),
+        std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[5], P, 8),
+                                       std::make_shared<HalfSpace>(surfaces[6], N, 9), 10), 11);
+
+    auto fuel = std::make_shared<Material>(1, "fuel");
+    fuel->add_nuclide(std::make_shared<Nuclide>(
+                          "fuel", 233., std::vector<double>{1.E-11, 20.},
+                          std::vector<double>{4., 4.},
+                          std::vector<double>{1., 1.},
+                          std::vector<double>{1., 1.}, 2.5),
+                      0.05);
+    auto root = std::make_unique<GeoNode>(box, "box");
+    root->set_material(fuel);
+    return std::make_unique<Geometry>(surfaces, std::move(root));
+  }
+
+  std::vector<SourceSite> make_source(size_t n) {
+    RNG rng(7);
+    std::vector<SourceSite> sites;
+    for (size_t i = 0; i < n; i++) {
+      Position r(20. * (rng() - 0.5), 20. * (rng() - 0.5), 20. * (rng() - 0.5));
+      sites.push_back({r, Direction(2. * rng() - 1., 2. * PI * rng()), 2., 1.});
+    }
+    return sites;
+  }
+
+  TEST(Eigenvalue, resample_sites) {
+    // Sites are told apart by their energy. One in four has no weight.
+    const size_t m = 10000, n = 6000;
+    std::vector<SourceSite> sites;
+    double total = 0.;
+    for (size_t i = 0; i < m; i++) {
+      double w = static_cast<double>(i % 4) * 0.5;
+      sites.push_back({Position(), Direction(1., 0., 0.), static_cast<double>(i), w});
+      total += w;
+    }
+
+    std::vector<SourceSite> out;
+    resample_sites(sites, n, 0.37, out, 1);
+    ASSERT_EQ(out.size(), n);
+
+    // Each site is copied the floor or the ceiling of its expected number of
+    // times, in the order of the sites
+    std::vector<size_t> copies(m, 0);
+    for (size_t j = 0; j < n; j++) {
+      EXPECT_EQ(out[j].weight, 1.);
+      if (j > 0) EXPECT_LE(out[j - 1].energy, out[j].energy);
+      copies[static_cast<size_t>(out[j].energy)]++;
+    }
+    for (size_t i = 0; i < m; i++) {
+      double expected = sites[i].weight * n / total;
+      EXPECT_LE(std::abs(static_cast<double>(copies[i]) - expected), 1.);
+      if (sites[i].weight == 0.) EXPECT_EQ(copies[i], 0u);
+    }
+
+    // The same sites on any number of threads
+    std::vector<SourceSite> threaded;
+    resample_sites(sites, n, 0.37, threaded, 4);
+    ASSERT_EQ(threaded.size(), n);
+    for (size_t j = 0; j < n; j++) EXPECT_EQ(threaded[j].energy, out[j].energy);
+
+    // More sites than there were
+    resample_sites(sites, 3 * m, 0.9, out);
+    EXPECT_EQ(out.size(), 3 * m);
+
+    EXPECT_THROW(resample_sites({}, n, 0.5, out), PMCException);
+    for (auto& site : sites) site.weight = 0.;
+    EXPECT_THROW(resample_sites(sites, n, 0.5, out), PMCException);
+  }
+
+  TEST(Eigenvalue, keff_statistics) {
+    // Three unbiased estimators, the first with half the error of the others
+    KeffStatistics stats;
+    RNG rng(11);
+    auto normal = [&]() {
+      return std::sqrt(-2. * std::log(1. - rng())) * std::cos(2. * PI * rng());
+    };
+
+    stats.add({1.1, 1.2, 1.3});
+    stats.add({1.0, 0.9, 1.2});
+    // Too few batches to invert the covariance, so the estimators are averaged
+    EXPECT_NEAR(stats.combined(), (1.05 + 1.05 + 1.25) / 3., 1.E-12);
+
+    for (int i = 0; i < 4998; i++)
+      stats.add({1. + 0.01 * normal(), 1. + 0.02 * normal(), 1. + 0.02 * normal()});
+    EXPECT_EQ(stats.batches(), 5000u);
+    EXPECT_NEAR(stats.mean().collision, 1., 5.E-4);
+    EXPECT_NEAR(stats.std_error().collision, 0.01 / std::sqrt(5000.), 1.E-5);
+    EXPECT_NEAR(stats.std_error().absorption, 0.02 / std::sqrt(5000.), 2.E-5);
+
+    // Weights of 2/3, 1/6 and 1/6 give an error of sqrt(2/3) that of the
+    // collision estimator
+    EXPECT_NEAR(stats.combined(), 1., 5.E-4);
+    EXPECT_NEAR(stats.combined_std_error() / stats.std_error().collision,
+                std::sqrt(2. / 3.), 0.05);
+  }
+
+  TEST(Eigenvalue, power_iteration) {
+    auto geom = make_fuel_box();
+    EigenvalueSettings settings;
+    settings.particles = 2000;
+    settings.inactive = 3;
+    settings.active = 20;
+    settings.transport.seed = 5;
+    settings.transport.threads = 1;
+
+    PowerIteration power(*geom, make_source(500), settings);
+    std::vector<BatchResult> batches = power.run();
+    ASSERT_EQ(batches.size(), 23u);
+    EXPECT_TRUE(power.done());
+    EXPECT_FALSE(batches[2].active);
+    EXPECT_TRUE(batches[3].active);
+    EXPECT_EQ(power.source().size(), 2000u);
+    EXPECT_EQ(power.statistics().batches(), 20u);
+    EXPECT_THROW(power.run_batch(), PMCException);
+
+    // Every estimator, and their combination, finds the k of the box
+    const KeffStatistics& stats = power.statistics();
+    KeffEstimate mean = stats.mean(), error = stats.std_error();
+    EXPECT_NEAR(mean.collision, 1.25, 4. * error.collision);
+    EXPECT_NEAR(mean.absorption, 1.25, 4. * error.absorption);
+    EXPECT_NEAR(mean.track_length, 1.25, 4. * error.track_length);
+    EXPECT_NEAR(stats.combined(), 1.25, 4. * stats.combined_std_error());
+    EXPECT_LT(stats.combined_std_error(), 0.01);
+    EXPECT_NEAR(power.keff(), 1.25, 0.05);
+
+    // The same batches on another number of threads, or event by event
+    settings.transport.threads = 3;
+    settings.transport.mode = TransportMode::Event;
+    settings.transport.event_bank_size = 700;
+    PowerIteration other(*geom, make_source(500), settings);
+    other.run();
+    EXPECT_EQ(other.statistics().mean().collision, mean.collision);
+    EXPECT_EQ(other.statistics().mean().absorption, mean.absorption);
+    EXPECT_EQ(other.statistics().mean().track_length, mean.track_length);
+  }
+
+  TEST(Eigenvalue, entropy) {
+    // A source in one corner spreads over the box, after which the
+    // inactive batches end
+    auto geom = make_fuel_box();
+    std::vector<SourceSite> source;
+    for (const auto& site : make_source(2000))
+      source.push_back({0.1 * site.r + Position(-9., -9., -9.), site.u, 2., 1.});
+
+    EigenvalueSettings settings;
+    settings.particles = 2000;
+    settings.inactive = 60;
+    settings.active = 5;
+    settings.entropy_mesh = std::make_shared<EntropyMesh>(
+        Position(-10., -10., -10.), Position(10., 10., 10.), 4, 4, 4);
+    settings.entropy_window = 8;
+    PowerIteration power(*geom, source, settings);
+    std::vector<BatchResult> batches = power.run();
+
+    EXPECT_GE(power.inactive(), 8u);
+    EXPECT_LT(power.inactive(), 60u);
+    ASSERT_EQ(batches.size(), power.inactive() + 5);
+    ASSERT_EQ(power.entropy().size(), batches.size());
+    EXPECT_FALSE(batches[power.inactive() - 1].active);
+    EXPECT_TRUE(batches[power.inactive()].active);
+    EXPECT_EQ(power.statistics().batches(), 5u);
+
+    // The entropy rises towards that of a flat source on 64 cells
+    EXPECT_LT(batches[0].entropy, 4.);
+    EXPECT_EQ(batches[0].entropy, power.entropy()[0]);
+    EXPECT_GT(batches.back().entropy, 5.9);
+    EXPECT_LE(batches.back().entropy, 6.);
+
+    // Without the window, every inactive batch is run
+    settings.entropy_window = 0;
+    settings.inactive = 10;
+    PowerIteration fixed(*geom, source, settings);
+    fixed.run();
+    EXPECT_EQ(fixed.inactive(), 10u);
+    EXPECT_EQ(fixed.entropy().size(), 15u);
+
+    settings.entropy_window = 8;
+    settings.entropy_mesh = nullptr;
+    EXPECT_THROW(PowerIteration(*geom, source, settings), PMCException);
+  }
+
+  TEST(Eigenvalue, delta_tracking) {
+    auto geom = make_fuel_box();
+    EigenvalueSettings settings;
+    settings.particles = 2000;
+    settings.inactive = 3;
+    settings.active = 20;
+    settings.transport.tracking = Tracking::Delta;
+
+    PowerIteration power(*geom, make_source(2000), settings);
+    power.run();
+    const KeffStatistics& stats = power.statistics();
+    EXPECT_EQ(stats.mean().track_length, 0.);
+    EXPECT_NEAR(stats.combined(), 1.25, 4. * stats.combined_std_error());
+
+    settings.particles = 0;
+    EXPECT_THROW(PowerIteration(*geom, make_source(10), settings), PMCException);
+  }
+
+};
@@ -0,0 +1,100 @@
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/transport/entropy.hpp>
+#include <Papillon/transport/transport.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+
+namespace {
+  using namespace pmc;
+
+  TEST(EntropyMesh, cell) {
+    EntropyMesh mesh(Position(-2., 0., 0.), Position(2., 2., 1.), 4, 2, 1);
+    EXPECT_EQ(mesh.size(), 8u);
+    EXPECT_EQ(mesh.cell(Position(-1.5, 0.5, 0.5)), 0u);
+    EXPECT_EQ(mesh.cell(Position(1.5, 0.5, 0.5)), 3u);
+    EXPECT_EQ(mesh.cell(Position(0.5, 1.5, 0.5)), 6u);
+
+    // Outside of the mesh, on each side
+    EXPECT_EQ(mesh.cell(Position(-2.5, 0.5, 0.5)), 8u);
+    EXPECT_EQ(mesh.cell(Position(0., 2.5, 0.5)), 8u);
+    EXPECT_EQ(mesh.cell(Position(0., 0.5, -0.1)), 8u);
+    EXPECT_EQ(mesh.cell(Position(0., 0.5, 1.)), 8u);
+
+    EXPECT_THROW(EntropyMesh(Position(0., 0., 0.), Position(1., 1., 1.), 0, 1, 1),
+                 PMCException);
+    EXPECT_THROW(EntropyMesh(Position(0., 0., 0.), Position(1., -1., 1.), 1, 1, 1),
+                 PMCException);
+  }
+
+  TEST(EntropyMesh, entropy) {
+    EXPECT_EQ(EntropyMesh::entropy({}), 0.);
+    EXPECT_EQ(EntropyMesh::entropy({0., 0.}), 0.);
+    EXPECT_EQ(EntropyMesh::entropy({0., 3., 0.}), 0.);
+    EXPECT_NEAR(EntropyMesh::entropy(std::vector<double>(64, 2.5)), 6., 1.E-12);
+    EXPECT_NEAR(EntropyMesh::entropy({1., 1., 2.}), 1.5, 1.E-12);
+  }
+
+  TEST(EntropyMesh, transport_counts) {
+    // Fission sites counted while banked are those of the bank
+    const auto V = Surface::BoundaryType::Vacuum;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0., 0., 0., 10., V, 1);
+    auto sphere = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+    auto fuel = std::make_shared<Material>(1);
+    fuel->add_nuclide(std::make_shared<Nuclide>(
+                          "fuel", 233., std::vector<double>{1.E-11, 20.},
+                          std::vector<double>{4., 4.},
+                          std::vector<double>{1., 1.},
+                          std::vector<double>{1., 1.}, 2.5),
+                      0.05);
+    auto root = std::make_unique<GeoNode>(sphere, "sphere");
+    root->set_material(fuel);
+    Geometry geom(surfaces, std::move(root));
+
+    RNG rng(3);
+    std::vector<SourceSite> sites;
+    for (int i = 0; i < 2000; i++)
+      sites.push_back({Position(0., 0., 0.), Direction(2. * rng() - 1., 2. * PI * rng()), 2., 1.});
+
+    // A mesh over part of the sphere only
+    auto mesh = std::make_shared<EntropyMesh>(Position(-5., -5., -5.),
+                                              Position(5., 5., 5.), 3, 3, 3);
+    TransportSettings settings;
+    settings.fission_neutrons = FissionNeutrons::Bank;
+    settings.entropy_mesh = mesh;
+    settings.threads = 1;
+    std::vector<SourceSite> bank;
+    TransportResult result = transport(geom, sites, settings, bank);
+    ASSERT_GT(bank.size(), 0u);
+
+    std::vector<double> expected(mesh->size(), 0.);
+    size_t outside = 0;
+    for (const auto& site : bank) {
+      size_t cell = mesh->cell(site.r);
+      if (cell < mesh->size()) expected[cell] += site.weight;
+      else outside++;
+    }
+    EXPECT_GT(outside, 0u);
+    ASSERT_EQ(result.source_mesh.size(), mesh->size());
+    for (size_t c = 0; c < mesh->size(); c++)
+      EXPECT_EQ(result.source_mesh[c], expected[c]);
+
+    // The same counts on any number of threads, or event by event
+    settings.threads = 3;
+    settings.mode = TransportMode::Event;
+    settings.event_bank_size = 500;
+    TransportResult other = transport(geom, sites, settings, bank);
+    for (size_t c = 0; c < mesh->size(); c++)
+      EXPECT_EQ(other.source_mesh[c], expected[c]);
+
+    // Nothing is counted unless fission sites are banked
+    settings.fission_neutrons = FissionNeutrons::Ignore;
+    EXPECT_TRUE(transport(geom, sites, settings).source_mesh.empty());
+  }
+
+};
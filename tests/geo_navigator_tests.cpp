@@ -0,0 +1,247 @@
+#include <Papillon/geometry/geo_navigator.hpp>
+#include <Papillon/geometry/rect_lattice.hpp>
+#include <Papillon/geometry/csg/difference.hpp>
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/csg/union.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <unordered_map>
+
+// Counts every allocation made through operator new by the test program, so
+// that tests can check that a piece of code allocates nothing.
+namespace {
+  std::atomic<size_t> n_allocations{0};
+}
+
+void* operator new(size_t n) {
+  n_allocations++;
+  void* p = std::malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+  using namespace pmc;
+
+  // Sphere of radius 2 inside of a sphere of radius 5, both at the origin
+  std::unique_ptr<Geometry> make_geometry() {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0.,0.,0.,2.,Surface::BoundaryType::Transparent,1);
+    surfaces[2] = std::make_shared<Sphere>(0.,0.,0.,5.,Surface::BoundaryType::Vacuum,2);
+
+    auto inner = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+    auto outer = std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2);
+
+    auto root = std::make_unique<GeoNode>(outer, "root");
+    root->add_node(inner, Transformation(), "inner");
+
+    return std::make_unique<Geometry>(surfaces, std::move(root));
+  }
+
+  TEST(GeoNavigator, find_location) {
+    auto geom = make_geometry();
+
+    GeoNavigator nav(geom.get(), {0.,0.,0.}, {1.,0.,0.});
+    EXPECT_FALSE(nav.is_lost());
+    EXPECT_EQ(nav.current_node()->name(), "inner");
+
+    nav.find_location_from_root({3.,0.,0.}, {1.,0.,0.});
+    EXPECT_FALSE(nav.is_lost());
+    EXPECT_EQ(nav.current_node()->name(), "root");
+
+    nav.find_location_from_root({6.,0.,0.}, {1.,0.,0.});
+    EXPECT_TRUE(nav.is_lost());
+  }
+
+  TEST(GeoNavigator, cross_boundaries) {
+    auto geom = make_geometry();
+    const SurfaceTable& table = geom->surface_table();
+
+    GeoNavigator nav(geom.get(), {0.,0.,0.}, {1.,0.,0.});
+
+    GeoNavigator::Boundary b1 = nav.find_next_boundary();
+    EXPECT_DOUBLE_EQ(b1.distance, 2.);
+    EXPECT_EQ(b1.surface->id(), 1u);
+    EXPECT_EQ(b1.surface_index, table.index(1));
+    EXPECT_EQ(b1.side, Surface::Side::Negative);
+
+    nav.cross_next_boundary();
+    nav.find_location_from_current();
+    EXPECT_EQ(nav.current_node()->name(), "root");
+    EXPECT_DOUBLE_EQ(nav.r_local().x(), 2.);
+
+    GeoNavigator::Boundary b2 = nav.find_next_boundary();
+    EXPECT_DOUBLE_EQ(b2.distance, 3.);
+    EXPECT_EQ(b2.surface->id(), 2u);
+    EXPECT_EQ(b2.surface->boundary(), Surface::BoundaryType::Vacuum);
+  }
+
+  TEST(GeoNavigator, reflect) {
+    auto geom = make_geometry();
+
+    GeoNavigator nav(geom.get(), {3.,0.,0.}, {1.,0.,0.});
+    GeoNavigator::Boundary b = nav.find_next_boundary();
+    EXPECT_DOUBLE_EQ(b.distance, 2.);
+
+    nav.reflect_with_next_boundary();
+    EXPECT_DOUBLE_EQ(nav.r_local().x(), 5.);
+    EXPECT_DOUBLE_EQ(nav.u_local().x(), -1.);
+    EXPECT_TRUE(nav.is_inside_current());
+  }
+
+  TEST(GeoNavigator, boundary_cache) {
+    auto geom = make_geometry();
+
+    GeoNavigator nav(geom.get(), {0.,0.,0.}, {1.,0.,0.});
+    EXPECT_DOUBLE_EQ(nav.find_next_boundary().distance, 2.);
+
+    // Moving along the same direction brings the cached boundary closer
+    nav.move_distance(0.5);
+    nav.move_distance(0.25);
+    GeoNavigator::Boundary b = nav.find_next_boundary();
+    EXPECT_DOUBLE_EQ(b.distance, 1.25);
+    EXPECT_EQ(b.surface->id(), 1u);
+    GeoNavigator fresh(geom.get(), nav.r_global(), nav.u_global());
+    EXPECT_DOUBLE_EQ(fresh.find_next_boundary().distance, b.distance);
+
+    // Changing direction finds the boundary again
+    nav.set_direction({0.,1.,0.});
+    EXPECT_DOUBLE_EQ(nav.find_next_boundary().distance, std::sqrt(4. - 0.75*0.75));
+
+    // So does crossing it
+    nav.cross_next_boundary();
+    nav.find_location_from_current();
+    EXPECT_EQ(nav.current_node()->name(), "root");
+    EXPECT_DOUBLE_EQ(nav.find_next_boundary().distance,
+                     std::sqrt(25. - 0.75*0.75) - std::sqrt(4. - 0.75*0.75));
+  }
+
+  TEST(GeoNavigator, coordinate_stack) {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0.,0.,0.,1.,Surface::BoundaryType::Transparent,1);
+    surfaces[2] = std::make_shared<Sphere>(0.,0.,0.,3.,Surface::BoundaryType::Transparent,2);
+    surfaces[3] = std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,3);
+
+    auto inner = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+    auto middle = std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2);
+    auto outer = std::make_shared<HalfSpace>(surfaces[3], Surface::Side::Negative, 3);
+
+    // The middle node is rotated and moved, the inner one moved again
+    auto root = std::make_unique<GeoNode>(outer, "root");
+    GeoNode* mid = root->add_node(middle,
+        Transformation::translation(2., 0., 0.) * Transformation::rotation_z(0.5*PI), "middle");
+    mid->add_node(inner, Transformation::translation(1., 0., 0.), "inner");
+    Geometry geom(surfaces, std::move(root));
+
+    // The inner sphere is centered at (2, 1, 0) in the root frame
+    GeoNavigator nav(&geom, {2., 1.5, 0.}, {0., 1., 0.});
+    ASSERT_EQ(nav.current_node()->name(), "inner");
+    EXPECT_EQ(nav.depth(), 3u);
+    EXPECT_NEAR(nav.r_local().x(), 0.5, 1.E-12);
+    EXPECT_NEAR(nav.u_local().x(), 1., 1.E-12);
+
+    // Leaving the inner sphere pops back to the middle node, whose
+    // coordinates were kept up to date.
+    GeoNavigator::Boundary b = nav.find_next_boundary();
+    EXPECT_NEAR(b.distance, 0.5, 1.E-12);
+    nav.cross_next_boundary();
+    nav.find_location_from_current();
+    EXPECT_EQ(nav.current_node()->name(), "middle");
+    EXPECT_NEAR(nav.r_local().x(), 2., 1.E-12);
+    EXPECT_NEAR(nav.r_global().y(), 2., 1.E-12);
+
+    // Directions set in the local frame are carried up to the root
+    nav.set_direction({0., 1., 0.});
+    EXPECT_NEAR(nav.u_global().x(), -1., 1.E-12);
+    nav.move_distance(1.);
+    EXPECT_NEAR(nav.r_global().x(), 1., 1.E-12);
+    EXPECT_NEAR(nav.r_global().y(), 2., 1.E-12);
+
+    b = nav.find_next_boundary();
+    EXPECT_NEAR(b.distance, std::sqrt(5.) - 1., 1.E-12);
+    nav.cross_next_boundary();
+    nav.find_location_from_current();
+    EXPECT_EQ(nav.current_node()->name(), "root");
+    EXPECT_EQ(nav.depth(), 1u);
+  }
+
+  TEST(GeoNavigator, no_allocations) {
+    // Reflected 3x3 lattice of pins, whose cells use every kind of volume
+    const auto T = Surface::BoundaryType::Transparent;
+    const auto R = Surface::BoundaryType::Reflective;
+    const auto N = Surface::Side::Negative;
+    const auto P = Surface::Side::Positive;
+    const double pitch = 1.26;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<ZCylinder>(0., 0., 0.4, T, 1);
+    surfaces[2] = std::make_shared<ZCylinder>(0., 0., 0.47, T, 2);
+    surfaces[3] = std::make_shared<XPlane>(-1.5*pitch, R, 3);
+    surfaces[4] = std::make_shared<XPlane>(1.5*pitch, R, 4);
+    surfaces[5] = std::make_shared<YPlane>(-1.5*pitch, R, 5);
+    surfaces[6] = std::make_shared<YPlane>(1.5*pitch, R, 6);
+
+    auto fuel = std::make_shared<HalfSpace>(surfaces[1], N, 1);
+    auto clad = std::make_shared<Difference>(
+        std::make_shared<HalfSpace>(surfaces[2], N, 2), fuel, 3);
+    auto everywhere = std::make_shared<Union>(
+        std::make_shared<HalfSpace>(surfaces[2], N, 4),
+        std::make_shared<HalfSpace>(surfaces[2], P, 5), 6);
+    auto box = std::make_shared<Intersection>(
+        std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[3], P, 7),
+                                       std::make_shared<HalfSpace>(surfaces[4], N, 8), 9),
+        std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[5], P, 10),
+                                       std::make_shared<HalfSpace>(surfaces[6], N, 11), 12), 13);
+
+    auto pin = std::make_shared<GeoNode>(everywhere, "moderator");
+    pin->add_node(fuel, Transformation(), "fuel");
+    pin->add_node(clad, Transformation(), "clad");
+    auto root = std::make_unique<RectLattice>(box, 3, 3, 1, pitch, pitch, INF,
+                                              Position(-1.5*pitch, -1.5*pitch, 0.), "core");
+    root->fill(pin);
+    Geometry geom(surfaces, std::move(root));
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> unif(0., 1.);
+    GeoNavigator nav(&geom, {0.1, 0.2, 0.}, {1., 0., 0.});
+
+    const size_t before = n_allocations;
+    size_t n_lost = 0;
+    size_t n_reflections = 0;
+    for (size_t step = 0; step < 1000000; step++) {
+      GeoNavigator::Boundary b = nav.find_next_boundary();
+      double d = -0.7 * std::log(unif(rng));
+      if (d < b.distance) {
+        // Collision, with an isotropic new direction
+        double mu = 2. * unif(rng) - 1.;
+        double phi = 2. * PI * unif(rng);
+        nav.move_distance(d);
+        nav.set_direction(Direction(mu, phi));
+      } else if (b.surface && b.surface->boundary() == R) {
+        nav.reflect_with_next_boundary();
+        n_reflections++;
+      } else {
+        nav.cross_next_boundary();
+        nav.find_location_from_current();
+        if (nav.is_lost()) n_lost++;
+      }
+    }
+    const size_t after = n_allocations;
+
+    EXPECT_EQ(after - before, 0u);
+    EXPECT_EQ(n_lost, 0u);
+    EXPECT_GT(n_reflections, 0u);
+  }
+};
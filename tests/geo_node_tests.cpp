@@ -0,0 +1,228 @@
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/csg/union.hpp>
+#include <Papillon/geometry/geo_navigator.hpp>
+#include <Papillon/geometry/geo_node.hpp>
+#include <Papillon/geometry/surfaces/plane.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  const auto T = Surface::BoundaryType::Transparent;
+  const auto N = Surface::Side::Negative;
+  const auto P = Surface::Side::Positive;
+
+  struct Model {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    std::shared_ptr<Volume> world, ball, core;
+
+    Model() {
+      surfaces[1] = std::make_shared<Sphere>(0., 0., 0., 20., Surface::BoundaryType::Vacuum, 1);
+      surfaces[2] = std::make_shared<Sphere>(0., 0., 0., 1., T, 2);
+      surfaces[3] = std::make_shared<Sphere>(0., 0., 0., 0.5, T, 3);
+      world = std::make_shared<HalfSpace>(surfaces[1], N, 1);
+      ball = std::make_shared<HalfSpace>(surfaces[2], N, 2);
+      core = std::make_shared<HalfSpace>(surfaces[3], N, 3);
+    }
+  };
+
+  TEST(GeoNode, add_instance) {
+    Model m;
+    auto universe = std::make_shared<GeoNode>(m.ball, "ball");
+    universe->add_node(m.core, Transformation(), "core");
+
+    auto root = std::make_unique<GeoNode>(m.world, "root");
+    for (double x : {-5., 0., 5.})
+      root->add_instance(universe, Transformation::translation(x, 0., 0.));
+    EXPECT_EQ(root->nchildren(), 3u);
+    EXPECT_EQ(root->nuniverses(), 1u);
+    EXPECT_EQ(universe->parent(), nullptr);
+
+    Geometry geom(m.surfaces, std::move(root));
+    for (double x : {-5., 0., 5.}) {
+      GeoNavigator nav(&geom, {x + 0.25, 0.1, 0.}, {1., 0., 0.});
+      EXPECT_EQ(nav.current_node()->name(), "core");
+      EXPECT_EQ(nav.depth(), 3u);
+      EXPECT_NEAR(nav.r_local().x(), 0.25, 1.E-12);
+
+      GeoNavigator::Boundary b = nav.find_next_boundary();
+      EXPECT_EQ(b.surface->id(), 3u);
+    }
+
+    GeoNavigator nav(&geom, {2.5, 0., 0.}, {1., 0., 0.});
+    EXPECT_EQ(nav.current_node()->name(), "root");
+    EXPECT_NEAR(nav.find_next_boundary().distance, 1.5, 1.E-12);
+  }
+
+  TEST(GeoNode, neighbor_lists) {
+    Model m;
+    auto universe = std::make_shared<GeoNode>(m.ball, "ball");
+    auto root = std::make_unique<GeoNode>(m.world, "root");
+    for (double x : {-3., 0., 3.})
+      root->add_instance(universe, Transformation::translation(x, 0., 0.));
+    Geometry geom(m.surfaces, std::move(root));
+    const GeoNode& world = *geom.root();
+    uint32_t ball = geom.surface_table().index(2);
+
+    ASSERT_NE(world.neighbors(ball, N), nullptr);
+    EXPECT_EQ(world.neighbors(ball, N)->size(), 0u);
+    EXPECT_EQ(world.neighbors(geom.surface_table().index(1), N), nullptr);
+
+    // Entering the ball at x = 3 from the left is learned, and found again
+    for (int i = 0; i < 2; i++) {
+      GeoNode::ChildLocation found =
+          world.find_child_across({2., 0., 0.}, {1., 0., 0.}, 2, N, ball);
+      EXPECT_EQ(found.node, universe.get());
+      EXPECT_EQ(found.element, 2u);
+      EXPECT_EQ(world.neighbors(ball, N)->size(), 1u);
+    }
+
+    // A listed child which does not hold the point falls back to the search
+    GeoNode::ChildLocation found =
+        world.find_child_across({-2., 0., 0.}, {-1., 0., 0.}, 2, N, ball);
+    EXPECT_EQ(found.element, 0u);
+    EXPECT_EQ(world.neighbors(ball, N)->size(), 2u);
+
+    // Leaving a ball lands in no child, which is not listed
+    found = world.find_child_across({1., 0., 0.}, {1., 0., 0.}, 2, P, ball);
+    EXPECT_EQ(found.node, nullptr);
+    EXPECT_EQ(world.neighbors(ball, P)->size(), 0u);
+  }
+
+  TEST(GeoNode, union_boundary) {
+    Model m;
+    m.surfaces[4] = std::make_shared<Sphere>(1.5, 0., 0., 1., T, 4);
+    auto shifted = std::make_shared<HalfSpace>(m.surfaces[4], N, 4);
+    auto both = std::make_shared<Union>(m.ball, shifted, 5);
+
+    auto root = std::make_unique<GeoNode>(m.world, "root");
+    root->add_node(both, Transformation(), "both");
+    Geometry geom(m.surfaces, std::move(root));
+    GeoNavigator nav(&geom, {0., 0., 0.}, {1., 0., 0.});
+    ASSERT_EQ(nav.current_node()->name(), "both");
+
+    // The surface of the second ball, inside of the union, is not a boundary
+    GeoNavigator::Boundary b = nav.find_next_boundary();
+    EXPECT_DOUBLE_EQ(b.distance, 2.5);
+    EXPECT_EQ(b.surface->id(), 4u);
+  }
+
+  TEST(GeoNode, distance_to_boundary_batch) {
+    // A ball with a hole along z, cut by two planes
+    Model m;
+    m.surfaces[4] = std::make_shared<ZCylinder>(0.1, 0., 0.3, T, 4);
+    m.surfaces[5] = std::make_shared<XPlane>(-0.6, T, 5);
+    m.surfaces[6] = std::make_shared<Plane>(0.3, 0.4, 0.5, 0.4, T, 6);
+    auto hole = std::make_shared<HalfSpace>(m.surfaces[4], P, 4);
+    auto left = std::make_shared<HalfSpace>(m.surfaces[5], P, 5);
+    auto cut = std::make_shared<HalfSpace>(m.surfaces[6], N, 6);
+    auto shell = std::make_shared<Intersection>(
+        std::make_shared<Intersection>(m.ball, hole, 7),
+        std::make_shared<Intersection>(left, cut, 8), 9);
+
+    auto root = std::make_unique<GeoNode>(m.world, "root");
+    GeoNode* node = root->add_node(shell, Transformation(), "shell");
+    m.surfaces[7] = std::make_shared<Sphere>(5., 0., 0., 1., T, 7);
+    auto other = std::make_shared<HalfSpace>(m.surfaces[7], N, 10);
+    GeoNode* both = root->add_node(std::make_shared<Union>(m.ball, other, 11),
+                                   Transformation(), "both");
+    Geometry geom(m.surfaces, std::move(root));
+
+    std::mt19937_64 gen(7);
+    std::uniform_real_distribution<double> dist(-1., 1.);
+    std::vector<double> x, y, z, u, v, w;
+    std::vector<Direction> dirs;
+    while (x.size() < 200) {
+      Position r(dist(gen), dist(gen), dist(gen));
+      if (!node->is_inside_local_frame(r, {1., 0., 0.}, 0, P)) continue;
+      Direction d(dist(gen), dist(gen), dist(gen));
+      x.push_back(r.x()); y.push_back(r.y()); z.push_back(r.z());
+      u.push_back(d.x()); v.push_back(d.y()); w.push_back(d.z());
+      dirs.push_back(d);
+    }
+    // Rays along the axis of the hole, and parallel to the planes
+    for (Direction d : {Direction(0., 0., 1.), Direction(0., 1., 0.)}) {
+      x.push_back(0.5); y.push_back(0.); z.push_back(0.);
+      u.push_back(d.x()); v.push_back(d.y()); w.push_back(d.z());
+      dirs.push_back(d);
+    }
+    const size_t n = x.size();
+
+    std::vector<double> scratch(n), distance(n);
+    std::vector<uint32_t> surface(n);
+    ASSERT_TRUE(node->distance_to_boundary_batch(x.data(), y.data(), z.data(), u.data(), v.data(), w.data(),
+                                                 scratch.data(), n, distance.data(), surface.data()));
+    for (size_t i = 0; i < n; i++) {
+      // Both transport modes must agree exactly, so the distances must not
+      // differ by even a rounding error
+      SurfaceCrossing c = node->distance_to_boundary({x[i], y[i], z[i]}, dirs[i]);
+      EXPECT_EQ(distance[i], c.distance);
+      EXPECT_EQ(surface[i], c.surface);
+    }
+
+    // The nearest surface of a union is not always its boundary
+    EXPECT_FALSE(both->distance_to_boundary_batch(x.data(), y.data(), z.data(), u.data(), v.data(), w.data(),
+                                                  scratch.data(), n, distance.data(), surface.data()));
+  }
+
+  TEST(GeoNode, clone_shares_universes) {
+    Model m;
+    auto universe = std::make_shared<GeoNode>(m.ball, "ball");
+
+    GeoNode node(m.world, "node");
+    node.add_instance(universe, Transformation::translation(3., 0., 0.));
+    node.add_node(m.core, Transformation::translation(-3., 0., 0.), "owned");
+
+    std::unique_ptr<GeoNode> copy = node.clone();
+    EXPECT_EQ(copy->nchildren(), 2u);
+    EXPECT_EQ(copy->nuniverses(), 1u);
+
+    GeoNode* c1 = copy->find_child_node({3., 0., 0.}, {1., 0., 0.}, 0, P);
+    EXPECT_EQ(c1, universe.get());
+    GeoNode* c2 = copy->find_child_node({-3., 0., 0.}, {1., 0., 0.}, 0, P);
+    ASSERT_NE(c2, nullptr);
+    EXPECT_EQ(c2->name(), "owned");
+    EXPECT_NE(c2, node.find_child_node({-3., 0., 0.}, {1., 0., 0.}, 0, P));
+  }
+
+  TEST(GeoNode, move_child) {
+    Model m;
+    GeoNode node(m.world, "node");
+    GeoNode* child = node.add_node(m.ball, Transformation(), "child");
+    EXPECT_EQ(node.find_child_node({0., 0., 0.}, {1., 0., 0.}, 0, P), child);
+
+    child->set_transformation(Transformation::translation(0., 4., 0.));
+    EXPECT_EQ(node.find_child_node({0., 0., 0.}, {1., 0., 0.}, 0, P), nullptr);
+    EXPECT_EQ(node.find_child_node({0., 4.5, 0.}, {1., 0., 0.}, 0, P), child);
+  }
+
+  TEST(GeoNode, transformations) {
+    Model m;
+    using Kind = Transformation::Kind;
+
+    GeoNode plain(m.ball, "plain");
+    EXPECT_EQ(plain.transformation().kind(), Kind::Identity);
+
+    GeoNode moved(m.ball, Transformation::translation(1., 2., 3.), "moved");
+    EXPECT_EQ(moved.transformation().kind(), Kind::Translation);
+    EXPECT_DOUBLE_EQ(moved.transformation()[1][3], -2.);
+    EXPECT_DOUBLE_EQ(moved.inverse_transformation()[1][3], 2.);
+
+    moved.set_transformation(Transformation::rotation_x(0.3));
+    EXPECT_EQ(moved.transformation().kind(), Kind::RotationTranslation);
+    EXPECT_DOUBLE_EQ(moved.inverse_transformation()[1][2], -std::sin(0.3));
+
+    moved.set_transformation(Transformation::scale(2.));
+    EXPECT_EQ(moved.transformation().kind(), Kind::General);
+    EXPECT_TRUE(moved.is_inside_parent_frame({0., 0., 1.5}, {1., 0., 0.}, 0, P));
+  }
+};
@@ -51,4 +51,48 @@ namespace {
     EXPECT_EQ(bound2.current_side, x3->sign(r, u1));
   }
 
+  TEST(half_space, get_ray) {
+    std::shared_ptr<Surface> s = std::make_shared<Sphere>(0.,0.,0.,2.,Surface::BoundaryType::Transparent, 1);
+    HalfSpace in(s, Surface::Side::Negative, 1);
+    HalfSpace out(s, Surface::Side::Positive, 2);
+
+    // Passing through the sphere
+    Ray r1 = in.get_ray({-5.,0.,0.}, {1.,0.,0.});
+    ASSERT_EQ(r1.size(), 1u);
+    EXPECT_DOUBLE_EQ(r1[0].enter.distance, 3.);
+    EXPECT_EQ(r1[0].enter.side, Surface::Side::Positive);
+    EXPECT_DOUBLE_EQ(r1[0].exit.distance, 7.);
+    EXPECT_EQ(r1[0].exit.side, Surface::Side::Negative);
+
+    Ray r2 = out.get_ray({-5.,0.,0.}, {1.,0.,0.});
+    ASSERT_EQ(r2.size(), 2u);
+    EXPECT_DOUBLE_EQ(r2[0].enter.distance, 0.);
+    EXPECT_DOUBLE_EQ(r2[0].exit.distance, 3.);
+    EXPECT_DOUBLE_EQ(r2[1].enter.distance, 7.);
+    EXPECT_GE(r2[1].exit.distance, INF);
+
+    // Starting inside, and starting on the surface heading in
+    Ray r3 = in.get_ray({1.,0.,0.}, {1.,0.,0.});
+    ASSERT_EQ(r3.size(), 1u);
+    EXPECT_DOUBLE_EQ(r3[0].enter.distance, 0.);
+    EXPECT_DOUBLE_EQ(r3.next_crossing().distance, 1.);
+    Ray r4 = in.get_ray({2.,0.,0.}, {-1.,0.,0.}, 1, Surface::Side::Negative);
+    ASSERT_EQ(r4.size(), 1u);
+    EXPECT_DOUBLE_EQ(r4.next_crossing().distance, 4.);
+    Ray r5 = in.get_ray({2.,0.,0.}, {-1.,0.,0.});
+    ASSERT_EQ(r5.size(), 1u);
+    EXPECT_DOUBLE_EQ(r5.next_crossing().distance, 4.);
+
+    // Missing it
+    EXPECT_TRUE(in.get_ray({-5.,3.,0.}, {1.,0.,0.}).empty());
+
+    // A plane is crossed at most once
+    std::shared_ptr<Surface> x3 = std::make_shared<XPlane>(3.,Surface::BoundaryType::Transparent, 2);
+    HalfSpace px(x3, Surface::Side::Positive, 3);
+    Ray r6 = px.get_ray({0.,0.,0.}, {1.,0.,0.});
+    ASSERT_EQ(r6.size(), 1u);
+    EXPECT_DOUBLE_EQ(r6[0].enter.distance, 3.);
+    EXPECT_GE(r6[0].exit.distance, INF);
+  }
+
 };
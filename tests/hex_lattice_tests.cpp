@@ -0,0 +1,218 @@
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/geo_navigator.hpp>
+#include <Papillon/geometry/hex_lattice.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <Papillon/materials/material.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  using Orientation = HexLattice::Orientation;
+
+  std::shared_ptr<Volume> world_volume() {
+    return std::make_shared<HalfSpace>(
+        std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,1),
+        Surface::Side::Negative, 1);
+  }
+
+  // Two rings of pins (7 elements), with a pitch of 1, infinite along z
+  std::unique_ptr<Geometry> make_geometry(Orientation orientation) {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<ZCylinder>(0.,0.,0.3,Surface::BoundaryType::Transparent,1);
+    surfaces[2] = std::make_shared<Sphere>(0.,0.,0.,100.,Surface::BoundaryType::Transparent,2);
+    surfaces[3] = std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,3);
+
+    auto fuel = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+    auto cell = std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2);
+    auto world = std::make_shared<HalfSpace>(surfaces[3], Surface::Side::Negative, 3);
+
+    auto pin = std::make_shared<GeoNode>(cell, "moderator");
+    pin->add_node(fuel, Transformation(), "fuel");
+
+    auto core = std::make_unique<HexLattice>(world, orientation, 2, 1, 1., INF,
+                                             Position(), "core");
+    core->fill(pin);
+    return std::make_unique<Geometry>(surfaces, std::move(core));
+  }
+
+  TEST(HexLattice, element_index) {
+    for (auto orientation : {Orientation::X, Orientation::Y}) {
+      HexLattice lat(world_volume(), orientation, 3, 2, 1.5, 2., Position(1., -1., 0.), "lat");
+
+      // Every center, and points near it, are found in their element
+      std::mt19937_64 rng(5);
+      std::uniform_real_distribution<double> off(-0.5, 0.5);
+      for (int32_t q = -2; q <= 2; q++) {
+        for (int32_t r = -2; r <= 2; r++) {
+          if (std::abs(q + r) > 2) continue;
+          for (uint32_t k = 0; k < 2; k++) {
+            Position c = lat.element_center(q, r, k);
+            uint32_t e = 0, e_center = 0;
+            ASSERT_TRUE(lat.element_index(c, {1.,0.,0.}, e_center));
+            // Within the inscribed circle of the hexagon
+            Position p = c + Position(off(rng), off(rng), 0.);
+            ASSERT_TRUE(lat.element_index(p, {1.,0.,0.}, e));
+            EXPECT_EQ(e, e_center);
+          }
+        }
+      }
+
+      uint32_t e = 0;
+      EXPECT_FALSE(lat.element_index({20., 0., 1.}, {1.,0.,0.}, e));
+      EXPECT_FALSE(lat.element_index({1., -1., 4.5}, {1.,0.,0.}, e));
+      EXPECT_FALSE(lat.element_index({1., -1., -0.5}, {1.,0.,0.}, e));
+      EXPECT_THROW(lat.set_element(2, 1, 0, nullptr), PMCException);
+    }
+  }
+
+  TEST(HexLattice, walls) {
+    HexLattice y(world_volume(), Orientation::Y, 2, 1, 2., INF, Position(), "y");
+    uint32_t e = 0;
+    ASSERT_TRUE(y.element_index({0., 0., 0.}, {0.,1.,0.}, e));
+
+    // Flats normal to y are at a distance of half a pitch
+    EXPECT_NEAR(y.distance_to_element_boundary({0.,0.,0.}, {0.,1.,0.}, e), 1., 1.E-12);
+    // Along x, the ray leaves through a vertex, at the circumradius
+    EXPECT_NEAR(y.distance_to_element_boundary({0.,0.,0.}, {1.,0.,0.}, e), 2./std::sqrt(3.), 1.E-12);
+
+    // On the top flat, going up, the point is in the element above
+    uint32_t e_up = 0;
+    ASSERT_TRUE(y.element_index({0., 1., 0.}, {0.,1.,0.}, e_up));
+    EXPECT_NE(e_up, e);
+    ASSERT_TRUE(y.element_index({0., 1., 0.}, {0.,-1.,0.}, e_up));
+    EXPECT_EQ(e_up, e);
+
+    HexLattice x(world_volume(), Orientation::X, 2, 3, 2., 1., Position(0., 0., -1.5), "x");
+    ASSERT_TRUE(x.element_index({0., 0., 0.}, {1.,0.,0.}, e));
+    EXPECT_NEAR(x.distance_to_element_boundary({0.,0.,0.}, {1.,0.,0.}, e), 1., 1.E-12);
+    EXPECT_NEAR(x.distance_to_element_boundary({0.,0.,0.}, {0.,1.,0.}, e), 2./std::sqrt(3.), 1.E-12);
+    EXPECT_NEAR(x.distance_to_element_boundary({0.,0.,0.}, {0.,0.,1.}, e), 0.5, 1.E-12);
+  }
+
+  TEST(HexLattice, stream_across) {
+    for (auto orientation : {Orientation::X, Orientation::Y}) {
+      auto geom = make_geometry(orientation);
+
+      // A line of three pins lies along x for X, and along y for Y
+      Position start = orientation == Orientation::X ? Position(-8., 0.1, 0.)
+                                                     : Position(0.1, -8., 0.);
+      Direction u = orientation == Orientation::X ? Direction(1., 0., 0.)
+                                                  : Direction(0., 1., 0.);
+      GeoNavigator nav(geom.get(), start, u);
+      EXPECT_EQ(nav.current_node()->name(), "core");
+
+      int nfuel = 0;
+      double in_fuel = 0.;
+      double travelled = 0.;
+      while (!nav.is_lost()) {
+        GeoNavigator::Boundary b = nav.find_next_boundary();
+        if (nav.current_node()->name() == "fuel") in_fuel += b.distance;
+        travelled += b.distance;
+        if (b.surface && b.surface->boundary() == Surface::BoundaryType::Vacuum) break;
+        nav.cross_next_boundary();
+        nav.find_location_from_current();
+        if (nav.current_node()->name() == "fuel") nfuel++;
+      }
+
+      double h = std::sqrt(0.3*0.3 - 0.1*0.1);
+      EXPECT_EQ(nfuel, 3);
+      EXPECT_NEAR(in_fuel, 6.*h, 1.E-9);
+      EXPECT_NEAR(travelled, 8. + std::sqrt(100. - 0.01), 1.E-9);
+    }
+  }
+
+  TEST(HexLattice, clone_parent) {
+    // A hex core inside of a node, with a different material in its central
+    // element, which must still be found through a clone of the node
+    for (auto orientation : {Orientation::X, Orientation::Y}) {
+      std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+      surfaces[1] = std::make_shared<Sphere>(0.,0.,0.,100.,Surface::BoundaryType::Transparent,1);
+      surfaces[2] = std::make_shared<Sphere>(0.,0.,0.,5.,Surface::BoundaryType::Transparent,2);
+      surfaces[3] = std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,3);
+      auto cell = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+      auto inner = std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2);
+      auto world = std::make_shared<HalfSpace>(surfaces[3], Surface::Side::Negative, 3);
+
+      auto center = std::make_shared<GeoNode>(cell, "center");
+      center->set_material(std::make_shared<Material>(1, "mat_center"));
+      auto outer = std::make_shared<GeoNode>(cell, "outer");
+      outer->set_material(std::make_shared<Material>(2, "mat_outer"));
+
+      auto core = std::make_unique<HexLattice>(inner, orientation, 2, 1, 1., INF,
+                                               Position(), "core");
+      core->fill(outer);
+      core->set_element(0, 0, 0, center);
+      Position c = core->element_center(1, 0, 0);
+
+      GeoNode root(world, "root");
+      root.add_node(std::move(core));
+      Geometry geom(surfaces, root.clone());
+
+      GeoNavigator nav(&geom, {0.1, 0., 0.}, {1.,0.,0.});
+      ASSERT_NE(nav.current_node()->material(), nullptr);
+      EXPECT_EQ(nav.current_node()->material()->name(), "mat_center");
+      nav.find_location_from_root(c, {1.,0.,0.});
+      ASSERT_NE(nav.current_node()->material(), nullptr);
+      EXPECT_EQ(nav.current_node()->material()->name(), "mat_outer");
+
+      // A lattice cloned on its own keeps its elements
+      auto copy = geom.root()->find_child_node(c, {1.,0.,0.}, 0,
+                                               Surface::Side::Positive)->clone();
+      auto* lat = dynamic_cast<HexLattice*>(copy.get());
+      ASSERT_NE(lat, nullptr);
+      EXPECT_EQ(lat->element(0, 0, 0)->name(), "center");
+      EXPECT_EQ(lat->element(-1, 1, 0)->name(), "outer");
+      EXPECT_EQ(lat->orientation(), orientation);
+    }
+  }
+
+  TEST(HexLattice, bounded_universe) {
+    // A sphere of radius 0.3 in the central element only, which does not
+    // fill it, and must be entered and left on the way across
+    for (auto orientation : {Orientation::X, Orientation::Y}) {
+      std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+      surfaces[1] = std::make_shared<Sphere>(0.,0.,0.,0.3,Surface::BoundaryType::Transparent,1);
+      surfaces[2] = std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,2);
+      auto ball = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+      auto world = std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2);
+
+      auto core = std::make_unique<HexLattice>(world, orientation, 2, 1, 1., INF,
+                                               Position(), "core");
+      core->set_element(0, 0, 0, std::make_shared<GeoNode>(ball, "ball"));
+      Geometry geom(surfaces, std::move(core));
+
+      // Along x for X, and along y for Y, the flats are at -0.5 and 0.5
+      Direction u = orientation == Orientation::X ? Direction(1., 0., 0.)
+                                                  : Direction(0., 1., 0.);
+      GeoNavigator nav(&geom, -1.2*u, u);
+      ASSERT_EQ(nav.current_node()->name(), "core");
+
+      std::vector<std::string> names;
+      std::vector<double> positions;
+      double x = -1.2;
+      for (int i = 0; i < 4 && !nav.is_lost(); i++) {
+        GeoNavigator::Boundary b = nav.find_next_boundary();
+        x += b.distance;
+        positions.push_back(x);
+        nav.cross_next_boundary();
+        nav.find_location_from_current();
+        names.push_back(nav.current_node()->name());
+      }
+
+      std::vector<std::string> expected{"core", "ball", "core", "core"};
+      EXPECT_EQ(names, expected);
+      ASSERT_EQ(positions.size(), 4u);
+      EXPECT_NEAR(positions[0], -0.5, 1.E-9);
+      EXPECT_NEAR(positions[1], -0.3, 1.E-9);
+      EXPECT_NEAR(positions[2], 0.3, 1.E-9);
+      EXPECT_NEAR(positions[3], 0.5, 1.E-9);
+    }
+  }
+};
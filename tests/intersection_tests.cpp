@@ -51,4 +51,23 @@ namespace {
     auto bound3 = i.get_boundary(r, u3);
     EXPECT_DOUBLE_EQ(bound3.distance, INF);
   }
+
+  TEST(Intersection, get_ray) {
+    std::shared_ptr<Surface> x0 = std::make_shared<XPlane>(0., Surface::BoundaryType::Transparent, 1);
+    std::shared_ptr<Surface> x2 = std::make_shared<XPlane>(2., Surface::BoundaryType::Transparent, 2);
+    std::shared_ptr<Volume> px = std::make_shared<HalfSpace>(x0, Surface::Side::Positive, 1);
+    std::shared_ptr<Volume> nx = std::make_shared<HalfSpace>(x2, Surface::Side::Negative, 2);
+    Intersection slab(px, nx, 3);
+
+    Ray ray = slab.get_ray({-1., 0., 0.}, {1., 0., 0.});
+    ASSERT_EQ(ray.size(), 1u);
+    EXPECT_DOUBLE_EQ(ray[0].enter.distance, 1.);
+    EXPECT_EQ(ray[0].enter.side, Surface::Side::Negative);
+    EXPECT_DOUBLE_EQ(ray[0].exit.distance, 3.);
+    EXPECT_EQ(ray[0].exit.side, Surface::Side::Negative);
+
+    EXPECT_DOUBLE_EQ(slab.get_ray({1., 0., 0.}, {-1., 0., 0.}).next_crossing().distance, 1.);
+    EXPECT_TRUE(slab.get_ray({3., 0., 0.}, {1., 0., 0.}).empty());
+  }
+
 };
@@ -0,0 +1,50 @@
+#include <Papillon/materials/log_hash.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  TEST(LogHash, index) {
+    // Grid with clustered points, like resonances
+    RNG rng(1);
+    std::vector<double> grid;
+    for (int i = 0; i < 3000; i++) grid.push_back(1.E-11 * std::pow(2.E12, rng()));
+    for (int i = 0; i < 500; i++) grid.push_back(1.E-5 * (1. + 0.01 * rng()));
+    // Beyond the top of the hash
+    grid.push_back(2.E3);
+    grid.push_back(4.E3);
+    std::sort(grid.begin(), grid.end());
+    grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+
+    {
+      LogHash hash(grid);
+      for (int i = 0; i < 20000; i++) {
+        double E = 1.E-12 * std::pow(1.E16, rng());
+        size_t expected = static_cast<size_t>(
+            std::upper_bound(grid.begin(), grid.end(), E) - grid.begin());
+        expected = std::min(expected > 0 ? expected - 1 : 0, grid.size() - 2);
+        EXPECT_EQ(hash.index(grid, E), expected);
+      }
+
+      // Points of the grid begin their interval
+      for (size_t j = 0; j + 1 < grid.size(); j++) EXPECT_EQ(hash.index(grid, grid[j]), j);
+      EXPECT_EQ(hash.index(grid, grid.back()), grid.size() - 2);
+    }
+  }
+
+  TEST(LogHash, construction) {
+    EXPECT_THROW(LogHash(std::vector<double>{1.}), PMCException);
+    LogHash hash(std::vector<double>{1., 2.});
+    EXPECT_EQ(hash.memory(), (LogHash::NBINS + 1) * sizeof(uint32_t));
+
+    EXPECT_EQ(LogHash::bin(LogHash::E_MIN), 0u);
+    EXPECT_EQ(LogHash::bin(0.5 * LogHash::E_MIN), LogHash::NO_BIN);
+    EXPECT_EQ(LogHash::bin(LogHash::E_MAX), LogHash::NO_BIN);
+    EXPECT_EQ(LogHash::bin(0.999999 * LogHash::E_MAX), LogHash::NBINS - 1);
+  }
+};
@@ -0,0 +1,37 @@
+#include <Papillon/transport/majorant.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+
+namespace {
+  using namespace pmc;
+
+  TEST(Majorant, xs) {
+    auto a = std::make_shared<Nuclide>("a", 1., std::vector<double>{1., 3.},
+                                       std::vector<double>{1., 3.},
+                                       std::vector<double>{0., 0.},
+                                       std::vector<double>{0., 0.}, 0.);
+    auto b = std::make_shared<Nuclide>("b", 1., std::vector<double>{1., 2., 3.},
+                                       std::vector<double>{4., 1., 1.},
+                                       std::vector<double>{0., 0., 0.},
+                                       std::vector<double>{0., 0., 0.}, 0.);
+    Material ma(1);
+    ma.add_nuclide(a, 1.);
+    Material mb(2);
+    mb.add_nuclide(b, 0.5);
+
+    Majorant majorant({&ma, &mb});
+    ASSERT_EQ(majorant.energy().size(), 3u);
+    EXPECT_DOUBLE_EQ(majorant.xs(1.5), 2.);
+    EXPECT_DOUBLE_EQ(majorant.xs(2.5), 3.);
+    EXPECT_DOUBLE_EQ(majorant.xs(0.5), 2.);
+    EXPECT_DOUBLE_EQ(majorant.xs(10.), 3.);
+
+    for (double E = 0.5; E < 4.; E += 0.01) {
+      EXPECT_GE(majorant.xs(E), ma.xs(E).total);
+      EXPECT_GE(majorant.xs(E), mb.xs(E).total);
+    }
+
+    Majorant empty({});
+    EXPECT_EQ(empty.xs(1.), 0.);
+  }
+};
@@ -0,0 +1,117 @@
+#include <Papillon/materials/material.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+
+namespace {
+  using namespace pmc;
+
+  TEST(Material, xs) {
+    auto a = std::make_shared<Nuclide>("a", 1., std::vector<double>{1., 2.},
+                                       std::vector<double>{1., 1.},
+                                       std::vector<double>{1., 3.},
+                                       std::vector<double>{0., 0.}, 0.);
+    auto b = std::make_shared<Nuclide>("b", 200., std::vector<double>{1., 3.},
+                                       std::vector<double>{2., 2.},
+                                       std::vector<double>{0., 0.},
+                                       std::vector<double>{1., 1.}, 2.);
+    Material mat(1, "mix");
+    mat.add_nuclide(a, 0.5);
+    mat.add_nuclide(b, 0.25);
+    EXPECT_EQ(mat.id(), 1u);
+    EXPECT_EQ(mat.size(), 2u);
+    EXPECT_EQ(mat.nuclide(1).name(), "b");
+    EXPECT_DOUBLE_EQ(mat.atom_density(0), 0.5);
+
+    MacroXS xs = mat.xs(1.5);
+    EXPECT_DOUBLE_EQ(xs.elastic, 0.5 * 1. + 0.25 * 2.);
+    EXPECT_DOUBLE_EQ(xs.capture, 0.5 * 2.);
+    EXPECT_DOUBLE_EQ(xs.fission, 0.25 * 1.);
+    EXPECT_DOUBLE_EQ(xs.nu_fission, 0.25 * 2. * 1.);
+    EXPECT_DOUBLE_EQ(xs.total, 2.25);
+
+    EXPECT_THROW(mat.add_nuclide(a, 0.), PMCException);
+    EXPECT_THROW(mat.add_nuclide(nullptr, 1.), PMCException);
+  }
+
+  TEST(Material, sample_nuclide) {
+    auto a = std::make_shared<Nuclide>("a", 1., std::vector<double>{1., 2.},
+                                       std::vector<double>{3., 3.},
+                                       std::vector<double>{0., 0.},
+                                       std::vector<double>{0., 0.}, 0.);
+    Material mat(1);
+    mat.add_nuclide(a, 1.);
+    mat.add_nuclide(a, 3.);
+    // a makes up a quarter of the total cross section
+    EXPECT_EQ(mat.sample_nuclide(1.5, 0.), 0u);
+    EXPECT_EQ(mat.sample_nuclide(1.5, 0.24), 0u);
+    EXPECT_EQ(mat.sample_nuclide(1.5, 0.26), 1u);
+    EXPECT_EQ(mat.sample_nuclide(1.5, 0.999999), 1u);
+  }
+
+  TEST(Material, grid_modes) {
+    // Nuclides on grids of different lengths and spacings
+    RNG rng(2);
+    Material mat(1);
+    for (int n = 0; n < 6; n++) {
+      std::vector<double> energy, el, cap, fis;
+      size_t npoints = 50 + 200 * n;
+      for (size_t i = 0; i < npoints; i++) {
+        energy.push_back(1.E-11 * std::pow(2.E12, (i + 0.5 * rng()) / npoints));
+        el.push_back(1. + 10. * rng());
+        cap.push_back(5. * rng());
+        fis.push_back(n == 0 ? 3. * rng() : 0.);
+      }
+      mat.add_nuclide(std::make_shared<Nuclide>("n", 1. + n, energy, el, cap, fis, 2.5),
+                      0.01 * (n + 1));
+    }
+    EXPECT_EQ(mat.grid_mode(), EnergyGridMode::Nuclide);
+
+    std::vector<double> energies;
+    std::vector<MacroXS> expected;
+    for (int i = 0; i < 5000; i++) {
+      energies.push_back(1.E-12 * std::pow(1.E14, rng()));
+      expected.push_back(mat.xs(energies.back()));
+    }
+    const size_t compact = mat.memory();
+
+    mat.set_grid_mode(EnergyGridMode::Unionized);
+    EXPECT_EQ(mat.grid_mode(), EnergyGridMode::Unionized);
+    EXPECT_GT(mat.memory(), compact);
+    for (size_t i = 0; i < energies.size(); i++) {
+      MacroXS xs = mat.xs(energies[i]);
+      EXPECT_EQ(xs.total, expected[i].total);
+      EXPECT_EQ(xs.elastic, expected[i].elastic);
+      EXPECT_EQ(xs.capture, expected[i].capture);
+      EXPECT_EQ(xs.fission, expected[i].fission);
+      EXPECT_EQ(xs.nu_fission, expected[i].nu_fission);
+    }
+
+    // Adding a nuclide rebuilds the union
+    mat.add_nuclide(std::make_shared<Nuclide>("late", 10., std::vector<double>{1.E-3, 2.E-3},
+                                              std::vector<double>{1., 2.},
+                                              std::vector<double>{0., 0.},
+                                              std::vector<double>{0., 0.}, 0.),
+                    1.);
+    double E = 1.5E-3;
+    MacroXS unionized = mat.xs(E);
+    const size_t fast = mat.memory();
+    mat.set_grid_mode(EnergyGridMode::Nuclide);
+    EXPECT_LT(mat.memory(), fast);
+    EXPECT_EQ(mat.xs(E).total, unionized.total);
+  }
+
+  TEST(Material, memory) {
+    auto a = std::make_shared<Nuclide>("a", 1., std::vector<double>{1., 2.},
+                                       std::vector<double>{3., 3.},
+                                       std::vector<double>{0., 0.},
+                                       std::vector<double>{0., 0.}, 0.);
+    Material m1(1), m2(2);
+    m1.add_nuclide(a, 1.);
+    m2.add_nuclide(a, 2.);
+    // The nuclide is only counted once
+    EXPECT_EQ(Material::memory({&m1, &m2}), m1.memory() + m2.memory() + a->memory());
+  }
+};
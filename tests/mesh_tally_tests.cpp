@@ -0,0 +1,150 @@
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/tallies/material_tally.hpp>
+#include <Papillon/tallies/mesh_tally.hpp>
+#include <Papillon/transport/transport.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <map>
+#include <memory>
+
+namespace {
+  using namespace pmc;
+
+  std::map<size_t, double> walk(const MeshTally& mesh, const Position& r,
+                                const Direction& u, double distance) {
+    std::map<size_t, double> lengths;
+    mesh.walk(r, u, distance, [&](size_t cell, double length) {
+      EXPECT_EQ(lengths.count(cell), 0u);
+      EXPECT_GT(length, 0.);
+      lengths[cell] += length;
+    });
+    return lengths;
+  }
+
+  TEST(MeshTally, walk_axes) {
+    MeshTally mesh("mesh", Position(0., 0., 0.), Position(4., 4., 4.), 4, 4, 4,
+                   {TallyScore::Flux});
+
+    // Along x, through the middle of a row of cells
+    auto lengths = walk(mesh, Position(-1., 0.5, 2.5), Direction(1., 0., 0.), 10.);
+    ASSERT_EQ(lengths.size(), 4u);
+    for (size_t i = 0; i < 4; i++)
+      EXPECT_NEAR(lengths[(2 * 4 + 0) * 4 + i], 1., 1.E-12);
+
+    // Backwards along z, stopping half way through a cell
+    lengths = walk(mesh, Position(3.5, 3.5, 3.), Direction(0., 0., -1.), 1.5);
+    ASSERT_EQ(lengths.size(), 2u);
+    EXPECT_NEAR(lengths[(2 * 4 + 3) * 4 + 3], 1., 1.E-12);
+    EXPECT_NEAR(lengths[(1 * 4 + 3) * 4 + 3], 0.5, 1.E-12);
+
+    // Missing the mesh, and lying along one of its outer faces
+    EXPECT_TRUE(walk(mesh, Position(-1., 5., 2.), Direction(1., 0., 0.), 10.).empty());
+    EXPECT_TRUE(walk(mesh, Position(-1., 1., 2.), Direction(-1., 0., 0.), 10.).empty());
+    EXPECT_TRUE(walk(mesh, Position(-1., 4., 2.), Direction(1., 0., 0.), 10.).empty());
+
+    EXPECT_THROW(MeshTally("bad", Position(0., 0., 0.), Position(1., -1., 1.),
+                           1, 1, 1, {TallyScore::Flux}),
+                 PMCException);
+    EXPECT_THROW(MeshTally("bad", Position(0., 0., 0.), Position(1., 1., 1.),
+                           0, 1, 1, {TallyScore::Flux}),
+                 PMCException);
+    EXPECT_THROW(MeshTally("bad", Position(0., 0., 0.), Position(1., 1., 1.),
+                           1, 1, 1, {}),
+                 PMCException);
+  }
+
+  TEST(MeshTally, walk_oblique) {
+    // Chords of random segments, against the cells of many small steps
+    // along them
+    MeshTally mesh("mesh", Position(-2., -1., 0.), Position(3., 2., 1.5), 10, 7, 3,
+                   {TallyScore::Flux});
+    RNG rng(11);
+    for (int n = 0; n < 200; n++) {
+      Position r(-3. + 7. * rng(), -2. + 5. * rng(), -1. + 3.5 * rng());
+      Direction u(2. * rng() - 1., 2. * PI * rng());
+      double distance = 6. * rng();
+      auto lengths = walk(mesh, r, u, distance);
+
+      const int nsteps = 20000;
+      std::map<size_t, double> sampled;
+      double total = 0.;
+      for (int s = 0; s < nsteps; s++) {
+        Position p = r + ((s + 0.5) * distance / nsteps) * u;
+        int i = static_cast<int>(std::floor((p.x() + 2.) / 0.5));
+        int j = static_cast<int>(std::floor((p.y() + 1.) / (3. / 7.)));
+        int k = static_cast<int>(std::floor(p.z() / 0.5));
+        if (i < 0 || i >= 10 || j < 0 || j >= 7 || k < 0 || k >= 3) continue;
+        sampled[static_cast<size_t>((k * 7 + j) * 10 + i)] += distance / nsteps;
+        total += distance / nsteps;
+      }
+
+      double walked = 0.;
+      for (const auto& cell : lengths) {
+        walked += cell.second;
+        EXPECT_NEAR(cell.second, sampled[cell.first], 2. * distance / nsteps);
+      }
+      EXPECT_NEAR(walked, total, 2. * distance / nsteps);
+    }
+  }
+
+  TEST(MeshTally, transport) {
+    // Pure absorber sphere of radius 2 cm, with neutrons born at its center,
+    // inside of a mesh which covers it
+    const auto V = Surface::BoundaryType::Vacuum;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0., 0., 0., 2., V, 1);
+    auto absorber = std::make_shared<Material>(1);
+    absorber->add_nuclide(std::make_shared<Nuclide>(
+                              "absorber", 1., std::vector<double>{1.E-11, 20.},
+                              std::vector<double>{0., 0.},
+                              std::vector<double>{1., 1.},
+                              std::vector<double>{0., 0.}, 0.),
+                          0.5);
+    auto root = std::make_unique<GeoNode>(
+        std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1),
+        "sphere");
+    root->set_material(absorber);
+    Geometry geom(surfaces, std::move(root));
+
+    auto materials = std::make_shared<MaterialTally>(
+        "materials", geom.materials(),
+        std::vector<TallyScore>{TallyScore::Flux, TallyScore::Absorption});
+    auto mesh = std::make_shared<MeshTally>(
+        "mesh", Position(-2., -2., -2.), Position(2., 2., 2.), 8, 8, 8,
+        std::vector<TallyScore>{TallyScore::Flux, TallyScore::Absorption},
+        TallyAccumulation::Sharded);
+
+    TransportSettings settings;
+    settings.tallies = {materials, mesh};
+    RNG rng(5);
+    std::vector<SourceSite> sites;
+    for (size_t i = 0; i < 5000; i++) {
+      sites.push_back({Position(0., 0., 0.),
+                       Direction(2. * rng() - 1., 2. * PI * rng()), 1., 1.});
+    }
+    transport(geom, sites, settings);
+    materials->end_batch(5000.);
+    mesh->end_batch(5000.);
+
+    double flux = 0.;
+    double absorption = 0.;
+    double lower_half = 0.;
+    for (uint32_t k = 0; k < 8; k++) {
+      for (uint32_t j = 0; j < 8; j++) {
+        for (uint32_t i = 0; i < 8; i++) {
+          flux += mesh->mean(mesh->bin(i, j, k, 0));
+          absorption += mesh->mean(mesh->bin(i, j, k, 1));
+          if (i < 4) lower_half += mesh->mean(mesh->bin(i, j, k, 0));
+        }
+      }
+    }
+    EXPECT_NEAR(flux, materials->mean(0), 1.E-10);
+    EXPECT_NEAR(absorption, materials->mean(1), 1.E-10);
+
+    // Both halves of the mesh see the same flux, statistically
+    EXPECT_NEAR(lower_half, 0.5 * flux, 0.03 * flux);
+  }
+};
@@ -0,0 +1,54 @@
+#include <Papillon/geometry/neighbor_list.hpp>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  TEST(NeighborList, insert) {
+    NeighborList list;
+    EXPECT_EQ(list.size(), 0u);
+    EXPECT_FALSE(list.contains(3));
+
+    list.insert(3);
+    list.insert(5);
+    list.insert(3);
+    EXPECT_EQ(list.size(), 2u);
+    EXPECT_TRUE(list.contains(3));
+    EXPECT_TRUE(list.contains(5));
+
+    // Entries are visited in the order they were added
+    std::vector<uint32_t> seen;
+    EXPECT_FALSE(list.find([&](uint32_t i) { seen.push_back(i); return false; }));
+    EXPECT_EQ(seen, (std::vector<uint32_t>{3, 5}));
+    EXPECT_TRUE(list.find([](uint32_t i) { return i == 5; }));
+  }
+
+  TEST(NeighborList, full) {
+    NeighborList list;
+    for (uint32_t i = 0; i < 2 * NeighborList::CAPACITY; i++) list.insert(i);
+    EXPECT_EQ(list.size(), NeighborList::CAPACITY);
+    EXPECT_TRUE(list.contains(NeighborList::CAPACITY - 1));
+    EXPECT_FALSE(list.contains(NeighborList::CAPACITY));
+  }
+
+  TEST(NeighborList, concurrent_insert) {
+    NeighborList list;
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 8; t++) {
+      threads.emplace_back([&list, t]() {
+        for (int rep = 0; rep < 1000; rep++) {
+          list.insert(t % 4);
+          list.find([](uint32_t i) { return i > 3; });
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // Racing appends of one index may store it twice, but never lose it
+    EXPECT_GE(list.size(), 4u);
+    for (uint32_t i = 0; i < 4; i++) EXPECT_TRUE(list.contains(i));
+    EXPECT_FALSE(list.find([](uint32_t i) { return i > 3; }));
+  }
+};
@@ -0,0 +1,161 @@
+#include <Papillon/materials/nuclear_data_library.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+  using namespace pmc;
+
+  std::string temp_name(const std::string& tag) {
+    return "papillon_ndl_test_" + tag + "_" + std::to_string(getpid()) +
+           ".pmcndl";
+  }
+
+  std::shared_ptr<const Nuclide> make_nuclide(const std::string& name,
+                                              size_t npoints, bool fissile) {
+    std::vector<double> energy, elastic, capture, fission;
+    for (size_t i = 0; i < npoints; i++) {
+      double E = 1.E-11 * std::pow(2.E8, static_cast<double>(i) /
+                                             static_cast<double>(npoints - 1));
+      energy.push_back(E);
+      elastic.push_back(4. + std::sin(static_cast<double>(i)));
+      capture.push_back(0.1 / std::sqrt(E));
+      fission.push_back(fissile ? 0.5 / std::sqrt(E) : 0.);
+    }
+    return std::make_shared<const Nuclide>(name, 235., energy, elastic,
+                                           capture, fission,
+                                           fissile ? 2.43 : 0.);
+  }
+
+  TEST(NuclearDataLibrary, round_trip) {
+    const std::string fname = temp_name("round_trip");
+    auto u235 = make_nuclide("U235", 3001, true);
+    auto h1 = make_nuclide("H1", 17, false);
+    NuclearDataLibrary::write(fname, {u235, h1});
+
+    std::shared_ptr<Nuclide> mapped;
+    {
+      NuclearDataLibrary library(fname, true);
+      EXPECT_EQ(library.size(), 2u);
+      EXPECT_EQ(library.names()[0], "U235");
+      EXPECT_EQ(library.names()[1], "H1");
+      EXPECT_TRUE(library.has_nuclide("H1"));
+      EXPECT_FALSE(library.has_nuclide("O16"));
+      EXPECT_THROW(library.nuclide("O16"), PMCException);
+      EXPECT_TRUE(library.verify());
+
+      // The tables must be viewed in the mapping, aligned
+      mapped = library.nuclide("U235");
+      for (auto table : {mapped->energy(), mapped->total(), mapped->fission()})
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(table.data()) %
+                      NuclearDataLibrary::ALIGNMENT,
+                  0u);
+      EXPECT_FALSE(library.nuclide("H1")->fissile());
+    }
+    std::remove(fname.c_str());
+
+    // The nuclide keeps the file mapped after the library is gone
+    EXPECT_EQ(mapped->name(), "U235");
+    EXPECT_EQ(mapped->awr(), u235->awr());
+    EXPECT_EQ(mapped->nu(), u235->nu());
+    EXPECT_TRUE(mapped->fissile());
+    EXPECT_EQ(mapped->memory() - mapped->name().capacity(),
+              u235->memory() - u235->name().capacity());
+    for (size_t i = 0; i < 10000; i++) {
+      double E = 1.E-12 * std::pow(1.E16, static_cast<double>(i) / 9999.);
+      MicroXS a = u235->xs(E);
+      MicroXS b = mapped->xs(E);
+      EXPECT_EQ(a.total, b.total);
+      EXPECT_EQ(a.elastic, b.elastic);
+      EXPECT_EQ(a.capture, b.capture);
+      EXPECT_EQ(a.fission, b.fission);
+    }
+  }
+
+  TEST(NuclearDataLibrary, corruption) {
+    const std::string fname = temp_name("corruption");
+    NuclearDataLibrary::write(fname, {make_nuclide("Fe56", 100, false)});
+
+    {
+      std::fstream file(fname, std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(1000);
+      file.put('\x7f');
+    }
+    EXPECT_NO_THROW(NuclearDataLibrary library(fname));
+    EXPECT_FALSE(NuclearDataLibrary(fname).verify());
+    EXPECT_THROW(NuclearDataLibrary(fname, true), PMCException);
+
+    {
+      std::fstream file(fname, std::ios::in | std::ios::out | std::ios::binary);
+      file.seekp(0);
+      file.put('X');
+    }
+    EXPECT_THROW(NuclearDataLibrary{fname}, PMCException);
+
+    {
+      std::ofstream file(fname, std::ios::binary | std::ios::trunc);
+      file << "PMCNDL";
+    }
+    EXPECT_THROW(NuclearDataLibrary{fname}, PMCException);
+    std::remove(fname.c_str());
+
+    EXPECT_THROW(NuclearDataLibrary{fname}, PMCException);
+  }
+
+  // Writes value at offset in the file fname
+  template <class T>
+  void overwrite(const std::string& fname, std::streamoff offset, T value) {
+    std::fstream file(fname, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(offset);
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  TEST(NuclearDataLibrary, corrupted_tables) {
+    // 100 points: the index ends at 128, each table takes 832 bytes, and the
+    // hash follows the five tables
+    const std::string fname = temp_name("corrupted_tables");
+    const std::streamoff energy = 128, hash = 128 + 5 * 832;
+
+    // The header is covered by the checksum
+    NuclearDataLibrary::write(fname, {make_nuclide("Fe56", 100, false)});
+    overwrite<double>(fname, 48, 2.E-11);
+    EXPECT_FALSE(NuclearDataLibrary(fname).verify());
+    EXPECT_NO_THROW(NuclearDataLibrary(fname).nuclide("Fe56"));
+
+    // A hash pointing past the grid, or going backwards
+    NuclearDataLibrary::write(fname, {make_nuclide("Fe56", 100, false)});
+    overwrite<uint32_t>(fname, hash + 4 * 4000, 0xffffffff);
+    EXPECT_THROW(NuclearDataLibrary(fname).nuclide("Fe56"), PMCException);
+    NuclearDataLibrary::write(fname, {make_nuclide("Fe56", 100, false)});
+    overwrite<uint32_t>(fname, hash + 4 * 8000, 0);
+    EXPECT_THROW(NuclearDataLibrary(fname).nuclide("Fe56"), PMCException);
+
+    // An unsorted grid
+    NuclearDataLibrary::write(fname, {make_nuclide("Fe56", 100, false)});
+    overwrite<double>(fname, energy + 8 * 50, 1.);
+    EXPECT_THROW(NuclearDataLibrary(fname).nuclide("Fe56"), PMCException);
+    std::remove(fname.c_str());
+  }
+
+  TEST(NuclearDataLibrary, write_errors) {
+    const std::string fname = temp_name("write_errors");
+    auto nuc = make_nuclide("Fe56", 10, false);
+    EXPECT_THROW(NuclearDataLibrary::write(fname, {nuc, nuc}), PMCException);
+    EXPECT_THROW(NuclearDataLibrary::write(
+                     fname, {make_nuclide(std::string(32, 'a'), 10, false)}),
+                 PMCException);
+    std::remove(fname.c_str());
+  }
+
+  TEST(NuclearDataLibrary, checksum) {
+    // FNV-1a test vectors
+    const unsigned char a[] = {'a'};
+    const unsigned char foobar[] = {'f', 'o', 'o', 'b', 'a', 'r'};
+    EXPECT_EQ(NuclearDataLibrary::checksum(a, 0), 0xcbf29ce484222325u);
+    EXPECT_EQ(NuclearDataLibrary::checksum(a, 1), 0xaf63dc4c8601ec8cu);
+    EXPECT_EQ(NuclearDataLibrary::checksum(foobar, 6), 0x85944171f73967e8u);
+  }
+};
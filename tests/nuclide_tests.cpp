@@ -0,0 +1,55 @@
+#include <Papillon/materials/nuclide.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+  using namespace pmc;
+
+  Nuclide make_nuclide() {
+    return Nuclide("test", 10., {1., 2., 4.}, {1., 2., 3.}, {4., 2., 0.},
+                   {0., 1., 1.}, 2.5);
+  }
+
+  TEST(Nuclide, construction) {
+    Nuclide nuc = make_nuclide();
+    EXPECT_EQ(nuc.name(), "test");
+    EXPECT_DOUBLE_EQ(nuc.awr(), 10.);
+    EXPECT_DOUBLE_EQ(nuc.nu(), 2.5);
+    EXPECT_TRUE(nuc.fissile());
+    EXPECT_DOUBLE_EQ(nuc.total()[0], 5.);
+    EXPECT_DOUBLE_EQ(nuc.total()[1], 5.);
+    EXPECT_DOUBLE_EQ(nuc.total()[2], 4.);
+
+    EXPECT_THROW(Nuclide("a", 0., {1., 2.}, {1., 1.}, {0., 0.}, {0., 0.}, 0.),
+                 PMCException);
+    EXPECT_THROW(Nuclide("a", 1., {1.}, {1.}, {0.}, {0.}, 0.), PMCException);
+    EXPECT_THROW(Nuclide("a", 1., {2., 1.}, {1., 1.}, {0., 0.}, {0., 0.}, 0.),
+                 PMCException);
+    EXPECT_THROW(Nuclide("a", 1., {1., 2.}, {1.}, {0., 0.}, {0., 0.}, 0.),
+                 PMCException);
+    EXPECT_THROW(Nuclide("a", 1., {1., 2.}, {1., -1.}, {0., 0.}, {0., 0.}, 0.),
+                 PMCException);
+  }
+
+  TEST(Nuclide, grid_index) {
+    Nuclide nuc = make_nuclide();
+    EXPECT_EQ(nuc.grid_index(0.5), 0u);
+    EXPECT_EQ(nuc.grid_index(1.5), 0u);
+    EXPECT_EQ(nuc.grid_index(2.), 1u);
+    EXPECT_EQ(nuc.grid_index(3.), 1u);
+    EXPECT_EQ(nuc.grid_index(10.), 1u);
+  }
+
+  TEST(Nuclide, xs) {
+    Nuclide nuc = make_nuclide();
+    MicroXS xs = nuc.xs(3.);
+    EXPECT_DOUBLE_EQ(xs.elastic, 2.5);
+    EXPECT_DOUBLE_EQ(xs.capture, 1.);
+    EXPECT_DOUBLE_EQ(xs.fission, 1.);
+    EXPECT_DOUBLE_EQ(xs.total, 4.5);
+
+    // Clamped to the ends of the grid
+    EXPECT_DOUBLE_EQ(nuc.xs(0.1).total, 5.);
+    EXPECT_DOUBLE_EQ(nuc.xs(100.).total, 4.);
+  }
+};
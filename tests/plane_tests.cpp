@@ -1,6 +1,7 @@
 #include <Papillon/geometry/surfaces/plane.hpp>
 #include <Papillon/utils/constants.hpp>
 #include <gtest/gtest.h>
+#include "surface_batch_check.hpp"
 #include <cmath>
 
 namespace {
@@ -52,4 +53,11 @@ namespace {
     EXPECT_DOUBLE_EQ(exp.z(), pn.z());
   }
 
+  TEST(Plane, distance_batch) {
+    // Rays parallel to the plane, and nearly so, and rays starting on it.
+    check_distance_batch(p, {{2.,2.,2.}, {-1.,0.,0.}},
+                         {{1.,-1.,0.}, {1.,1.,-2.}, {1.,-1.,1e-12}},
+                         {{1.,1.,1.}, {3.,0.,0.}, {-1.,2.,2.}});
+  }
+
 };
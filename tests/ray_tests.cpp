@@ -0,0 +1,81 @@
+#include <Papillon/geometry/csg/ray.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+  using namespace pmc;
+
+  const auto P = Surface::Side::Positive;
+
+  // Ray made of the intervals [b[0], b[1]], [b[2], b[3]], ..., where the
+  // crossing at each bound is of the surface with index equal to its position
+  Ray make_ray(std::initializer_list<double> bounds) {
+    Ray ray;
+    std::vector<double> b(bounds);
+    for (size_t i = 0; i + 1 < b.size(); i += 2) {
+      ray.push_back({{b[i], static_cast<uint32_t>(i + 1), P},
+                     {b[i + 1], static_cast<uint32_t>(i + 2), P}});
+    }
+    return ray;
+  }
+
+  void expect_intervals(const Ray& ray, std::initializer_list<double> bounds) {
+    std::vector<double> b(bounds);
+    ASSERT_EQ(ray.size(), b.size() / 2);
+    for (size_t i = 0; i < ray.size(); i++) {
+      EXPECT_DOUBLE_EQ(ray[i].enter.distance, b[2 * i]);
+      EXPECT_DOUBLE_EQ(ray[i].exit.distance, b[2 * i + 1]);
+    }
+  }
+
+  TEST(Ray, unite) {
+    Ray a = make_ray({0., 1., 3., 4., 6., 7.});
+    Ray b = make_ray({0.5, 2., 4., 5., 8., INF});
+    expect_intervals(Ray::unite(a, b), {0., 2., 3., 5., 6., 7., 8., INF});
+    expect_intervals(Ray::unite(a, Ray()), {0., 1., 3., 4., 6., 7.});
+  }
+
+  TEST(Ray, intersect) {
+    Ray a = make_ray({0., 1., 3., 4., 6., 7.});
+    Ray b = make_ray({0.5, 3.5, 6.5, INF});
+    Ray c = Ray::intersect(a, b);
+    expect_intervals(c, {0.5, 1., 3., 3.5, 6.5, 7.});
+    // Each bound keeps the crossing it came from
+    EXPECT_EQ(c[0].enter.surface, 1u);
+    EXPECT_EQ(c[0].exit.surface, 2u);
+    EXPECT_EQ(c[1].exit.surface, 2u);
+    EXPECT_TRUE(Ray::intersect(a, Ray()).empty());
+  }
+
+  TEST(Ray, subtract) {
+    Ray a = make_ray({0., 10.});
+    Ray b = make_ray({2., 3., 5., INF});
+    expect_intervals(Ray::complement(b), {0., 2., 3., 5.});
+    expect_intervals(Ray::subtract(a, b), {0., 2., 3., 5.});
+    expect_intervals(Ray::subtract(b, a), {10., INF});
+    expect_intervals(Ray::complement(Ray()), {0., INF});
+  }
+
+  TEST(Ray, next_crossing) {
+    EXPECT_DOUBLE_EQ(make_ray({0., 2.}).next_crossing().distance, 2.);
+    EXPECT_DOUBLE_EQ(make_ray({1., 2.}).next_crossing().distance, 1.);
+    EXPECT_GE(Ray().next_crossing().distance, INF);
+  }
+
+  TEST(Ray, capacity) {
+    // Intervals past the capacity are dropped, and the first dropped entry
+    // becomes the limit of the Ray
+    Ray full;
+    for (size_t i = 0; i <= Ray::CAPACITY; i++)
+      full.push_back({{2. * i, 1, P}, {2. * i + 1., 1, P}});
+    EXPECT_EQ(full.size(), Ray::CAPACITY);
+    EXPECT_DOUBLE_EQ(full.limit().distance, 2. * Ray::CAPACITY);
+
+    // Results are cut short at the limit, so a boundary is never found late
+    Ray all = make_ray({0., INF});
+    Ray u = Ray::unite(full, all);
+    expect_intervals(u, {0., 2. * Ray::CAPACITY});
+    Ray d = Ray::subtract(all, full);
+    EXPECT_EQ(d.size(), Ray::CAPACITY);
+    EXPECT_DOUBLE_EQ(d[Ray::CAPACITY - 1].exit.distance, 2. * Ray::CAPACITY);
+  }
+};
@@ -0,0 +1,204 @@
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/geo_navigator.hpp>
+#include <Papillon/geometry/rect_lattice.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <Papillon/materials/material.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  const double pitch = 1.26;
+
+  // 3x3 lattice of pins, infinite along z, inside of a sphere of radius 10
+  std::unique_ptr<Geometry> make_geometry() {
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<ZCylinder>(0.,0.,0.4,Surface::BoundaryType::Transparent,1);
+    surfaces[2] = std::make_shared<Sphere>(0.,0.,0.,100.,Surface::BoundaryType::Transparent,2);
+    surfaces[3] = std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,3);
+
+    auto fuel = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+    auto cell = std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2);
+    auto world = std::make_shared<HalfSpace>(surfaces[3], Surface::Side::Negative, 3);
+
+    auto pin = std::make_shared<GeoNode>(cell, "moderator");
+    pin->add_node(fuel, Transformation(), "fuel");
+
+    auto core = std::make_unique<RectLattice>(world, 3, 3, 1, pitch, pitch, INF,
+                                              Position(-1.5*pitch, -1.5*pitch, 0.), "core");
+    core->fill(pin);
+    EXPECT_EQ(core->nuniverses(), 1u);
+
+    return std::make_unique<Geometry>(surfaces, std::move(core));
+  }
+
+  TEST(RectLattice, element_index) {
+    auto world = std::make_shared<HalfSpace>(
+        std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,1),
+        Surface::Side::Negative, 1);
+    RectLattice lat(world, 4, 3, 2, 1., 2., 3., Position(0., 0., 0.), "lat");
+
+    uint32_t e = 0;
+    EXPECT_TRUE(lat.element_index({3.5, 5.5, 4.}, {1.,0.,0.}, e));
+    EXPECT_EQ(e, 3u + 4u*(2u + 3u*1u));
+    EXPECT_FALSE(lat.element_index({-0.5, 1., 1.}, {1.,0.,0.}, e));
+    EXPECT_FALSE(lat.element_index({1., 6.5, 1.}, {1.,0.,0.}, e));
+
+    // Points on a wall go to the element they are heading into
+    EXPECT_TRUE(lat.element_index({1., 1., 1.}, {1.,0.,0.}, e));
+    EXPECT_EQ(e, 1u);
+    EXPECT_TRUE(lat.element_index({1., 1., 1.}, {-1.,0.,0.}, e));
+    EXPECT_EQ(e, 0u);
+    EXPECT_FALSE(lat.element_index({0., 1., 1.}, {-1.,0.,0.}, e));
+
+    EXPECT_DOUBLE_EQ(lat.distance_to_element_boundary({0.25, 1., 1.}, {1.,0.,0.}, 0), 0.75);
+    EXPECT_DOUBLE_EQ(lat.distance_to_element_boundary({0.25, 1., 1.}, {0.,-1.,0.}, 0), 1.);
+
+    EXPECT_THROW(lat.set_element(4, 0, 0, nullptr), PMCException);
+    EXPECT_THROW(RectLattice(world, 2, 2, 2, 1., 1., INF, Position(), "bad"), PMCException);
+  }
+
+  TEST(RectLattice, find_location) {
+    auto geom = make_geometry();
+
+    GeoNavigator nav(geom.get(), {0.,0.,3.}, {1.,0.,0.});
+    EXPECT_EQ(nav.current_node()->name(), "fuel");
+    EXPECT_EQ(nav.depth(), 3u);
+
+    nav.find_location_from_root({pitch, 0.5, -2.}, {1.,0.,0.});
+    EXPECT_EQ(nav.current_node()->name(), "moderator");
+    EXPECT_NEAR(nav.r_local().x(), 0., 1.E-12);
+    EXPECT_NEAR(nav.r_local().y(), 0.5, 1.E-12);
+
+    nav.find_location_from_root({-pitch, -pitch+0.1, 0.}, {1.,0.,0.});
+    EXPECT_EQ(nav.current_node()->name(), "fuel");
+    EXPECT_NEAR(nav.r_local().y(), 0.1, 1.E-12);
+
+    // Outside of the grid, but inside of the lattice's volume
+    nav.find_location_from_root({5., 0., 0.}, {1.,0.,0.});
+    EXPECT_FALSE(nav.is_lost());
+    EXPECT_EQ(nav.current_node()->name(), "core");
+  }
+
+  TEST(RectLattice, stream_across) {
+    auto geom = make_geometry();
+
+    GeoNavigator nav(geom.get(), {-8., 0.1, 0.}, {1.,0.,0.});
+    EXPECT_EQ(nav.current_node()->name(), "core");
+
+    std::vector<std::string> names;
+    std::vector<double> dists;
+    double travelled = 0.;
+    while (!nav.is_lost()) {
+      GeoNavigator::Boundary b = nav.find_next_boundary();
+      travelled += b.distance;
+      dists.push_back(b.distance);
+      if (b.surface && b.surface->boundary() == Surface::BoundaryType::Vacuum) break;
+      nav.cross_next_boundary();
+      nav.find_location_from_current();
+      names.push_back(nav.current_node()->name());
+    }
+
+    std::vector<std::string> expected{"moderator", "fuel", "moderator",
+                                      "moderator", "fuel", "moderator",
+                                      "moderator", "fuel", "moderator", "core"};
+    EXPECT_EQ(names, expected);
+
+    // Half chord of the fuel at y = 0.1
+    double h = std::sqrt(0.4*0.4 - 0.1*0.1);
+    ASSERT_EQ(dists.size(), 11u);
+    EXPECT_NEAR(dists[0], 8. - 1.5*pitch, 1.E-9);
+    EXPECT_NEAR(dists[1], 0.5*pitch - h, 1.E-9);
+    EXPECT_NEAR(dists[2], 2.*h, 1.E-9);
+    EXPECT_NEAR(dists[3], 0.5*pitch - h, 1.E-9);
+    EXPECT_NEAR(travelled, 8. + std::sqrt(100. - 0.01), 1.E-9);
+  }
+
+  TEST(RectLattice, clone_parent) {
+    // A lattice inside of a node, with a different material in its first
+    // element, which must still be found through a clone of the node
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0.,0.,0.,100.,Surface::BoundaryType::Transparent,1);
+    surfaces[2] = std::make_shared<Sphere>(0.,0.,0.,5.,Surface::BoundaryType::Transparent,2);
+    surfaces[3] = std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,3);
+    auto cell = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+    auto inner = std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2);
+    auto world = std::make_shared<HalfSpace>(surfaces[3], Surface::Side::Negative, 3);
+
+    auto a = std::make_shared<GeoNode>(cell, "a");
+    a->set_material(std::make_shared<Material>(1, "mat_a"));
+    auto b = std::make_shared<GeoNode>(cell, "b");
+    b->set_material(std::make_shared<Material>(2, "mat_b"));
+
+    auto lattice = std::make_unique<RectLattice>(inner, 2, 2, 1, 1., 1., INF,
+                                                 Position(-1., -1., 0.), "lattice");
+    lattice->fill(b);
+    lattice->set_element(0, 0, 0, a);
+
+    GeoNode root(world, "root");
+    root.add_node(std::move(lattice));
+    Geometry geom(surfaces, root.clone());
+
+    GeoNavigator nav(&geom, {-0.5, -0.5, 0.}, {1.,0.,0.});
+    ASSERT_FALSE(nav.is_lost());
+    ASSERT_NE(nav.current_node()->material(), nullptr);
+    EXPECT_EQ(nav.current_node()->material()->name(), "mat_a");
+    nav.find_location_from_root({0.5, 0.5, 0.}, {1.,0.,0.});
+    ASSERT_NE(nav.current_node()->material(), nullptr);
+    EXPECT_EQ(nav.current_node()->material()->name(), "mat_b");
+
+    // A lattice cloned on its own keeps its elements
+    auto copy = geom.root()->find_child_node({0.5, 0.5, 0.}, {1.,0.,0.}, 0,
+                                             Surface::Side::Positive)->clone();
+    auto* lat = dynamic_cast<RectLattice*>(copy.get());
+    ASSERT_NE(lat, nullptr);
+    EXPECT_EQ(lat->element(0, 0, 0)->name(), "a");
+    EXPECT_EQ(lat->element(1, 1, 0)->name(), "b");
+    EXPECT_EQ(lat->pitch()[0], 1.);
+  }
+
+  TEST(RectLattice, bounded_universe) {
+    // 3x1 lattice with a sphere of radius 0.5 in its middle element, and
+    // nothing in the other two. The sphere does not fill its element, and
+    // must be entered and left on the way across.
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0.,0.,0.,0.5,Surface::BoundaryType::Transparent,1);
+    surfaces[2] = std::make_shared<Sphere>(0.,0.,0.,10.,Surface::BoundaryType::Vacuum,2);
+    auto ball = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+    auto world = std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2);
+
+    auto lattice = std::make_unique<RectLattice>(world, 3, 1, 1, 2., 2., 2.,
+                                                 Position(-3., -1., -1.), "lattice");
+    lattice->set_element(1, 0, 0, std::make_shared<GeoNode>(ball, "ball"));
+    Geometry geom(surfaces, std::move(lattice));
+
+    GeoNavigator nav(&geom, {-2.5, 0., 0.}, {1.,0.,0.});
+    ASSERT_EQ(nav.current_node()->name(), "lattice");
+
+    std::vector<std::string> names;
+    std::vector<double> positions;
+    double x = -2.5;
+    while (!nav.is_lost()) {
+      GeoNavigator::Boundary b = nav.find_next_boundary();
+      if (b.distance == INF || (b.surface && b.surface->boundary() == Surface::BoundaryType::Vacuum)) break;
+      x += b.distance;
+      positions.push_back(x);
+      nav.cross_next_boundary();
+      nav.find_location_from_current();
+      names.push_back(nav.current_node()->name());
+    }
+
+    std::vector<std::string> expected{"lattice", "ball", "lattice", "lattice", "lattice"};
+    EXPECT_EQ(names, expected);
+    ASSERT_EQ(positions.size(), 5u);
+    EXPECT_NEAR(positions[0], -1., 1.E-9);
+    EXPECT_NEAR(positions[1], -0.5, 1.E-9);
+    EXPECT_NEAR(positions[2], 0.5, 1.E-9);
+    EXPECT_NEAR(positions[3], 1., 1.E-9);
+    EXPECT_NEAR(positions[4], 3., 1.E-9);
+  }
+};
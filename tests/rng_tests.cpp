@@ -0,0 +1,106 @@
+#include <Papillon/utils/rng.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  TEST(RNG, philox) {
+    // Known answers from the Random123 distribution
+    RNG::Block zero = RNG::philox({0, 0, 0, 0}, {0, 0});
+    EXPECT_EQ(zero[0], 0x16554d9eca36314cULL);
+    EXPECT_EQ(zero[1], 0xdb20fe9d672d0fdcULL);
+    EXPECT_EQ(zero[2], 0xd7e772cee186176bULL);
+    EXPECT_EQ(zero[3], 0x7e68b68aec7ba23bULL);
+
+    const uint64_t ones = ~0ULL;
+    RNG::Block full = RNG::philox({ones, ones, ones, ones}, {ones, ones});
+    EXPECT_EQ(full[0], 0x87b092c3013fe90bULL);
+    EXPECT_EQ(full[1], 0x438c3c67be8d0224ULL);
+    EXPECT_EQ(full[2], 0x9cc7d7c69cd777b6ULL);
+    EXPECT_EQ(full[3], 0xa09caebf594f0ba0ULL);
+  }
+
+  TEST(RNG, range) {
+    RNG rng(12345);
+    for (int i = 0; i < 100000; i++) {
+      double xi = rng();
+      EXPECT_GE(xi, 0.);
+      EXPECT_LT(xi, 1.);
+    }
+  }
+
+  TEST(RNG, streams) {
+    // Each of (seed, batch, history, event) selects another stream
+    RNG a(7, 1, 3);
+    a.set_event(2);
+    double xi = a();
+    RNG b(7, 1, 3);
+    b.next_event();
+    b.next_event();
+    EXPECT_EQ(b.event(), 2u);
+    EXPECT_EQ(b(), xi);
+
+    RNG c(8, 1, 3);
+    c.set_event(2);
+    EXPECT_NE(c(), xi);
+    RNG d(7, 2, 3);
+    d.set_event(2);
+    EXPECT_NE(d(), xi);
+    RNG e(7, 1, 4);
+    e.set_event(2);
+    EXPECT_NE(e(), xi);
+    RNG f(7, 1, 3);
+    f.set_event(3);
+    EXPECT_NE(f(), xi);
+
+    // An event's stream does not depend on what the one before drew
+    RNG g(7, 1, 3);
+    g.set_event(1);
+    for (int i = 0; i < 11; i++) g();
+    g.next_event();
+    EXPECT_EQ(g(), xi);
+  }
+
+  TEST(RNG, advance) {
+    for (uint64_t n : {0, 1, 3, 4, 5, 1000, 1001}) {
+      RNG a(7);
+      RNG b(7);
+      a();
+      b();
+      for (uint64_t i = 0; i < n; i++) a();
+      b.advance(n);
+      EXPECT_EQ(a(), b());
+      EXPECT_EQ(a(), b());
+    }
+  }
+
+  TEST(RNG, fill) {
+    for (size_t n : {0, 3, 4, 70, 257}) {
+      RNG a(11, 2, 5);
+      RNG b(11, 2, 5);
+      a();
+      b();
+      std::vector<double> block(n);
+      a.fill(block.data(), n);
+      for (size_t i = 0; i < n; i++) EXPECT_EQ(block[i], b());
+      EXPECT_EQ(a(), b());
+    }
+  }
+
+  TEST(RNG, batched_next_event) {
+    std::vector<RNG> rngs, expected;
+    for (uint64_t h = 0; h < 40; h++) {
+      rngs.emplace_back(3, 0, h);
+      expected.emplace_back(3, 0, h);
+    }
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < 40; i += 2) indices.push_back(i);
+    RNG::next_event(rngs.data(), indices.data(), indices.size());
+    for (uint32_t i : indices) expected[i].next_event();
+    for (size_t i = 0; i < 40; i++) {
+      EXPECT_EQ(rngs[i].event(), expected[i].event());
+      for (int j = 0; j < 6; j++) EXPECT_EQ(rngs[i](), expected[i]());
+    }
+  }
+};
@@ -1,5 +1,6 @@
 #include <Papillon/geometry/surfaces/sphere.hpp>
 #include <gtest/gtest.h>
+#include "surface_batch_check.hpp"
 
 namespace {
   using namespace pmc;
@@ -52,4 +53,12 @@ namespace {
     EXPECT_DOUBLE_EQ(-1.0, s.normal(r5).z());
   }
 
+  TEST(Sphere, distance_batch) {
+    // Rays from the centre, rays grazing the sphere from the points
+    // {x0-3,y0+R,z0} and {x0,y0-R,z0+5}, and rays starting on the sphere.
+    check_distance_batch(s, {{x0,y0,z0}, {x0-3.,y0+R,z0}, {x0,y0-R,z0+5.}},
+                         {{1.,1e-12,0.}, {0.,1e-12,-1.}},
+                         {{x0+R,y0,z0}, {x0,y0,z0-R}, {x0,y0-R,z0}});
+  }
+
 };
@@ -0,0 +1,67 @@
+#ifndef PAPILLON_SURFACE_BATCH_CHECK_H
+#define PAPILLON_SURFACE_BATCH_CHECK_H
+
+#include <Papillon/geometry/surfaces/surface.hpp>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  // Checks that Surface::distance_batch agrees with Surface::distance for
+  // a batch built from every pairing of the positions rs and the
+  // directions us, to which a few generic points and directions common to
+  // all surfaces are added. The batch is checked once without on_surf,
+  // and once with every third particle flagged as being on the surface.
+  // Particles starting at the positions on_rs, which must lie on the
+  // surface, are always flagged as being on it.
+  void check_distance_batch(const Surface& s, std::vector<Position> rs,
+                            std::vector<Direction> us,
+                            const std::vector<Position>& on_rs = {}) {
+    rs.insert(rs.end(), {{0.,0.,0.}, {2.5,3.5,-1.}, {6.,7.,8.}});
+    us.insert(us.end(), {{1.,0.,0.}, {0.,1.,0.}, {0.,0.,1.}, {-1.,0.,0.},
+                         {0.,-1.,0.}, {0.,0.,-1.}, {1.,1.,1.}, {-1.,-2.,0.5}});
+
+    // The Direction objects are kept, as building them again from their
+    // components would renormalize them.
+    std::vector<Position> r_batch;
+    std::vector<Direction> u_batch;
+    std::vector<uint32_t> on_surf;
+    for(const auto& r : rs) {
+      for(const auto& u : us) {
+        r_batch.push_back(r);
+        u_batch.push_back(u);
+        on_surf.push_back(on_surf.size() % 3 == 0 ? s.id() : 0);
+      }
+    }
+    for(const auto& r : on_rs) {
+      for(const auto& u : us) {
+        r_batch.push_back(r);
+        u_batch.push_back(u);
+        on_surf.push_back(s.id());
+      }
+    }
+
+    size_t n = r_batch.size();
+    std::vector<double> x, y, z, u, v, w;
+    for(size_t i = 0; i < n; i++) {
+      x.push_back(r_batch[i].x()); y.push_back(r_batch[i].y()); z.push_back(r_batch[i].z());
+      u.push_back(u_batch[i].x()); v.push_back(u_batch[i].y()); w.push_back(u_batch[i].z());
+    }
+    std::vector<double> d(n);
+
+    s.distance_batch(x.data(), y.data(), z.data(), u.data(), v.data(), w.data(), d.data(), n);
+    for(size_t i = 0; i < n; i++) {
+      EXPECT_DOUBLE_EQ(s.distance(r_batch[i], u_batch[i]), d[i]) << "particle " << i;
+    }
+
+    s.distance_batch(x.data(), y.data(), z.data(), u.data(), v.data(), w.data(), d.data(), n, on_surf.data());
+    for(size_t i = 0; i < n; i++) {
+      EXPECT_DOUBLE_EQ(s.distance(r_batch[i], u_batch[i], on_surf[i]), d[i]) << "particle " << i;
+    }
+  }
+
+};
+
+#endif
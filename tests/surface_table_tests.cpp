@@ -0,0 +1,79 @@
+#include <Papillon/geometry/surfaces/surface_table.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zplane.hpp>
+#include <Papillon/geometry/surfaces/plane.hpp>
+#include <Papillon/geometry/surfaces/xcylinder.hpp>
+#include <Papillon/geometry/surfaces/ycylinder.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  using namespace pmc;
+
+  std::unordered_map<uint32_t, std::shared_ptr<Surface>> make_surfaces() {
+    const auto T = Surface::BoundaryType::Transparent;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfs;
+    surfs[10] = std::make_shared<XPlane>(1., T, 10);
+    surfs[2] = std::make_shared<YPlane>(-1., Surface::BoundaryType::Vacuum, 2);
+    surfs[33] = std::make_shared<ZPlane>(0.5, T, 33);
+    surfs[4] = std::make_shared<Plane>(1., 2., -1., 0.5, T, 4);
+    surfs[5] = std::make_shared<XCylinder>(0.5, -0.5, 2., T, 5);
+    surfs[6] = std::make_shared<YCylinder>(0.5, 1.5, 1., Surface::BoundaryType::Reflective, 6);
+    surfs[7] = std::make_shared<ZCylinder>(-1., 0.5, 1.5, T, 7);
+    surfs[8] = std::make_shared<Sphere>(0.5, 0.5, -0.5, 2.5, T, 8);
+    return surfs;
+  }
+
+  TEST(SurfaceTable, indices) {
+    auto surfs = make_surfaces();
+    SurfaceTable table(surfs);
+
+    EXPECT_EQ(table.size(), surfs.size());
+
+    // Indices are assigned in order of increasing id, starting at 1
+    EXPECT_EQ(table.index(2), 1u);
+    EXPECT_EQ(table.index(33), 8u);
+    EXPECT_THROW(table.index(3), PMCException);
+
+    for(const auto& surf : surfs) {
+      uint32_t indx = table.index(surf.first);
+      EXPECT_EQ(indx, table.index(surf.first));
+      EXPECT_EQ(table[indx].id, surf.first);
+      EXPECT_EQ(table[indx].boundary, surf.second->boundary());
+      EXPECT_EQ(table.surface(indx), surf.second);
+    }
+  }
+
+  TEST(SurfaceTable, evaluation) {
+    auto surfs = make_surfaces();
+    SurfaceTable table(surfs);
+
+    std::vector<Position> rs{{0.,0.,0.}, {1.,-1.,0.5}, {2.5,3.5,-1.}, {-1.,2.,0.5}, {3.,0.25,-0.75}};
+    std::vector<Direction> us{{1.,0.,0.}, {0.,-1.,0.}, {0.,0.,1.}, {1.,1.,1.}, {-1.,-2.,0.5}};
+
+    for(const auto& surf : surfs) {
+      uint32_t indx = table.index(surf.first);
+      for(const auto& r : rs) {
+        Direction n = surf.second->normal(r);
+        Direction tn = table.normal(indx, r);
+        EXPECT_DOUBLE_EQ(n.x(), tn.x());
+        EXPECT_DOUBLE_EQ(n.y(), tn.y());
+        EXPECT_DOUBLE_EQ(n.z(), tn.z());
+
+        for(const auto& u : us) {
+          EXPECT_EQ(surf.second->sign(r, u), table.sign(indx, r, u));
+          double d = surf.second->distance(r, u);
+          EXPECT_NEAR(d, table.distance(indx, r, u), 1.E-12*std::max(1., d));
+          EXPECT_DOUBLE_EQ(INF, table.distance(indx, r, u, surf.first));
+        }
+      }
+    }
+  }
+
+};
@@ -0,0 +1,149 @@
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/tallies/material_tally.hpp>
+#include <Papillon/transport/transport.hpp>
+#include <Papillon/utils/pmc_exception.hpp>
+#include <Papillon/utils/rng.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+  using namespace pmc;
+
+  // Tally whose bins are only scored by hand
+  class BinTally : public Tally {
+    public:
+      using Tally::Tally;
+      void score_flight(int, const Position&, const Direction&, double,
+                        const Material*, double, double) override {}
+  };
+
+  TEST(Tally, statistics) {
+    BinTally tally("bins", 3);
+    EXPECT_EQ(tally.size(), 3u);
+    const double values[5] = {1., 4., 2., 8., 5.};
+    for (double v : values) {
+      tally.score(0, 1, 2. * v);
+      tally.score(0, 2, 3.);
+      tally.end_batch(2.);
+    }
+
+    double mean = 0.;
+    for (double v : values) mean += v / 5.;
+    double variance = 0.;
+    for (double v : values) variance += (v - mean) * (v - mean) / 4.;
+
+    EXPECT_EQ(tally.batches(), 5u);
+    EXPECT_NEAR(tally.mean(1), mean, 1.E-14);
+    EXPECT_NEAR(tally.variance(1), variance, 1.E-13);
+    EXPECT_NEAR(tally.std_error(1), std::sqrt(variance / 5.), 1.E-14);
+    EXPECT_NEAR(tally.relative_error(1), std::sqrt(variance / 5.) / mean,
+                1.E-14);
+    double r = tally.relative_error(1);
+    EXPECT_NEAR(tally.figure_of_merit(1, 2.), 1. / (r * r * 2.), 1.E-10);
+
+    EXPECT_EQ(tally.mean(0), 0.);
+    EXPECT_EQ(tally.relative_error(0), 0.);
+    EXPECT_EQ(tally.mean(2), 1.5);
+    EXPECT_EQ(tally.variance(2), 0.);
+
+    EXPECT_THROW(tally.end_batch(0.), PMCException);
+    EXPECT_THROW(BinTally("empty", 0), PMCException);
+  }
+
+  TEST(Tally, accumulation) {
+    const size_t nbins = 100;
+    BinTally priv("private", nbins);
+    BinTally sharded("sharded", nbins, TallyAccumulation::Sharded, 2);
+    const int nthreads = 4;
+    priv.prepare(nthreads);
+    sharded.prepare(nthreads);
+    EXPECT_GT(priv.memory(), sharded.memory());
+
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic, 7)
+    for (int i = 0; i < 100000; i++) {
+      int thread = 0;
+#ifdef _OPENMP
+      thread = omp_get_thread_num();
+#endif
+      priv.score(thread, static_cast<size_t>(i) % nbins, 1.);
+      sharded.score(thread, static_cast<size_t>(i) % nbins, 1.);
+    }
+
+    priv.end_batch(1.);
+    sharded.end_batch(1.);
+    for (size_t b = 0; b < nbins; b++) {
+      EXPECT_EQ(priv.mean(b), 1000.);
+      EXPECT_EQ(sharded.mean(b), 1000.);
+    }
+
+    // The buffers are cleared for the next batch
+    priv.end_batch(1.);
+    EXPECT_EQ(priv.mean(0), 500.);
+  }
+
+  TEST(Tally, material_tally) {
+    // Pure absorber of 0.5 /cm, of radius 2 cm, with neutrons born at its
+    // center
+    const auto V = Surface::BoundaryType::Vacuum;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0., 0., 0., 2., V, 1);
+    auto absorber = std::make_shared<Material>(1);
+    absorber->add_nuclide(std::make_shared<Nuclide>(
+                              "absorber", 1., std::vector<double>{1.E-11, 20.},
+                              std::vector<double>{0., 0.},
+                              std::vector<double>{1., 1.},
+                              std::vector<double>{0., 0.}, 0.),
+                          0.5);
+    auto root = std::make_unique<GeoNode>(
+        std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1),
+        "sphere");
+    root->set_material(absorber);
+    Geometry geom(surfaces, std::move(root));
+
+    auto tally = std::make_shared<MaterialTally>(
+        "rates", geom.materials(),
+        std::vector<TallyScore>{TallyScore::Flux, TallyScore::Absorption,
+                                TallyScore::Fission});
+    EXPECT_THROW(MaterialTally("twice", {absorber.get(), absorber.get()},
+                               {TallyScore::Flux}),
+                 PMCException);
+
+    const size_t n = 5000;
+    TransportSettings settings;
+    settings.threads = 2;
+    settings.tallies.push_back(tally);
+    TransportResult total;
+    for (uint64_t batch = 0; batch < 10; batch++) {
+      RNG rng(5, batch);
+      std::vector<SourceSite> sites;
+      for (size_t i = 0; i < n; i++) {
+        sites.push_back({Position(0., 0., 0.),
+                         Direction(2. * rng() - 1., 2. * PI * rng()), 1., 1.});
+      }
+      settings.batch = batch;
+      TransportResult result = transport(geom, sites, settings);
+      total += result;
+      tally->end_batch(static_cast<double>(n));
+    }
+
+    const size_t flux = tally->bin(absorber.get(), 0);
+    const size_t absorption = tally->bin(absorber.get(), 1);
+    EXPECT_EQ(tally->batches(), 10u);
+    EXPECT_NEAR(tally->mean(flux), total.track_length / (10. * n), 1.E-12);
+    EXPECT_NEAR(tally->mean(absorption), 1. - std::exp(-1.),
+                4. * tally->std_error(absorption) + 1.E-3);
+    EXPECT_NEAR(tally->mean(absorption), 0.5 * tally->mean(flux), 1.E-12);
+    EXPECT_EQ(tally->mean(tally->bin(absorber.get(), 2)), 0.);
+    EXPECT_GT(tally->std_error(flux), 0.);
+
+    settings.tracking = Tracking::Delta;
+    std::vector<SourceSite> sites(1, {Position(0., 0., 0.), Direction(), 1., 1.});
+    EXPECT_THROW(transport(geom, sites, settings), PMCException);
+  }
+};
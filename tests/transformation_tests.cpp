@@ -121,4 +121,46 @@ namespace {
     EXPECT_NEAR(v[2], rv[2], 1.E-16);
   }
 
-}
\ No newline at end of file
+  TEST(Transformation, kinds) {
+    using Kind = Transformation::Kind;
+    Transformation t = Transformation::translation(1., -2., 0.5);
+    Transformation r = Transformation::rotation_z(1.) * t;
+    Transformation s = Transformation::scale_y(2.) * r;
+
+    EXPECT_EQ(Transformation().kind(), Kind::Identity);
+    EXPECT_EQ(t.kind(), Kind::Translation);
+    EXPECT_EQ(t.inverse().kind(), Kind::Translation);
+    EXPECT_EQ(r.kind(), Kind::RotationTranslation);
+    EXPECT_EQ(r.inverse().kind(), Kind::RotationTranslation);
+    EXPECT_EQ(s.kind(), Kind::General);
+
+    // Reading an element keeps the kind, writing one makes it General
+    Transformation g = t;
+    EXPECT_DOUBLE_EQ(g[1][3], -2.);
+    EXPECT_EQ(g.kind(), Kind::Translation);
+    g.set(1, 3, 4.);
+    EXPECT_DOUBLE_EQ(g[1][3], 4.);
+    EXPECT_EQ(g.kind(), Kind::General);
+
+    // Every kind gives the same result as the full multiplication
+    Vector v(0.3, -1.2, 2.);
+    Direction u(0.6, 0., 0.8);
+    for (const auto& T : {Transformation(), t, r, s}) {
+      Transformation full = T;
+      full.set(0, 0, full[0][0]);
+      Vector Tv = T * v;
+      Vector fv = full * v;
+      Direction Tu = T * u;
+      Direction fu = full * u;
+      Vector iv = T.inverse() * Tv;
+      Vector fiv = full.inverse() * fv;
+      for (size_t i = 0; i < 3; i++) {
+        EXPECT_NEAR(Tv[i], fv[i], 1.E-12);
+        EXPECT_NEAR(Tu[i], fu[i], 1.E-12);
+        EXPECT_NEAR(iv[i], fiv[i], 1.E-12);
+        EXPECT_NEAR(iv[i], v[i], 1.E-12);
+      }
+    }
+  }
+
+}
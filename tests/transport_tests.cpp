@@ -0,0 +1,375 @@
+#include <Papillon/geometry/rect_lattice.hpp>
+#include <Papillon/geometry/csg/difference.hpp>
+#include <Papillon/geometry/csg/half_space.hpp>
+#include <Papillon/geometry/csg/intersection.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
+#include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/yplane.hpp>
+#include <Papillon/geometry/surfaces/zcylinder.hpp>
+#include <Papillon/geometry/surfaces/zplane.hpp>
+#include <Papillon/transport/physics.hpp>
+#include <Papillon/transport/transport.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+
+namespace {
+  using namespace pmc;
+
+  // Nuclide with constant scattering, and 1/v capture and fission
+  std::shared_ptr<Nuclide> make_nuclide(const std::string& name, double awr,
+                                        double elastic, double capture,
+                                        double fission) {
+    std::vector<double> energy, el, cap, fis;
+    for (int i = 0; i <= 120; i++) {
+      double E = 1.E-11 * std::pow(10., 0.1 * i);
+      double v = std::sqrt(2.53E-8 / E);
+      energy.push_back(E);
+      el.push_back(elastic);
+      cap.push_back(capture * v);
+      fis.push_back(fission * v);
+    }
+    return std::make_shared<Nuclide>(name, awr, energy, el, cap, fis, 2.4);
+  }
+
+  // Box of 3x3 pins, reflective on its sides and vacuum on its ends
+  std::unique_ptr<Geometry> make_pin_lattice() {
+    const auto T = Surface::BoundaryType::Transparent;
+    const auto R = Surface::BoundaryType::Reflective;
+    const auto V = Surface::BoundaryType::Vacuum;
+    const auto N = Surface::Side::Negative;
+    const auto P = Surface::Side::Positive;
+    const double pitch = 1.26;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<ZCylinder>(0., 0., 0.4, T, 1);
+    surfaces[2] = std::make_shared<ZCylinder>(0., 0., 0.47, T, 2);
+    surfaces[3] = std::make_shared<XPlane>(-1.5*pitch, R, 3);
+    surfaces[4] = std::make_shared<XPlane>(1.5*pitch, R, 4);
+    surfaces[5] = std::make_shared<YPlane>(-1.5*pitch, R, 5);
+    surfaces[6] = std::make_shared<YPlane>(1.5*pitch, R, 6);
+    surfaces[7] = std::make_shared<ZPlane>(-10., V, 7);
+    surfaces[8] = std::make_shared<ZPlane>(10., V, 8);
+
+    auto fuel = std::make_shared<HalfSpace>(surfaces[1], N, 1);
+    auto clad = std::make_shared<Difference>(
+        std::make_shared<HalfSpace>(surfaces[2], N, 2), fuel, 3);
+    auto box = std::make_shared<Intersection>(
+        std::make_shared<Intersection>(
+            std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[3], P, 4),
+                                           std::make_shared<HalfSpace>(surfaces[4], N, 5), 6),
+            std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[5], P, 7),
+                                           std::make_shared<HalfSpace>(surfaces[6], N, 8), 9), 10),
+        std::make_shared<Intersection>(std::make_shared<HalfSpace>(surfaces[7], P, 11),
+                                       std::make_shared<HalfSpace>(surfaces[8], N, 12), 13), 14);
+
+    auto uo2 = std::make_shared<Material>(1, "fuel");
+    uo2->add_nuclide(make_nuclide("U235", 233., 10., 1., 6.), 0.0007);
+    uo2->add_nuclide(make_nuclide("U238", 236., 9., 0.3, 0.), 0.022);
+    uo2->add_nuclide(make_nuclide("O16", 15.86, 3.8, 0., 0.), 0.045);
+    auto zr = std::make_shared<Material>(2, "clad");
+    zr->add_nuclide(make_nuclide("Zr90", 89.1, 6.5, 0.01, 0.), 0.043);
+    auto water = std::make_shared<Material>(3, "water");
+    water->add_nuclide(make_nuclide("H1", 0.999, 20., 0.33, 0.), 0.067);
+    water->add_nuclide(make_nuclide("O16", 15.86, 3.8, 0., 0.), 0.033);
+
+    auto pin = std::make_shared<GeoNode>(box, "moderator");
+    pin->set_material(water);
+    pin->add_node(fuel, Transformation(), "fuel")->set_material(uo2);
+    pin->add_node(clad, Transformation(), "clad")->set_material(zr);
+    auto root = std::make_unique<RectLattice>(box, 3, 3, 1, pitch, pitch, INF,
+                                              Position(-1.5*pitch, -1.5*pitch, 0.), "core");
+    root->fill(pin);
+    return std::make_unique<Geometry>(surfaces, std::move(root));
+  }
+
+  // Isotropic 2 MeV neutrons, uniform in the box
+  std::vector<SourceSite> make_sites(size_t n) {
+    RNG rng(99);
+    std::vector<SourceSite> sites;
+    for (size_t i = 0; i < n; i++) {
+      Position r(3.78 * (rng() - 0.5), 3.78 * (rng() - 0.5), 20. * (rng() - 0.5));
+      Direction u(2. * rng() - 1., 2. * PI * rng());
+      sites.push_back({r, u, 2., 1.});
+    }
+    return sites;
+  }
+
+  TEST(Transport, rotate_direction) {
+    Direction u(0.3, -0.5, 0.8);
+    Direction v = rotate_direction(u, 0.25, 1.);
+    EXPECT_NEAR(u[0]*v[0] + u[1]*v[1] + u[2]*v[2], 0.25, 1.E-12);
+
+    // Along z, rotated about y instead
+    Direction z(0., 0., 1.);
+    Direction w = rotate_direction(z, -0.5, 3.);
+    EXPECT_NEAR(w[2], -0.5, 1.E-12);
+  }
+
+  TEST(Transport, elastic_scatter) {
+    auto h1 = make_nuclide("H1", 0.999, 20., 0., 0.);
+    auto o16 = make_nuclide("O16", 15.86, 3.8, 0., 0.);
+    Material mat(1);
+    mat.add_nuclide(o16, 1.);
+    RNG rng(3);
+    const double alpha = std::pow((15.86 - 1.) / (15.86 + 1.), 2.);
+    for (int i = 0; i < 1000; i++) {
+      double E = 1.;
+      Direction u(1., 0., 0.);
+      EXPECT_EQ(collide(mat, E, u, rng), CollisionType::Scatter);
+      EXPECT_LE(E, 1.);
+      EXPECT_GE(E, alpha * (1. - 1.E-12));
+    }
+  }
+
+  TEST(Transport, absorber_sphere) {
+    // Neutrons born at the center of a pure absorber of radius one mean free
+    // path escape with a probability of exp(-1)
+    const auto V = Surface::BoundaryType::Vacuum;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0., 0., 0., 2., V, 1);
+    auto sphere = std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1);
+    auto absorber = std::make_shared<Material>(1);
+    absorber->add_nuclide(std::make_shared<Nuclide>(
+                              "absorber", 1., std::vector<double>{1.E-11, 20.},
+                              std::vector<double>{0., 0.},
+                              std::vector<double>{1., 1.},
+                              std::vector<double>{0., 0.}, 0.),
+                          0.5);
+    auto root = std::make_unique<GeoNode>(sphere, "sphere");
+    root->set_material(absorber);
+    Geometry geom(surfaces, std::move(root));
+
+    const size_t n = 20000;
+    RNG rng(5);
+    std::vector<SourceSite> sites;
+    for (size_t i = 0; i < n; i++) {
+      sites.push_back({Position(0., 0., 0.), Direction(2. * rng() - 1., 2. * PI * rng()), 1., 1.});
+    }
+
+    TransportResult result = transport_histories(geom, sites, TransportSettings());
+    EXPECT_EQ(result.histories, n);
+    EXPECT_EQ(result.leaks + result.captures, n);
+    EXPECT_EQ(result.lost, 0u);
+    EXPECT_NEAR(static_cast<double>(result.leaks) / n, std::exp(-1.), 0.015);
+    EXPECT_NEAR(result.track_length / n, 2. * (1. - std::exp(-1.)), 0.03);
+  }
+
+  TEST(Transport, modes_agree) {
+    auto geom = make_pin_lattice();
+    std::vector<SourceSite> sites = make_sites(1000);
+
+    TransportSettings settings;
+    settings.seed = 17;
+    TransportResult history = transport(*geom, sites, settings);
+
+    // Several banks, the last of them only partly filled
+    settings.mode = TransportMode::Event;
+    settings.event_bank_size = 300;
+    TransportResult event = transport(*geom, sites, settings);
+
+    EXPECT_EQ(history.histories, 1000u);
+    EXPECT_EQ(history.lost, 0u);
+    EXPECT_GT(history.reflections, 0u);
+    EXPECT_GT(history.crossings, 0u);
+    EXPECT_GT(history.leaks, 0u);
+    EXPECT_GT(history.captures, 0u);
+    EXPECT_GT(history.fissions, 0u);
+    EXPECT_EQ(history.histories, history.leaks + history.captures +
+                                     history.fissions + history.cutoffs);
+
+    EXPECT_EQ(event.histories, history.histories);
+    EXPECT_EQ(event.collisions, history.collisions);
+    EXPECT_EQ(event.crossings, history.crossings);
+    EXPECT_EQ(event.reflections, history.reflections);
+    EXPECT_EQ(event.leaks, history.leaks);
+    EXPECT_EQ(event.captures, history.captures);
+    EXPECT_EQ(event.fissions, history.fissions);
+    EXPECT_EQ(event.cutoffs, history.cutoffs);
+    EXPECT_EQ(event.lost, history.lost);
+    EXPECT_EQ(event.track_length, history.track_length);
+
+    // Another seed gives other histories
+    settings.seed = 18;
+    TransportResult other = transport(*geom, sites, settings);
+    EXPECT_NE(other.collisions, history.collisions);
+
+    settings.event_bank_size = 0;
+    EXPECT_THROW(transport(*geom, sites, settings), PMCException);
+    settings.event_bank_size = 300;
+    settings.tracking = Tracking::Delta;
+    EXPECT_THROW(transport(*geom, sites, settings), PMCException);
+  }
+
+  // Pure absorbers of 2 /cm inside of r = 1, and of 0.5 /cm out to r = 2,
+  // with neutrons born at the center
+  std::unique_ptr<Geometry> make_absorber_spheres() {
+    const auto T = Surface::BoundaryType::Transparent;
+    const auto V = Surface::BoundaryType::Vacuum;
+    std::unordered_map<uint32_t, std::shared_ptr<Surface>> surfaces;
+    surfaces[1] = std::make_shared<Sphere>(0., 0., 0., 1., T, 1);
+    surfaces[2] = std::make_shared<Sphere>(0., 0., 0., 2., V, 2);
+    auto absorber = std::make_shared<Nuclide>(
+        "absorber", 1., std::vector<double>{1.E-11, 20.},
+        std::vector<double>{0., 0.}, std::vector<double>{1., 1.},
+        std::vector<double>{0., 0.}, 0.);
+    auto strong = std::make_shared<Material>(1);
+    strong->add_nuclide(absorber, 2.);
+    auto weak = std::make_shared<Material>(2);
+    weak->add_nuclide(absorber, 0.5);
+
+    auto root = std::make_unique<GeoNode>(
+        std::make_shared<HalfSpace>(surfaces[2], Surface::Side::Negative, 2),
+        "outer");
+    root->set_material(weak);
+    root->add_node(std::make_shared<HalfSpace>(surfaces[1], Surface::Side::Negative, 1),
+                   Transformation(), "inner")->set_material(strong);
+    return std::make_unique<Geometry>(surfaces, std::move(root));
+  }
+
+  TEST(Transport, delta_tracking) {
+    auto geom = make_absorber_spheres();
+    const size_t n = 20000;
+    RNG rng(5);
+    std::vector<SourceSite> sites;
+    for (size_t i = 0; i < n; i++) {
+      sites.push_back({Position(0., 0., 0.), Direction(2. * rng() - 1., 2. * PI * rng()), 1., 1.});
+    }
+    const double escape = std::exp(-2.5);
+    const double track = 0.5 * (1. - std::exp(-2.)) +
+                         std::exp(-2.) * (1. - std::exp(-0.5)) / 0.5;
+
+    TransportSettings settings;
+    settings.tracking = Tracking::Delta;
+    TransportResult delta = transport(*geom, sites, settings);
+    EXPECT_EQ(delta.histories, n);
+    EXPECT_EQ(delta.leaks + delta.captures, n);
+    EXPECT_EQ(delta.lost, 0u);
+    EXPECT_EQ(delta.crossings, 0u);
+    EXPECT_GT(delta.virtual_collisions, 0u);
+    EXPECT_NEAR(static_cast<double>(delta.leaks) / n, escape, 0.006);
+    EXPECT_NEAR(delta.track_length / n, track, 0.01);
+
+    // The outer sphere is a quarter of the majorant, so raising the
+    // threshold above that sends its flights back to surface tracking
+    settings.delta_threshold = 0.5;
+    TransportResult mixed = transport(*geom, sites, settings);
+    EXPECT_EQ(mixed.leaks + mixed.captures, n);
+    EXPECT_EQ(mixed.lost, 0u);
+    EXPECT_LT(mixed.virtual_collisions, delta.virtual_collisions);
+    EXPECT_NEAR(static_cast<double>(mixed.leaks) / n, escape, 0.006);
+    EXPECT_NEAR(mixed.track_length / n, track, 0.01);
+  }
+
+  TEST(Transport, delta_tracking_reflective) {
+    auto geom = make_pin_lattice();
+    std::vector<SourceSite> sites = make_sites(2000);
+
+    TransportSettings settings;
+    TransportResult surface = transport(*geom, sites, settings);
+    settings.tracking = Tracking::Delta;
+    settings.majorant = std::make_shared<Majorant>(geom->materials());
+    TransportResult delta = transport(*geom, sites, settings);
+
+    EXPECT_EQ(delta.lost, 0u);
+    EXPECT_GT(delta.reflections, 0u);
+    EXPECT_EQ(delta.histories, delta.leaks + delta.captures +
+                                   delta.fissions + delta.cutoffs);
+    double n = static_cast<double>(sites.size());
+    EXPECT_NEAR(delta.collisions / n, surface.collisions / n,
+                0.08 * surface.collisions / n);
+    EXPECT_NEAR(delta.track_length / n, surface.track_length / n,
+                0.08 * surface.track_length / n);
+    EXPECT_NEAR(delta.fissions / n, surface.fissions / n, 0.05);
+  }
+
+  TEST(Transport, fission_spectrum) {
+    RNG rng(8);
+    const double a = 0.988, b = 2.249;
+    const int n = 200000;
+    double mean = 0.;
+    for (int i = 0; i < n; i++) {
+      double E = sample_fission_energy(rng);
+      EXPECT_GE(E, 0.);
+      mean += E / n;
+    }
+    EXPECT_NEAR(mean, 1.5 * a + 0.25 * a * a * b, 0.01);
+  }
+
+  bool same_sites(const std::vector<SourceSite>& a,
+                  const std::vector<SourceSite>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+      if (a[i].r.x() != b[i].r.x() || a[i].r.y() != b[i].r.y() ||
+          a[i].r.z() != b[i].r.z() || a[i].u.x() != b[i].u.x() ||
+          a[i].energy != b[i].energy || a[i].weight != b[i].weight)
+        return false;
+    }
+    return true;
+  }
+
+  TEST(Transport, threads_agree) {
+    auto geom = make_pin_lattice();
+    std::vector<SourceSite> sites = make_sites(1000);
+
+    TransportSettings settings;
+    settings.seed = 23;
+    settings.fission_neutrons = FissionNeutrons::Bank;
+    settings.threads = 1;
+    std::vector<SourceSite> serial_bank;
+    TransportResult serial = transport(*geom, sites, settings, serial_bank);
+    EXPECT_GT(serial.fissions, 0u);
+    EXPECT_GT(serial_bank.size(), serial.fissions);
+    EXPECT_EQ(serial.secondaries, 0u);
+
+    // Chunks which do not divide the number of histories, handed to more
+    // threads than there are cores
+    settings.threads = 4;
+    settings.chunk_size = 7;
+    std::vector<SourceSite> bank;
+    TransportResult threaded = transport(*geom, sites, settings, bank);
+    EXPECT_EQ(threaded.collisions, serial.collisions);
+    EXPECT_EQ(threaded.crossings, serial.crossings);
+    EXPECT_EQ(threaded.leaks, serial.leaks);
+    EXPECT_EQ(threaded.fissions, serial.fissions);
+    EXPECT_EQ(threaded.track_length, serial.track_length);
+    EXPECT_TRUE(same_sites(bank, serial_bank));
+
+    settings.mode = TransportMode::Event;
+    settings.threads = 3;
+    settings.event_bank_size = 150;
+    TransportResult event = transport(*geom, sites, settings, bank);
+    EXPECT_EQ(event.collisions, serial.collisions);
+    EXPECT_EQ(event.track_length, serial.track_length);
+    EXPECT_TRUE(same_sites(bank, serial_bank));
+
+    settings.fission_neutrons = FissionNeutrons::Secondary;
+    EXPECT_THROW(transport(*geom, sites, settings, bank), PMCException);
+    settings.mode = TransportMode::History;
+    settings.chunk_size = 0;
+    EXPECT_THROW(transport(*geom, sites, settings, bank), PMCException);
+  }
+
+  TEST(Transport, fission_secondaries) {
+    auto geom = make_pin_lattice();
+    std::vector<SourceSite> sites = make_sites(500);
+
+    TransportSettings settings;
+    settings.fission_neutrons = FissionNeutrons::Secondary;
+    settings.threads = 1;
+    std::vector<SourceSite> bank;
+    TransportResult serial = transport(*geom, sites, settings, bank);
+    EXPECT_TRUE(bank.empty());
+    EXPECT_GT(serial.secondaries, 0u);
+    EXPECT_EQ(serial.histories + serial.secondaries,
+              serial.leaks + serial.captures + serial.fissions +
+                  serial.cutoffs + serial.lost);
+
+    settings.threads = 2;
+    settings.chunk_size = 3;
+    TransportResult threaded = transport(*geom, sites, settings);
+    EXPECT_EQ(threaded.secondaries, serial.secondaries);
+    EXPECT_EQ(threaded.collisions, serial.collisions);
+    EXPECT_EQ(threaded.track_length, serial.track_length);
+  }
+};
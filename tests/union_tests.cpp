@@ -1,6 +1,7 @@
 #include <Papillon/geometry/csg/union.hpp>
 #include <Papillon/geometry/csg/half_space.hpp>
 #include <Papillon/geometry/surfaces/xplane.hpp>
+#include <Papillon/geometry/surfaces/sphere.hpp>
 #include <gtest/gtest.h>
 
 namespace {
@@ -45,4 +46,29 @@ namespace {
     EXPECT_DOUBLE_EQ(bound2.distance, x0->distance(r2, u1));
     EXPECT_EQ(bound2.current_side, x0->sign(r2, u1));
   }
+
+  TEST(Union, get_ray) {
+    // Two overlapping spheres along x
+    std::shared_ptr<Surface> s1 = std::make_shared<Sphere>(0., 0., 0., 1., Surface::BoundaryType::Transparent, 1);
+    std::shared_ptr<Surface> s2 = std::make_shared<Sphere>(1.5, 0., 0., 1., Surface::BoundaryType::Transparent, 2);
+    std::shared_ptr<Volume> b1 = std::make_shared<HalfSpace>(s1, Surface::Side::Negative, 1);
+    std::shared_ptr<Volume> b2 = std::make_shared<HalfSpace>(s2, Surface::Side::Negative, 2);
+    Union u(b1, b2, 3);
+
+    // The nearest surface lies inside of the union, its boundary does not
+    Position r(0., 0., 0.);
+    Direction u1(1., 0., 0.);
+    EXPECT_DOUBLE_EQ(u.get_boundary(r, u1).distance, 0.5);
+    Ray ray = u.get_ray(r, u1);
+    ASSERT_EQ(ray.size(), 1u);
+    EXPECT_DOUBLE_EQ(ray.next_crossing().distance, 2.5);
+    EXPECT_EQ(ray.next_crossing().side, Surface::Side::Negative);
+
+    // Disjoint pieces stay apart
+    Ray back = u.get_ray({4., 0., 0.}, {-1., 0., 0.});
+    ASSERT_EQ(back.size(), 1u);
+    EXPECT_DOUBLE_EQ(back[0].enter.distance, 1.5);
+    EXPECT_DOUBLE_EQ(back[0].exit.distance, 5.);
+  }
+
 };
@@ -1,6 +1,7 @@
 #include <Papillon/geometry/surfaces/xcylinder.hpp>
 #include <Papillon/utils/constants.hpp>
 #include <gtest/gtest.h>
+#include "surface_batch_check.hpp"
 #include <cmath>
 
 namespace {
@@ -50,5 +51,13 @@ namespace {
     EXPECT_DOUBLE_EQ(-1.0, xc.normal(r2).z());
     EXPECT_DOUBLE_EQ(-1.0, xc.normal(r3).y());
   }
-  
+
+  TEST(XCylinder, distance_batch) {
+    // Rays along the axis, rays grazing the cylinder from the points
+    // {0,y0+R,z0-3} and {0,y0-R,z0+3}, and rays starting on the cylinder.
+    check_distance_batch(xc, {{0.,y0,z0}, {-4.,y0+R+1.,z0}, {0.,y0+R,z0-3.}, {0.,y0-R,z0+3.}},
+                         {{1.,0.,-1.}, {-1.,0.,1.}, {1.,1e-12,0.}},
+                         {{0.,y0+R,z0}, {5.,y0,z0-R}, {-1.,y0-R,z0}});
+  }
+
 }; 
@@ -1,6 +1,7 @@
 #include <Papillon/geometry/surfaces/xplane.hpp>
 #include <Papillon/utils/constants.hpp>
 #include <gtest/gtest.h>
+#include "surface_batch_check.hpp"
 
 namespace {
   using namespace pmc;
@@ -44,5 +45,12 @@ namespace {
     EXPECT_DOUBLE_EQ(0.0, xpn.y());
     EXPECT_DOUBLE_EQ(0.0, xpn.z());
   }
-  
+
+  TEST(XPlane, distance_batch) {
+    // Rays parallel to the plane, and nearly so, and rays starting on it.
+    check_distance_batch(tplane, {{2.,1.,1.}, {4.,-1.,0.}},
+                         {{0.,1.,1.}, {0.,-3.,1.}, {1e-12,1.,0.}},
+                         {{3.,1.,1.}, {3.,-2.,5.}});
+  }
+
 };
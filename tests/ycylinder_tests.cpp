@@ -1,6 +1,7 @@
 #include <Papillon/geometry/surfaces/ycylinder.hpp>
 #include <Papillon/utils/constants.hpp>
 #include <gtest/gtest.h>
+#include "surface_batch_check.hpp"
 
 namespace {
   using namespace pmc;
@@ -49,4 +50,13 @@ namespace {
     EXPECT_DOUBLE_EQ(-1.0, yc.normal(r2).x());
     EXPECT_DOUBLE_EQ(-1.0, yc.normal(r3).z());
   }
+
+  TEST(YCylinder, distance_batch) {
+    // Rays along the axis, rays grazing the cylinder from the points
+    // {x0+R,0,z0-3} and {x0-R,0,z0+3}, and rays starting on the cylinder.
+    check_distance_batch(yc, {{x0,0.,z0}, {x0+R+1.,-4.,z0}, {x0+R,0.,z0-3.}, {x0-R,0.,z0+3.}},
+                         {{0.,1.,-1.}, {0.,-1.,1.}, {1e-12,1.,0.}},
+                         {{x0+R,0.,z0}, {x0,5.,z0-R}, {x0-R,-1.,z0}});
+  }
+
 };
@@ -1,6 +1,7 @@
 #include <Papillon/geometry/surfaces/yplane.hpp>
 #include <Papillon/utils/constants.hpp>
 #include <gtest/gtest.h>
+#include "surface_batch_check.hpp"
 
 namespace {
   using namespace pmc;
@@ -44,5 +45,12 @@ namespace {
     EXPECT_DOUBLE_EQ(1.0, ypn.y());
     EXPECT_DOUBLE_EQ(0.0, ypn.z());
   }
-  
+
+  TEST(YPlane, distance_batch) {
+    // Rays parallel to the plane, and nearly so, and rays starting on it.
+    check_distance_batch(tplane, {{1.,3.,1.}, {-1.,5.,0.}},
+                         {{1.,0.,1.}, {-3.,0.,1.}, {1.,1e-12,0.}},
+                         {{1.,4.,1.}, {-2.,4.,5.}});
+  }
+
 };
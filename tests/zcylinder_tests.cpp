@@ -1,6 +1,7 @@
 #include <Papillon/geometry/surfaces/zcylinder.hpp>
 #include <Papillon/utils/constants.hpp>
 #include <gtest/gtest.h>
+#include "surface_batch_check.hpp"
 #include <cmath>
 
 namespace {
@@ -51,4 +52,12 @@ namespace {
     EXPECT_DOUBLE_EQ(-1.0, zc.normal(r4).y());
   }
 
+  TEST(ZCylinder, distance_batch) {
+    // Rays along the axis, rays grazing the cylinder from the points
+    // {x0+R,y0-3,0} and {x0-R,y0+3,0}, and rays starting on the cylinder.
+    check_distance_batch(zc, {{x0,y0,0.}, {x0+R+1.,y0,-4.}, {x0+R,y0-3.,0.}, {x0-R,y0+3.,0.}},
+                         {{0.,-1.,1.}, {0.,1.,-1.}, {1e-12,0.,1.}},
+                         {{x0+R,y0,0.}, {x0,y0-R,5.}, {x0-R,y0,-1.}});
+  }
+
 };
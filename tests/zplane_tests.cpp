@@ -1,6 +1,7 @@
 #include <Papillon/geometry/surfaces/zplane.hpp>
 #include <Papillon/utils/constants.hpp>
 #include <gtest/gtest.h>
+#include "surface_batch_check.hpp"
 
 namespace {
   using namespace pmc;
@@ -45,5 +46,12 @@ namespace {
     EXPECT_DOUBLE_EQ(0.0, zpn.y());
     EXPECT_DOUBLE_EQ(1.0, zpn.z());
   }
-  
+
+  TEST(ZPlane, distance_batch) {
+    // Rays parallel to the plane, and nearly so, and rays starting on it.
+    check_distance_batch(tplane, {{1.,1.,2.}, {-1.,0.,4.}},
+                         {{1.,1.,0.}, {-3.,1.,0.}, {0.,1.,1e-12}},
+                         {{1.,1.,3.}, {-2.,5.,3.}});
+  }
+
 };